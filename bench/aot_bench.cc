@@ -0,0 +1,78 @@
+//  
+// This file is part of MipTknzr Library Project
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.  
+// Licensed under the MIT License. 
+// See COPYING file in the project root for full license information.
+//
+
+
+
+/* -------------------------------------------------------------------------- */
+
+// Compare the scanner generated by miptknzr_gen for the C grammar (see 
+// c_grammar.h) with the runtime engine built from the same definitions:
+// token streams must be identical, then the throughput of both is 
+// measured on a given source file or on a synthetic C source
+
+
+/* -------------------------------------------------------------------------- */
+
+#include "c_grammar.h"
+#include "c_scanner.h"
+#include "bench_util.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+
+/* -------------------------------------------------------------------------- */
+
+int main(int argc, char* argv[])
+{
+    mip::string_t text;
+    int runs = 5;
+
+    if (argc > 1) {
+        if (!read_text(argv[1], text)) {
+            return 1;
+        }
+    }
+    else {
+        text = synth_c_source(8 << 20);
+    }
+
+    if (argc > 2) {
+        runs = std::max(1, std::atoi(argv[2]));
+    }
+
+    mip::tknzr_bldr_t bldr;
+
+    if (!def_c_grammar(bldr)) {
+        std::cerr << "Invalid grammar definition" << std::endl;
+        return 1;
+    }
+
+    auto engine = bldr.build_engine();
+    c_scanner_t scanner;
+
+    // token streams must be identical
+    if (!same_stream(*engine, scanner, text)) {
+        return 1;
+    }
+
+    size_t tokens = 0;
+    const double t_engine = bench(*engine, text, runs, tokens);
+    const double t_scanner = bench(scanner, text, runs, tokens);
+
+    std::cout << "input: " << text.size() * sizeof(mip::char_t) 
+              << " bytes, " << tokens << " tokens" << std::endl;
+
+    report("runtime engine", t_engine, text, tokens);
+    report("generated scanner", t_scanner, text, tokens);
+
+    std::cout << "speedup: " << t_engine / t_scanner << "x" << std::endl;
+
+    return 0;
+}
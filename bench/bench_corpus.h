@@ -0,0 +1,397 @@
+//  
+// This file is part of MipTknzr Library Project
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.  
+// Licensed under the MIT License. 
+// See COPYING file in the project root for full license information.
+//
+
+
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef __BENCH_CORPUS_H__
+#define __BENCH_CORPUS_H__
+
+
+/* -------------------------------------------------------------------------- */
+
+// Reproducible synthetic corpora and the grammars used to scan them: 
+// each generator is seeded with a fixed value, so a given size always 
+// yields the same text
+
+
+/* -------------------------------------------------------------------------- */
+
+#include "c_grammar.h"
+#include "bench_util.h"
+#include "mip_tknzr_bldr.h"
+
+#include <set>
+#include <vector>
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Linear congruential generator with a fixed seed
+class bench_rnd_t {
+public:
+    explicit bench_rnd_t(unsigned seed = 12345) noexcept : _seed(seed) {}
+
+    //! Return a number in [0, n)
+    unsigned operator()(unsigned n) noexcept {
+        _seed = _seed * 1103515245u + 12345u;
+        return (_seed >> 16) % n;
+    }
+
+private:
+    unsigned _seed;
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Return a JSON-like text of about a given size: an array of records 
+//! holding strings, numbers, literals and nested arrays
+inline mip::string_t synth_json(size_t size)
+{
+    static const mip::char_t * const keys[] = {
+        _T("id"), _T("name"), _T("email"), _T("active"), _T("score"),
+        _T("tags"), _T("created"), _T("parent"), _T("ratio"), _T("notes")
+    };
+
+    mip::_ostringstream os;
+    bench_rnd_t rnd;
+
+    os << _T("[\n");
+
+    for (size_t rec = 0; static_cast<size_t>(os.tellp()) < size; ++rec) {
+        os << (rec ? _T(",\n  {") : _T("  {"));
+
+        for (unsigned f = 0; f < 4 + rnd(6); ++f) {
+            os << (f ? _T(", ") : _T(" ")) << _T('"') << keys[rnd(10)] 
+               << _T("\": ");
+
+            switch (rnd(5)) {
+            case 0:
+                os << _T("\"user") << rnd(100000) << _T("@example.org\"");
+                break;
+            case 1:
+                os << rnd(1000000);
+                break;
+            case 2:
+                os << _T("-") << rnd(1000) << _T(".") << rnd(100000) 
+                   << _T("e") << rnd(10);
+                break;
+            case 3:
+                os << (rnd(3) == 0 ? _T("null") : 
+                       rnd(2) ? _T("true") : _T("false"));
+                break;
+            default:
+                os << _T("[");
+                for (unsigned i = 0, n = rnd(5); i < n; ++i) {
+                    os << (i ? _T(", \"t") : _T("\"t")) << rnd(50) << _T('"');
+                }
+                os << _T("]");
+                break;
+            }
+        }
+
+        os << _T(" }");
+    }
+
+    os << _T("\n]\n");
+
+    return os.str();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Return a text of about a given size made of log records
+inline mip::string_t synth_log(size_t size)
+{
+    static const mip::char_t * const levels[] = {
+        _T("DEBUG"), _T("INFO"), _T("INFO"), _T("INFO"), _T("WARN"), 
+        _T("ERROR")
+    };
+
+    static const mip::char_t * const paths[] = {
+        _T("/api/v1/items"), _T("/api/v1/users"), _T("/static/app.js"),
+        _T("/login"), _T("/api/v2/orders/search")
+    };
+
+    mip::_ostringstream os;
+    bench_rnd_t rnd;
+
+    for (size_t n = 0; static_cast<size_t>(os.tellp()) < size; ++n) {
+        const unsigned ms = static_cast<unsigned>(n * 37 % 86400000);
+
+        os << _T("2024-03-01 ") 
+           << ms / 3600000 << _T(":") << ms / 60000 % 60 << _T(":") 
+           << ms / 1000 % 60 << _T(".") << ms % 1000 
+           << _T(" [") << levels[rnd(6)] << _T("] worker-") << rnd(16) 
+           << _T(": request id=") << n << _T(" path=\"") << paths[rnd(5)] 
+           << _T("\" status=") << (rnd(10) ? 200 : 500) << _T(" took ") 
+           << rnd(500) << _T(".") << rnd(10) << _T("ms\n");
+    }
+
+    return os.str();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Return a C-like text of about a given size made of long single lines 
+//! (one expression statement of about 1 MB each)
+inline mip::string_t synth_long_lines(size_t size)
+{
+    static const mip::char_t * const ops[] = {
+        _T(" + "), _T(" - "), _T(" * "), _T(" << "), _T(" && "), _T(" | "), 
+        _T("->")
+    };
+
+    mip::_ostringstream os;
+    bench_rnd_t rnd;
+
+    while (static_cast<size_t>(os.tellp()) < size) {
+        const size_t line_end = static_cast<size_t>(os.tellp()) + (1 << 20);
+
+        os << _T("x = ");
+
+        while (static_cast<size_t>(os.tellp()) < line_end) {
+            switch (rnd(4)) {
+            case 0:
+                os << _T("value") << rnd(100);
+                break;
+            case 1:
+                os << _T("0x") << std::hex << rnd(65536) << std::dec;
+                break;
+            case 2:
+                os << _T("(s[") << rnd(64) << _T("])");
+                break;
+            default:
+                os << rnd(1000) << _T(".") << rnd(100);
+                break;
+            }
+
+            os << ops[rnd(7)];
+        }
+
+        os << _T("0;\n");
+    }
+
+    return os.str();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Return a C-like text of about a given size mostly made of comments
+inline mip::string_t synth_comments(size_t size)
+{
+    static const mip::char_t * const words[] = {
+        _T("the"), _T("buffer"), _T("is"), _T("released"), _T("when"),
+        _T("all"), _T("readers"), _T("have"), _T("completed"), _T("scan")
+    };
+
+    mip::_ostringstream os;
+    bench_rnd_t rnd;
+
+    for (size_t n = 0; static_cast<size_t>(os.tellp()) < size; ++n) {
+        os << _T("/*\n");
+
+        for (unsigned line = 0; line < 3 + rnd(10); ++line) {
+            os << _T(" *");
+
+            for (unsigned w = 0; w < 4 + rnd(10); ++w) {
+                os << _T(' ') << words[rnd(10)];
+            }
+
+            os << _T('\n');
+        }
+
+        os << _T(" */\n");
+
+        for (unsigned line = 0; line < rnd(4); ++line) {
+            os << _T("// ") << words[rnd(10)] << _T(' ') << words[rnd(10)] 
+               << _T(" (see note ") << n << _T(")\n");
+        }
+
+        os << _T("int item") << n << _T(" = ") << rnd(1000) 
+           << _T("; /* inline */\n");
+    }
+
+    return os.str();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Return a C-like text of about a given size mostly made of string 
+//! literals full of escape sequences
+inline mip::string_t synth_escapes(size_t size)
+{
+    static const mip::char_t * const escapes[] = {
+        _T("\\n"), _T("\\t"), _T("\\\""), _T("\\\\"), _T("\\x41"), 
+        _T("\\101"), _T("\\r"), _T("\\'")
+    };
+
+    mip::_ostringstream os;
+    bench_rnd_t rnd;
+
+    for (size_t n = 0; static_cast<size_t>(os.tellp()) < size; ++n) {
+        os << _T("msg[") << n << _T("] = \"");
+
+        for (unsigned i = 0; i < 8 + rnd(24); ++i) {
+            if (rnd(2)) {
+                os << escapes[rnd(8)];
+            }
+            else {
+                os << _T("text");
+            }
+        }
+
+        os << _T("\";\n");
+
+        if (rnd(4) == 0) {
+            os << _T("sep = '") << escapes[rnd(8)] << _T("';\n");
+        }
+    }
+
+    return os.str();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Return a dictionary of distinct atoms made of punctuation characters 
+//! (1 to 6 characters each)
+inline const std::vector<mip::string_t> & dict_atoms()
+{
+    static std::vector<mip::string_t> atoms;
+
+    if (atoms.empty()) {
+        static const mip::char_t punct[] = _T("+-*/<>=!&|^~%@$?:#");
+
+        const unsigned n = sizeof(punct) / sizeof(punct[0]) - 1;
+        std::set<mip::string_t> seen;
+        bench_rnd_t rnd(4242);
+
+        while (atoms.size() < 4096) {
+            mip::string_t atom;
+
+            for (unsigned i = 0, len = 1 + rnd(6); i < len; ++i) {
+                atom += punct[rnd(n)];
+            }
+
+            if (seen.insert(atom).second) {
+                atoms.push_back(atom);
+            }
+        }
+    }
+
+    return atoms;
+}
+
+
+//! Return a text of about a given size made of atoms of the dictionary
+//! (see dict_atoms()), mostly adjacent to each other
+inline mip::string_t synth_dict(size_t size)
+{
+    const auto & atoms = dict_atoms();
+    const auto n = static_cast<unsigned>(atoms.size());
+
+    mip::_ostringstream os;
+    bench_rnd_t rnd;
+
+    for (size_t i = 0; static_cast<size_t>(os.tellp()) < size; ++i) {
+        os << atoms[rnd(n)];
+
+        if (rnd(4) == 0) {
+            os << (i % 16 ? _T(' ') : _T('\n'));
+        }
+    }
+
+    os << _T('\n');
+
+    return os.str();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Define the grammar of JSON-like data
+inline bool def_json_grammar(mip::tknzr_bldr_t & bldr)
+{
+    bool ok = bldr.def_atom({ 
+        _T("{"), _T("}"), _T("["), _T("]"), _T(":"), _T(","), _T("-") 
+    });
+
+    ok = bldr.def_keyword({ _T("true"), _T("false"), _T("null") }) && ok;
+
+    ok = bldr.def_number({
+        mip::base_tknzr_t::num_t::DEC, 
+        mip::base_tknzr_t::num_t::FLOAT 
+    }) && ok;
+
+    ok = bldr.def_blank({ _T(" "), _T("\t"), _T("\r") }) && ok;
+    ok = bldr.def_blank_run() && ok;
+    ok = bldr.def_eol(mip::base_tknzr_t::eol_t::LF) && ok;
+
+    ok = bldr.def_string(_T('"'), 
+        std::make_shared<mip::esc_cnvrtr_t>(_T('\\'))) && ok;
+
+    return ok;
+}
+
+
+//! Define the grammar of log records
+inline bool def_log_grammar(mip::tknzr_bldr_t & bldr)
+{
+    bool ok = bldr.def_atom({ 
+        _T("["), _T("]"), _T(":"), _T("="), _T("-"), _T("/") 
+    });
+
+    ok = bldr.def_keyword({ 
+        _T("DEBUG"), _T("INFO"), _T("WARN"), _T("ERROR") 
+    }) && ok;
+
+    ok = bldr.def_pattern(_T("[A-Za-z_]\\w*")) && ok;
+
+    ok = bldr.def_number({
+        mip::base_tknzr_t::num_t::DEC, 
+        mip::base_tknzr_t::num_t::FLOAT 
+    }) && ok;
+
+    ok = bldr.def_blank(_T(" ")) && ok;
+    ok = bldr.def_blank(_T("\t")) && ok;
+    ok = bldr.def_eol(mip::base_tknzr_t::eol_t::LF) && ok;
+    ok = bldr.def_eol(mip::base_tknzr_t::eol_t::CR) && ok;
+
+    ok = bldr.def_string(_T('"')) && ok;
+
+    return ok;
+}
+
+
+//! Define the grammar of texts made of the atoms of a large dictionary 
+//! (see dict_atoms())
+inline bool def_dict_grammar(mip::tknzr_bldr_t & bldr)
+{
+    bool ok = true;
+
+    for (const auto & atom : dict_atoms()) {
+        ok = bldr.def_atom(atom) && ok;
+    }
+
+    ok = bldr.def_blank(_T(" ")) && ok;
+    ok = bldr.def_eol(mip::base_tknzr_t::eol_t::LF) && ok;
+
+    return ok;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+#endif // __BENCH_CORPUS_H__
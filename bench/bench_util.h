@@ -0,0 +1,229 @@
+//  
+// This file is part of MipTknzr Library Project
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.  
+// Licensed under the MIT License. 
+// See COPYING file in the project root for full license information.
+//
+
+
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef __BENCH_UTIL_H__
+#define __BENCH_UTIL_H__
+
+
+/* -------------------------------------------------------------------------- */
+
+// Helpers shared by benchmarks comparing alternative scanners
+
+
+/* -------------------------------------------------------------------------- */
+
+#include "mip_tkn_view.h"
+#include "mip_token.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Return a C source of about a given size
+inline mip::string_t synth_c_source(size_t size)
+{
+    static const mip::char_t * const names[] = {
+        _T("count"), _T("buffer"), _T("index"), _T("node"), _T("value"),
+        _T("size"), _T("result"), _T("ptr"), _T("next"), _T("flags")
+    };
+
+    mip::_ostringstream os;
+    unsigned seed = 12345;
+
+    auto rnd = [&seed](unsigned n) {
+        seed = seed * 1103515245u + 12345u;
+        return (seed >> 16) % n;
+    };
+
+    for (size_t fn = 0; static_cast<size_t>(os.tellp()) < size; ++fn) {
+        os << _T("/*\n * Function ") << fn 
+           << _T(": computes a value\n */\n")
+           << _T("static int func_") << fn 
+           << _T("(const char * s, unsigned long n)\n{\n");
+
+        for (unsigned stmt = 0; stmt < 8 + rnd(8); ++stmt) {
+            const auto name = names[rnd(10)];
+
+            switch (rnd(6)) {
+            case 0:
+                os << _T("    int ") << name << stmt << _T(" = 0x") 
+                   << std::hex << rnd(65536) << std::dec << _T(";\n");
+                break;
+            case 1:
+                os << _T("    if (") << name << _T(" >= ") << rnd(1000) 
+                   << _T(" && n != 0) {\n        ") << name 
+                   << _T(" += n << 2; // shift\n    }\n");
+                break;
+            case 2:
+                os << _T("    printf(\"") << name 
+                   << _T(" = %d\\n\", ") << name << _T(");\n");
+                break;
+            case 3:
+                os << _T("    double d") << stmt << _T(" = ") << rnd(100) 
+                   << _T(".") << rnd(1000) << _T("e-3 * s[") << rnd(64) 
+                   << _T("];\n");
+                break;
+            case 4:
+                os << _T("    for (") << name << _T(" = 0; ") << name 
+                   << _T(" < n; ++") << name << _T(") {\n        s[") 
+                   << name << _T("] = '\\t';\n    }\n");
+                break;
+            default:
+                os << _T("    return ") << name << _T("->next ? 0") 
+                   << rnd(8) << _T(" : -1;\n");
+                break;
+            }
+        }
+
+        os << _T("}\n\n");
+    }
+
+    return os.str();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Return true if two tokens are the same
+inline bool same_tkn(const mip::tkn_view_t & a, const mip::tkn_view_t & b)
+{
+    return a.type == b.type && 
+        mip::string_t(a.data, a.size) == mip::string_t(b.data, b.size) &&
+        a.line == b.line && a.offset == b.offset && 
+        a.pos == b.pos && a.end == b.end && 
+        a.quote == b.quote && a.esc == b.esc && 
+        a.id == b.id && a.index == b.index &&
+        a.num.floating == b.num.floating && 
+        a.num.overflow == b.num.overflow &&
+        a.num.integer == b.num.integer && 
+        (a.num.real == b.num.real || (a.num.real != a.num.real));
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Return the best time (in seconds) of several scans of a text, and 
+//! the number of tokens found
+template <class Scanner>
+inline double bench(
+    Scanner & scanner, 
+    const mip::string_t & text, 
+    int runs, 
+    size_t & tokens)
+{
+    double best = 0;
+
+    for (int i = 0; i < runs; ++i) {
+        mip::_istringstream is(text);
+        size_t cnt = 0;
+
+        scanner.reset();
+
+        const auto begin = std::chrono::steady_clock::now();
+
+        scanner.tokenize(is, [&cnt](const mip::tkn_view_t &) { 
+            ++cnt; 
+        });
+
+        const std::chrono::duration<double> t = 
+            std::chrono::steady_clock::now() - begin;
+
+        if (i == 0 || t.count() < best) {
+            best = t.count();
+        }
+
+        tokens = cnt;
+    }
+
+    return best;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Return true if two scanners yield the same token stream for a text, 
+//! reporting the first difference otherwise
+template <class ScannerA, class ScannerB>
+inline bool same_stream(
+    ScannerA & scanner_a, 
+    ScannerB & scanner_b, 
+    const mip::string_t & text)
+{
+    mip::_istringstream is_a(text);
+    mip::_istringstream is_b(text);
+    mip::tkn_view_t a, b;
+
+    scanner_a.reset();
+    scanner_b.reset();
+
+    do {
+        const bool ok_a = scanner_a.scan(is_a, a);
+        const bool ok_b = scanner_b.scan(is_b, b);
+
+        if (ok_a != ok_b || (ok_a && !same_tkn(a, b))) {
+            std::cerr << "Token streams differ at token " << a.index 
+                      << " (line " << a.line + 1 << ")" << std::endl;
+            return false;
+        }
+
+        if (!ok_a) {
+            break;
+        }
+    } 
+    while (a.type != mip::token_t::tcl_t::END_OF_FILE);
+
+    return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Read a whole file into a text
+inline bool read_text(const char * path, mip::string_t & text)
+{
+    mip::_ifstream is(path, std::ios::binary);
+
+    if (!is) {
+        std::cerr << path << ": cannot open the file" << std::endl;
+        return false;
+    }
+
+    mip::_ostringstream os;
+    os << is.rdbuf();
+    text = os.str();
+
+    return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Print the throughput of a scanner
+inline void report(
+    const char * name, 
+    double t, 
+    const mip::string_t & text, 
+    size_t tokens)
+{
+    std::cout << name << ": " << t * 1e3 << " ms, " 
+              << text.size() * sizeof(mip::char_t) / t / 1e6 << " MB/s, " 
+              << tokens / t / 1e6 << " Mtokens/s" << std::endl;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+#endif // __BENCH_UTIL_H__
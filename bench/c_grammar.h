@@ -0,0 +1,76 @@
+//  
+// This file is part of MipTknzr Library Project
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.  
+// Licensed under the MIT License. 
+// See COPYING file in the project root for full license information.
+//
+
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef __C_GRAMMAR_H__
+#define __C_GRAMMAR_H__
+
+
+/* -------------------------------------------------------------------------- */
+
+#include "mip_tknzr_bldr.h"
+#include "mip_esc_cnvrtr.h"
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Define the grammar of C sources used by benchmarks
+inline bool def_c_grammar(mip::tknzr_bldr_t & bldr)
+{
+    bool ok = bldr.def_atom({
+        _T("("), _T(")"), _T("["), _T("]"), _T("{"), _T("}"), 
+        _T(";"), _T(","), _T("."), _T("->"), _T("?"), _T(":"), 
+        _T("+"), _T("-"), _T("*"), _T("/"), _T("%"), _T("++"), _T("--"), 
+        _T("="), _T("+="), _T("-="), _T("*="), _T("/="), _T("%="), 
+        _T("=="), _T("!="), _T("<"), _T(">"), _T("<="), _T(">="), 
+        _T("&&"), _T("||"), _T("!"), _T("&"), _T("|"), _T("^"), _T("~"), 
+        _T("<<"), _T(">>"), _T("<<="), _T(">>="), _T("&="), _T("|="), 
+        _T("^="), _T("#"), _T("...") 
+    });
+
+    ok = bldr.def_keyword({
+        _T("auto"), _T("break"), _T("case"), _T("char"), _T("const"), 
+        _T("continue"), _T("default"), _T("do"), _T("double"), _T("else"), 
+        _T("enum"), _T("extern"), _T("float"), _T("for"), _T("goto"), 
+        _T("if"), _T("inline"), _T("int"), _T("long"), _T("register"), 
+        _T("return"), _T("short"), _T("signed"), _T("sizeof"), 
+        _T("static"), _T("struct"), _T("switch"), _T("typedef"), 
+        _T("union"), _T("unsigned"), _T("void"), _T("volatile"), 
+        _T("while") 
+    }) && ok;
+
+    ok = bldr.def_pattern(_T("[A-Za-z_]\\w*")) && ok;
+
+    ok = bldr.def_number({
+        mip::base_tknzr_t::num_t::DEC, 
+        mip::base_tknzr_t::num_t::HEX,
+        mip::base_tknzr_t::num_t::OCT,
+        mip::base_tknzr_t::num_t::FLOAT 
+    }) && ok;
+
+    ok = bldr.def_blank({ _T(" "), _T("\t"), _T("\r") }) && ok;
+    ok = bldr.def_blank_run() && ok;
+    ok = bldr.def_eol(mip::base_tknzr_t::eol_t::LF) && ok;
+
+    ok = bldr.def_sl_comment(_T("//")) && ok;
+    ok = bldr.def_ml_comment(_T("/*"), _T("*/")) && ok;
+
+    ok = bldr.def_string(_T('"'), 
+        std::make_shared<mip::esc_cnvrtr_t>(_T('\\'))) && ok;
+    ok = bldr.def_string(_T('\''), 
+        std::make_shared<mip::esc_cnvrtr_t>(_T('\\'))) && ok;
+
+    return ok;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+#endif // __C_GRAMMAR_H__
@@ -0,0 +1,47 @@
+//  
+// This file is part of MipTknzr Library Project
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.  
+// Licensed under the MIT License. 
+// See COPYING file in the project root for full license information.
+//
+
+
+
+/* -------------------------------------------------------------------------- */
+
+// Save the grammar of C sources (see c_grammar.h) into a file
+
+
+/* -------------------------------------------------------------------------- */
+
+#include "c_grammar.h"
+
+#include <iostream>
+
+
+/* -------------------------------------------------------------------------- */
+
+int main(int argc, char* argv[])
+{
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " <grammar file>" << std::endl;
+        return 1;
+    }
+
+    mip::tknzr_bldr_t bldr;
+
+    if (!def_c_grammar(bldr)) {
+        std::cerr << "Invalid grammar definition" << std::endl;
+        return 1;
+    }
+
+    auto tknzr = bldr.build_engine();
+
+    if (!tknzr || !tknzr->save_grammar(std::string(argv[1]))) {
+        std::cerr << argv[1] << ": cannot save the grammar" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,103 @@
+//  
+// This file is part of MipTknzr Library Project
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.  
+// Licensed under the MIT License. 
+// See COPYING file in the project root for full license information.
+//
+
+
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef __C_STATIC_GRAMMAR_H__
+#define __C_STATIC_GRAMMAR_H__
+
+
+/* -------------------------------------------------------------------------- */
+
+#include "mip_static_grammar.h"
+
+
+/* -------------------------------------------------------------------------- */
+
+// The C grammar of c_grammar.h declared at compile time, but for the 
+// identifier pattern (static grammars have no patterns, so identifiers 
+// are other tokens)
+
+namespace c_static {
+
+constexpr mip::char_t lpar[] = _T("("), rpar[] = _T(")"), lbrk[] = _T("["), 
+    rbrk[] = _T("]"), lbrc[] = _T("{"), rbrc[] = _T("}"), semi[] = _T(";"), 
+    comma[] = _T(","), dot[] = _T("."), arrow[] = _T("->"), 
+    qmark[] = _T("?"), colon[] = _T(":"), plus[] = _T("+"), 
+    minus[] = _T("-"), star[] = _T("*"), slash[] = _T("/"), 
+    perc[] = _T("%"), incr[] = _T("++"), decr[] = _T("--"), 
+    assign[] = _T("="), plus_eq[] = _T("+="), minus_eq[] = _T("-="), 
+    star_eq[] = _T("*="), slash_eq[] = _T("/="), perc_eq[] = _T("%="), 
+    eq[] = _T("=="), ne[] = _T("!="), lt[] = _T("<"), gt[] = _T(">"), 
+    le[] = _T("<="), ge[] = _T(">="), land[] = _T("&&"), lor[] = _T("||"), 
+    lnot[] = _T("!"), band[] = _T("&"), bor[] = _T("|"), bxor[] = _T("^"), 
+    bnot[] = _T("~"), shl[] = _T("<<"), shr[] = _T(">>"), 
+    shl_eq[] = _T("<<="), shr_eq[] = _T(">>="), and_eq_[] = _T("&="), 
+    or_eq_[] = _T("|="), xor_eq_[] = _T("^="), hash[] = _T("#"), 
+    ellipsis[] = _T("...");
+
+constexpr mip::char_t kw_auto[] = _T("auto"), kw_break[] = _T("break"), 
+    kw_case[] = _T("case"), kw_char[] = _T("char"), 
+    kw_const[] = _T("const"), kw_continue[] = _T("continue"), 
+    kw_default[] = _T("default"), kw_do[] = _T("do"), 
+    kw_double[] = _T("double"), kw_else[] = _T("else"), 
+    kw_enum[] = _T("enum"), kw_extern[] = _T("extern"), 
+    kw_float[] = _T("float"), kw_for[] = _T("for"), 
+    kw_goto[] = _T("goto"), kw_if[] = _T("if"), 
+    kw_inline[] = _T("inline"), kw_int[] = _T("int"), 
+    kw_long[] = _T("long"), kw_register[] = _T("register"), 
+    kw_return[] = _T("return"), kw_short[] = _T("short"), 
+    kw_signed[] = _T("signed"), kw_sizeof[] = _T("sizeof"), 
+    kw_static[] = _T("static"), kw_struct[] = _T("struct"), 
+    kw_switch[] = _T("switch"), kw_typedef[] = _T("typedef"), 
+    kw_union[] = _T("union"), kw_unsigned[] = _T("unsigned"), 
+    kw_void[] = _T("void"), kw_volatile[] = _T("volatile"), 
+    kw_while[] = _T("while");
+
+constexpr mip::char_t space[] = _T(" "), tab[] = _T("\t"), cr[] = _T("\r");
+constexpr mip::char_t slash2[] = _T("//"), com_begin[] = _T("/*"), 
+    com_end[] = _T("*/");
+
+using grammar_t = mip::static_grammar_t<
+    mip::atoms_t<lpar, rpar, lbrk, rbrk, lbrc, rbrc, semi, comma, dot, 
+        arrow, qmark, colon, plus, minus, star, slash, perc, incr, decr, 
+        assign, plus_eq, minus_eq, star_eq, slash_eq, perc_eq, eq, ne, lt, 
+        gt, le, ge, land, lor, lnot, band, bor, bxor, bnot, shl, shr, 
+        shl_eq, shr_eq, and_eq_, or_eq_, xor_eq_, hash, ellipsis>,
+    mip::keywords_t<kw_auto, kw_break, kw_case, kw_char, kw_const, 
+        kw_continue, kw_default, kw_do, kw_double, kw_else, kw_enum, 
+        kw_extern, kw_float, kw_for, kw_goto, kw_if, kw_inline, kw_int, 
+        kw_long, kw_register, kw_return, kw_short, kw_signed, kw_sizeof, 
+        kw_static, kw_struct, kw_switch, kw_typedef, kw_union, kw_unsigned, 
+        kw_void, kw_volatile, kw_while>,
+    mip::numbers_t<
+        mip::base_tknzr_t::num_t::DEC, mip::base_tknzr_t::num_t::HEX, 
+        mip::base_tknzr_t::num_t::OCT, mip::base_tknzr_t::num_t::FLOAT>,
+    mip::blanks_t<space, tab, cr>,
+    mip::blank_run_t,
+    mip::eols_t<mip::base_tknzr_t::eol_t::LF>,
+    mip::sl_comments_t<slash2>,
+    mip::ml_comments_t<mip::ml_comment_t<com_begin, com_end>>,
+    mip::strings_t<
+        mip::quote_t<_T('"'), _T('\\')>, 
+        mip::quote_t<_T('\''), _T('\\')>>>;
+
+} // namespace c_static
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Static C grammar used by benchmarks
+using c_static_grammar_t = c_static::grammar_t;
+
+
+/* -------------------------------------------------------------------------- */
+
+#endif // __C_STATIC_GRAMMAR_H__
@@ -0,0 +1,943 @@
+//  
+// This file is part of MipTknzr Library Project
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.  
+// Licensed under the MIT License. 
+// See COPYING file in the project root for full license information.
+//
+
+
+
+
+/* -------------------------------------------------------------------------- */
+
+// Benchmark suite: scan synthetic corpora (and optionally real files) 
+// with several engines, measuring throughput, allocations per token, 
+// peak resident set size and, where perf_event_open() is available, 
+// hardware counters per token and per byte (cycles, instructions, branch 
+// misses, L1 and last level cache misses), and print the results as JSON 
+// or CSV so that runs can be compared
+//
+// usage: miptknzr_bench [options]
+//   --corpus a,b,...   corpora to scan (default: all synthetic ones)
+//   --engine a,b,...   engines to run (default: all of them)
+//   --file path        scan a file too (may be repeated)
+//   --grammar name     grammar of the files (default: c)
+//   --size n           characters of synthetic corpora (default: 4 Mi)
+//   --runs n           runs per measure, the best one counts (default: 3)
+//   --format json|csv  output format (default: json)
+//   --list             list corpora, grammars and engines
+
+
+/* -------------------------------------------------------------------------- */
+
+#include "bench_corpus.h"
+#include "c_static_grammar.h"
+#include "perf_counters.h"
+#include "mip_tknlst_bldr.h"
+#include "mip_tkn_cache.h"
+
+#ifdef MIPTKNZR_BENCH_GENERATED
+#include "c_scanner.h"
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+
+/* -------------------------------------------------------------------------- */
+
+// Every allocation made by the process is counted
+
+namespace {
+size_t alloc_count = 0;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+namespace {
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Sum of the sizes of token values scanned by a run: it is reported, 
+//! so that decoding of tokens cannot be optimized away, and it matches 
+//! between engines using the same grammar
+size_t tkn_checksum = 0;
+
+void count_tkn(const mip::tkn_view_t & tkn, size_t & cnt)
+{
+    tkn_checksum += tkn.size;
+    ++cnt;
+}
+
+} // namespace
+
+
+#ifdef __GNUC__
+// kept out of line like operator delete, so that the compiler does not 
+// pair malloc() with delete, nor new with free()
+__attribute__((noinline))
+#endif
+void * operator new(std::size_t size)
+{
+    ++alloc_count;
+
+    if (void * p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+
+    throw std::bad_alloc();
+}
+
+
+void * operator new[](std::size_t size)
+{
+    return ::operator new(size);
+}
+
+
+#ifdef __GNUC__
+__attribute__((noinline))
+#endif
+void operator delete(void * p) noexcept
+{
+    std::free(p);
+}
+
+
+// the sized and array forms must match the replaced operators
+void operator delete(void * p, std::size_t) noexcept
+{
+    ::operator delete(p);
+}
+
+
+void operator delete[](void * p) noexcept
+{
+    ::operator delete(p);
+}
+
+
+void operator delete[](void * p, std::size_t) noexcept
+{
+    ::operator delete(p);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+namespace {
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Restart the high-water mark of the resident set size (if supported)
+void reset_peak_rss()
+{
+#ifdef __GLIBC__
+    // memory freed by previous measures is given back to the system
+    malloc_trim(0);
+#endif
+
+#ifdef __linux__
+    std::ofstream os("/proc/self/clear_refs");
+    os << "5";
+#endif
+}
+
+
+//! Return the peak resident set size in KiB, or 0 if unknown: it is the
+//! peak since the last reset_peak_rss() on Linux, the peak of the 
+//! process on other POSIX systems
+size_t peak_rss_kb()
+{
+#ifdef __linux__
+    std::ifstream is("/proc/self/status");
+    std::string line;
+
+    while (std::getline(is, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) {
+            return std::strtoul(line.c_str() + 6, nullptr, 10);
+        }
+    }
+#endif
+
+#if defined(_WIN32)
+    return 0;
+#else
+    struct rusage ru;
+
+    if (getrusage(RUSAGE_SELF, &ru) != 0) {
+        return 0;
+    }
+
+# ifdef __APPLE__
+    return static_cast<size_t>(ru.ru_maxrss) / 1024;
+# else
+    return static_cast<size_t>(ru.ru_maxrss);
+# endif
+#endif
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+struct grammar_def_t {
+    const char * name;
+    bool (*def)(mip::tknzr_bldr_t &);
+};
+
+const grammar_def_t grammars[] = {
+    { "c", def_c_grammar },
+    { "json", def_json_grammar },
+    { "log", def_log_grammar },
+    { "dict", def_dict_grammar }
+};
+
+
+const grammar_def_t * find_grammar(const std::string & name)
+{
+    for (const auto & g : grammars) {
+        if (name == g.name) {
+            return &g;
+        }
+    }
+
+    return nullptr;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+struct corpus_def_t {
+    const char * name;
+    const char * grammar;
+    mip::string_t (*make)(size_t size);
+};
+
+const corpus_def_t corpora[] = {
+    { "c", "c", synth_c_source },
+    { "json", "json", synth_json },
+    { "log", "log", synth_log },
+    { "long_lines", "c", synth_long_lines },
+    { "comments", "c", synth_comments },
+    { "escapes", "c", synth_escapes },
+    { "dict", "dict", synth_dict }
+};
+
+
+//! Corpus to be scanned
+struct corpus_t {
+    std::string name;
+    const grammar_def_t * grammar;
+    mip::string_t text;
+    std::string path;
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Result of a measure
+struct result_t {
+    std::string corpus;
+    std::string grammar;
+    std::string engine;
+    size_t bytes = 0;
+    size_t tokens = 0;
+    size_t checksum = 0;
+    double seconds = 0;
+    double allocs_per_token = 0;
+    size_t peak_rss_kb = 0;
+
+    //! hardware counters of the best run, and which ones were counted
+    perf_counters_t::values_t counters {};
+    std::array<bool, perf_counters_t::event_cnt> counted {};
+};
+
+
+//! Scan a corpus once, returning the number of tokens (0 on failure)
+using scan_t = std::function<size_t(const corpus_t &)>;
+
+//! Engine: make() returns nothing for unsupported corpora
+struct engine_def_t {
+    const char * name;
+    const char * desc;
+    std::function<scan_t(const corpus_t &, const std::string & tmp_dir)> make;
+
+    //! grammar actually used, if not the one of the corpus
+    const char * grammar;
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+std::unique_ptr<mip::tknzr_t> build_engine(const corpus_t & corpus)
+{
+    mip::tknzr_bldr_t bldr;
+
+    if (!corpus.grammar->def(bldr)) {
+        return nullptr;
+    }
+
+    return bldr.build_engine();
+}
+
+
+//! Tokens of next() loop
+scan_t make_next(const corpus_t & corpus, const std::string &)
+{
+    std::shared_ptr<mip::tknzr_t> engine = build_engine(corpus);
+
+    if (!engine) {
+        return nullptr;
+    }
+
+    return [engine](const corpus_t & corpus) -> size_t {
+        mip::_istringstream is(corpus.text);
+        size_t cnt = 0;
+
+        engine->reset();
+
+        while (!engine->eos(is)) {
+            auto tkn = engine->next(is);
+
+            if (!tkn) {
+                return 0;
+            }
+
+            tkn_checksum += tkn->value().size();
+            ++cnt;
+        }
+
+        return cnt;
+    };
+}
+
+
+//! Token lists built by tknlst_bldr_t (the tokenizer is built each run)
+scan_t make_tknlst(const corpus_t &, const std::string &)
+{
+    return [](const corpus_t & corpus) -> size_t {
+        mip::tknzr_bldr_t bldr;
+
+        if (!corpus.grammar->def(bldr)) {
+            return 0;
+        }
+
+        mip::tknlst_bldr_t lst_bldr(std::move(bldr));
+        mip::tknlist_t nonblnks, blnks;
+        mip::_istringstream is(corpus.text);
+
+        if (!lst_bldr.build(is, nonblnks, blnks)) {
+            return 0;
+        }
+
+        for (const auto & lst : { &nonblnks, &blnks }) {
+            for (const auto & tkn : *lst) {
+                tkn_checksum += tkn->value().size();
+            }
+        }
+
+        return nonblnks.size() + blnks.size();
+    };
+}
+
+
+//! Scanner of tokens
+template <class Scanner>
+scan_t make_scan(std::shared_ptr<Scanner> scanner)
+{
+    return [scanner](const corpus_t & corpus) -> size_t {
+        mip::_istringstream is(corpus.text);
+        size_t cnt = 0;
+
+        scanner->reset();
+
+        const bool ok = scanner->tokenize(is, 
+            [&cnt](const mip::tkn_view_t & tkn) {
+                count_tkn(tkn, cnt);
+            });
+
+        return ok ? cnt : 0;
+    };
+}
+
+
+//! Token views delivered by tknzr_t::tokenize()
+scan_t make_tokenize(const corpus_t & corpus, const std::string &)
+{
+    std::shared_ptr<mip::tknzr_t> engine = build_engine(corpus);
+    return engine ? make_scan(engine) : nullptr;
+}
+
+
+//! Counts of tknzr_t::stats(), which builds no token value
+scan_t make_stats(const corpus_t & corpus, const std::string &)
+{
+    std::shared_ptr<mip::tknzr_t> engine = build_engine(corpus);
+
+    if (!engine) {
+        return nullptr;
+    }
+
+    return [engine](const corpus_t & corpus) -> size_t {
+        mip::_istringstream is(corpus.text);
+        mip::tknzr_stats_t st;
+
+        engine->reset();
+
+        if (!engine->stats(is, st)) {
+            return 0;
+        }
+
+        size_t cnt = 0;
+
+        for (size_t cl = 0; cl < st.tcl_cnt; ++cl) {
+            tkn_checksum += st.length[cl];
+            cnt += st.tokens[cl];
+        }
+
+        return cnt;
+    };
+}
+
+
+//! Compile-time C grammar (see c_static_grammar.h)
+scan_t make_static(const corpus_t & corpus, const std::string &)
+{
+    if (std::strcmp(corpus.grammar->name, "c") != 0) {
+        return nullptr;
+    }
+
+    return make_scan(
+        std::make_shared<mip::static_tknzr_t<c_static_grammar_t>>());
+}
+
+
+#ifdef MIPTKNZR_BENCH_GENERATED
+//! Scanner generated by miptknzr_gen for the C grammar
+scan_t make_generated(const corpus_t & corpus, const std::string &)
+{
+    if (std::strcmp(corpus.grammar->name, "c") != 0) {
+        return nullptr;
+    }
+
+    return make_scan(std::make_shared<c_scanner_t>());
+}
+#endif
+
+
+//! Token cache (see tkn_cache_t): the corpus is stored as a file, which 
+//! is tokenized and stored by each run if cold, replayed if warm
+scan_t make_cache(
+    const corpus_t & corpus, 
+    const std::string & tmp_dir, 
+    bool warm)
+{
+    std::shared_ptr<mip::tknzr_t> engine = build_engine(corpus);
+
+    if (!engine || tmp_dir.empty()) {
+        return nullptr;
+    }
+
+    auto path = std::make_shared<std::string>(corpus.path);
+
+    if (path->empty()) {
+        *path = tmp_dir + "/" + corpus.name + ".txt";
+
+        mip::_ofstream os(*path, std::ios::binary);
+        os << corpus.text;
+
+        if (!os) {
+            return nullptr;
+        }
+    }
+
+    auto cache = std::make_shared<mip::tkn_cache_t>(tmp_dir);
+
+    // the stream of a warm cache is stored in advance
+    cache->evict(*engine, *path);
+
+    if (warm) {
+        mip::tkn_stream_t stream;
+
+        if (!cache->load(*engine, *path, stream)) {
+            return nullptr;
+        }
+    }
+
+    return [engine, cache, path, warm](const corpus_t &) -> size_t {
+        size_t cnt = 0;
+
+        if (!warm) {
+            cache->evict(*engine, *path);
+        }
+
+        const bool ok = cache->tokenize(*engine, *path, 
+            [&cnt](const mip::tkn_view_t & tkn) {
+                count_tkn(tkn, cnt);
+            });
+
+        return ok ? cnt : 0;
+    };
+}
+
+
+const engine_def_t engines[] = {
+    { "next", "base_tknzr_t::next() loop", make_next, nullptr },
+    { "tknlst", "tknlst_bldr_t::build()", make_tknlst, nullptr },
+    { "tokenize", "tknzr_t::tokenize()", make_tokenize, nullptr },
+    { "stats", "tknzr_t::stats(), counts only", make_stats, nullptr },
+    { "static", "static_tknzr_t, compile-time C grammar", make_static, 
+        "c_static" },
+#ifdef MIPTKNZR_BENCH_GENERATED
+    { "generated", "scanner generated by miptknzr_gen", make_generated, 
+        nullptr },
+#endif
+    { "cache_cold", "tkn_cache_t, missing stream", 
+        [](const corpus_t & c, const std::string & d) { 
+            return make_cache(c, d, false); 
+        }, 
+        nullptr 
+    },
+    { "cache_warm", "tkn_cache_t, stored stream", 
+        [](const corpus_t & c, const std::string & d) { 
+            return make_cache(c, d, true); 
+        }, 
+        nullptr 
+    }
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Measure an engine, returning false if it failed
+bool measure(
+    const scan_t & scan, 
+    const corpus_t & corpus, 
+    int runs, 
+    perf_counters_t & counters,
+    result_t & res)
+{
+    perf_counters_t::values_t values;
+
+    reset_peak_rss();
+
+    for (size_t e = 0; e < perf_counters_t::event_cnt; ++e) {
+        res.counted[e] = counters.available(e);
+    }
+
+    for (int i = 0; i < runs; ++i) {
+        alloc_count = 0;
+        tkn_checksum = 0;
+
+        counters.start();
+
+        const auto begin = std::chrono::steady_clock::now();
+        const size_t tokens = scan(corpus);
+        const std::chrono::duration<double> t = 
+            std::chrono::steady_clock::now() - begin;
+
+        counters.stop(values);
+
+        const size_t allocs = alloc_count;
+
+        if (tokens == 0) {
+            return false;
+        }
+
+        if (i == 0 || t.count() < res.seconds) {
+            res.seconds = t.count();
+            res.counters = values;
+        }
+
+        res.tokens = tokens;
+        res.checksum = tkn_checksum;
+        res.allocs_per_token = double(allocs) / tokens;
+    }
+
+    res.bytes = corpus.text.size() * sizeof(mip::char_t);
+    res.peak_rss_kb = peak_rss_kb();
+
+    return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Create a temporary directory, returning its path (empty on failure)
+std::string make_tmp_dir()
+{
+#ifdef _WIN32
+    char name[L_tmpnam] = { 0 };
+
+    if (!std::tmpnam(name) || _mkdir(name) != 0) {
+        return std::string();
+    }
+
+    return name;
+#else
+    const char * tmp = std::getenv("TMPDIR");
+    std::string path = std::string(tmp ? tmp : "/tmp") + "/miptknzr_XXXXXX";
+
+    return mkdtemp(&path[0]) ? path : std::string();
+#endif
+}
+
+
+//! Remove the temporary directory, the corpora and the streams stored 
+//! in it
+void remove_tmp_dir(
+    const std::string & dir, 
+    const std::vector<corpus_t> & selection)
+{
+    for (const auto & corpus : selection) {
+        auto engine = build_engine(corpus);
+        const std::string path = corpus.path.empty() ? 
+            dir + "/" + corpus.name + ".txt" : corpus.path;
+
+        if (engine) {
+            mip::tkn_cache_t(dir).evict(*engine, path);
+        }
+
+        if (corpus.path.empty()) {
+            std::remove(path.c_str());
+        }
+    }
+
+#ifdef _WIN32
+    _rmdir(dir.c_str());
+#else
+    rmdir(dir.c_str());
+#endif
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+std::vector<std::string> split(const std::string & list)
+{
+    std::vector<std::string> items;
+    size_t begin = 0;
+
+    while (begin <= list.size()) {
+        size_t end = list.find(',', begin);
+
+        if (end == std::string::npos) {
+            end = list.size();
+        }
+
+        if (end > begin) {
+            items.push_back(list.substr(begin, end - begin));
+        }
+
+        begin = end + 1;
+    }
+
+    return items;
+}
+
+
+bool selected(const std::vector<std::string> & items, const char * name)
+{
+    return items.empty() || 
+        std::find(items.begin(), items.end(), name) != items.end();
+}
+
+
+//! Return a string quoted for JSON and CSV output
+std::string quote(const std::string & s)
+{
+    std::string q = "\"";
+
+    for (const auto ch : s) {
+        if (ch == '"' || ch == '\\') {
+            q += '\\';
+        }
+
+        q += ch;
+    }
+
+    return q + "\"";
+}
+
+
+//! Print a counter per token and per byte (and instructions per cycle),
+//! or nothing (null in JSON) for counters not available
+void print_counters(std::ostream & os, const result_t & r, bool json)
+{
+    const char * const sep = json ? ", \"" : ",";
+    const char * const eq = json ? "\": " : "";
+    const char * const none = json ? "null" : "";
+
+    for (size_t e = 0; e < perf_counters_t::event_cnt; ++e) {
+        const char * const name = perf_counters_t::name(e);
+
+        for (int per_byte = 0; per_byte < 2; ++per_byte) {
+            os << sep;
+
+            if (json) {
+                os << name << (per_byte ? "_per_byte" : "_per_token") << eq;
+            }
+
+            if (r.counted[e]) {
+                os << double(r.counters[e]) / (per_byte ? r.bytes : r.tokens);
+            }
+            else {
+                os << none;
+            }
+        }
+    }
+
+    const size_t cycles = size_t(perf_counters_t::event_t::CYCLES);
+    const size_t instrs = size_t(perf_counters_t::event_t::INSTRUCTIONS);
+
+    os << sep << (json ? "ipc" : "") << eq;
+
+    if (r.counted[cycles] && r.counted[instrs] && r.counters[cycles]) {
+        os << double(r.counters[instrs]) / r.counters[cycles];
+    }
+    else {
+        os << none;
+    }
+}
+
+
+void print_json(std::ostream & os, const std::vector<result_t> & results)
+{
+    os << "{\n  \"benchmark\": \"miptknzr_bench\",\n  \"version\": 1,\n"
+       << "  \"char_size\": " << sizeof(mip::char_t) << ",\n"
+       << "  \"results\": [";
+
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto & r = results[i];
+
+        os << (i ? ",\n" : "\n") << "    { "
+           << "\"corpus\": " << quote(r.corpus) 
+           << ", \"grammar\": " << quote(r.grammar) 
+           << ", \"engine\": " << quote(r.engine) 
+           << ", \"bytes\": " << r.bytes 
+           << ", \"tokens\": " << r.tokens 
+           << ", \"checksum\": " << r.checksum 
+           << ", \"seconds\": " << r.seconds 
+           << ", \"mb_per_s\": " << r.bytes / r.seconds / 1e6 
+           << ", \"tokens_per_s\": " << r.tokens / r.seconds 
+           << ", \"allocs_per_token\": " << r.allocs_per_token 
+           << ", \"peak_rss_kb\": " << r.peak_rss_kb;
+
+        print_counters(os, r, true);
+
+        os << " }";
+    }
+
+    os << "\n  ]\n}" << std::endl;
+}
+
+
+void print_csv(std::ostream & os, const std::vector<result_t> & results)
+{
+    os << "corpus,grammar,engine,bytes,tokens,checksum,seconds,mb_per_s,"
+       << "tokens_per_s,allocs_per_token,peak_rss_kb";
+
+    for (size_t e = 0; e < perf_counters_t::event_cnt; ++e) {
+        os << ',' << perf_counters_t::name(e) << "_per_token," 
+           << perf_counters_t::name(e) << "_per_byte";
+    }
+
+    os << ",ipc\n";
+
+    for (const auto & r : results) {
+        os << quote(r.corpus) << ',' << quote(r.grammar) << ',' 
+           << quote(r.engine) << ',' << r.bytes << ',' << r.tokens << ',' 
+           << r.checksum << ',' << r.seconds << ',' << r.bytes / r.seconds / 1e6 << ',' 
+           << r.tokens / r.seconds << ',' << r.allocs_per_token << ',' 
+           << r.peak_rss_kb;
+
+        print_counters(os, r, false);
+
+        os << '\n';
+    }
+
+    os.flush();
+}
+
+
+void print_list()
+{
+    std::cout << "corpora:\n";
+
+    for (const auto & c : corpora) {
+        std::cout << "  " << c.name << " (grammar " << c.grammar << ")\n";
+    }
+
+    std::cout << "grammars:\n";
+
+    for (const auto & g : grammars) {
+        std::cout << "  " << g.name << "\n";
+    }
+
+    std::cout << "engines:\n";
+
+    for (const auto & e : engines) {
+        std::cout << "  " << e.name << ": " << e.desc << "\n";
+    }
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+} // namespace
+
+
+/* -------------------------------------------------------------------------- */
+
+int main(int argc, char* argv[])
+{
+    std::vector<std::string> corpus_sel, engine_sel, files;
+    std::string grammar = "c";
+    std::string format = "json";
+    size_t size = 4 << 20;
+    int runs = 3;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string opt = argv[i];
+
+        if (opt == "--list") {
+            print_list();
+            return 0;
+        }
+
+        if (i + 1 >= argc) {
+            std::cerr << "usage: " << argv[0] << " [--corpus a,b,...] "
+                      << "[--engine a,b,...] [--file path] [--grammar name] "
+                      << "[--size n] [--runs n] [--format json|csv] "
+                      << "[--list]" << std::endl;
+            return 1;
+        }
+
+        const std::string arg = argv[++i];
+
+        if (opt == "--corpus") {
+            corpus_sel = split(arg);
+        }
+        else if (opt == "--engine") {
+            engine_sel = split(arg);
+        }
+        else if (opt == "--file") {
+            files.push_back(arg);
+        }
+        else if (opt == "--grammar") {
+            grammar = arg;
+        }
+        else if (opt == "--size") {
+            size = std::strtoul(arg.c_str(), nullptr, 10);
+        }
+        else if (opt == "--runs") {
+            runs = std::max(1, std::atoi(arg.c_str()));
+        }
+        else if (opt == "--format" && (arg == "json" || arg == "csv")) {
+            format = arg;
+        }
+        else {
+            std::cerr << "Invalid option " << opt << " " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<corpus_t> selection;
+
+    if (files.empty() || !corpus_sel.empty()) {
+        for (const auto & c : corpora) {
+            if (selected(corpus_sel, c.name)) {
+                selection.push_back(
+                    { c.name, find_grammar(c.grammar), c.make(size), "" });
+            }
+        }
+    }
+
+    for (const auto & f : files) {
+        corpus_t corpus = { f, find_grammar(grammar), mip::string_t(), f };
+
+        if (!corpus.grammar) {
+            std::cerr << grammar << ": unknown grammar" << std::endl;
+            return 1;
+        }
+
+        if (!read_text(f.c_str(), corpus.text)) {
+            return 1;
+        }
+
+        selection.push_back(std::move(corpus));
+    }
+
+    perf_counters_t counters;
+
+    if (!counters.any()) {
+        std::cerr << "Hardware counters not available "
+                  << "(see /proc/sys/kernel/perf_event_paranoid)" << std::endl;
+    }
+
+    const std::string tmp_dir = make_tmp_dir();
+    std::vector<result_t> results;
+
+    for (const auto & corpus : selection) {
+        for (const auto & e : engines) {
+            if (!selected(engine_sel, e.name)) {
+                continue;
+            }
+
+            const auto scan = e.make(corpus, tmp_dir);
+
+            if (!scan) {
+                continue;
+            }
+
+            result_t res;
+            res.corpus = corpus.name;
+            res.grammar = e.grammar ? e.grammar : corpus.grammar->name;
+            res.engine = e.name;
+
+            if (!measure(scan, corpus, runs, counters, res)) {
+                std::cerr << corpus.name << ": engine " << e.name 
+                          << " failed" << std::endl;
+                continue;
+            }
+
+            results.push_back(res);
+        }
+    }
+
+    if (!tmp_dir.empty()) {
+        remove_tmp_dir(tmp_dir, selection);
+    }
+
+    if (format == "csv") {
+        print_csv(std::cout, results);
+    }
+    else {
+        print_json(std::cout, results);
+    }
+
+    return 0;
+}
@@ -0,0 +1,199 @@
+//  
+// This file is part of MipTknzr Library Project
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.  
+// Licensed under the MIT License. 
+// See COPYING file in the project root for full license information.
+//
+
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef __PERF_COUNTERS_H__
+#define __PERF_COUNTERS_H__
+
+
+/* -------------------------------------------------------------------------- */
+
+// Hardware performance counters of the calling thread, read by means of 
+// perf_event_open() on Linux. Each counter is opened on its own, so that 
+// any counter the system does not support (or allow, see 
+// /proc/sys/kernel/perf_event_paranoid) is just reported as unavailable. 
+// On other systems no counter is available
+
+
+/* -------------------------------------------------------------------------- */
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+/* -------------------------------------------------------------------------- */
+
+class perf_counters_t {
+public:
+    //! Counters
+    enum class event_t {
+        CYCLES,
+        INSTRUCTIONS,
+        BRANCH_MISSES,
+        L1D_MISSES,     //!< L1 data cache read misses
+        LLC_MISSES      //!< last level cache read misses
+    };
+
+    static const size_t event_cnt = 5;
+
+    using values_t = std::array<uint64_t, event_cnt>;
+
+    //! Return the name of a counter
+    static const char * name(size_t event) noexcept {
+        static const char * const names[event_cnt] = {
+            "cycles", "instructions", "branch_misses", "l1d_misses", 
+            "llc_misses"
+        };
+
+        return names[event];
+    }
+
+    //! ctor: open the counters (disabled)
+    perf_counters_t() noexcept {
+        _fd.fill(-1);
+
+#ifdef __linux__
+        for (size_t e = 0; e < event_cnt; ++e) {
+            struct perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+
+            attr.size = sizeof(attr);
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = 
+                PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            _config(static_cast<event_t>(e), attr);
+
+            _fd[e] = static_cast<int>(
+                syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+#endif
+    }
+
+    perf_counters_t(const perf_counters_t&) = delete;
+    perf_counters_t& operator=(const perf_counters_t&) = delete;
+
+    //! dtor
+    ~perf_counters_t() {
+#ifdef __linux__
+        for (const auto fd : _fd) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+#endif
+    }
+
+    //! Return true if a counter is available
+    bool available(size_t event) const noexcept {
+        return _fd[event] >= 0;
+    }
+
+    //! Return true if any counter is available
+    bool any() const noexcept {
+        for (size_t e = 0; e < event_cnt; ++e) {
+            if (available(e)) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    //! Reset and start the counters
+    void start() noexcept {
+#ifdef __linux__
+        for (const auto fd : _fd) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+    }
+
+    //! Stop the counters and get their values since start(), scaled up 
+    //! if the counters have been multiplexed (0 if not available)
+    void stop(values_t & values) noexcept {
+        values.fill(0);
+
+#ifdef __linux__
+        for (const auto fd : _fd) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            }
+        }
+
+        for (size_t e = 0; e < event_cnt; ++e) {
+            // value, time enabled, time running
+            uint64_t data[3] = { 0 };
+
+            if (_fd[e] < 0 || 
+                read(_fd[e], data, sizeof(data)) != sizeof(data) ||
+                data[2] == 0) 
+            {
+                continue;
+            }
+
+            values[e] = data[1] == data[2] ? data[0] : 
+                static_cast<uint64_t>(double(data[0]) * data[1] / data[2]);
+        }
+#endif
+    }
+
+private:
+#ifdef __linux__
+    static void _config(event_t event, struct perf_event_attr & attr) {
+        const uint64_t cache_read_miss = 
+            (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+            (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+
+        switch (event) {
+        case event_t::CYCLES:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case event_t::INSTRUCTIONS:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case event_t::BRANCH_MISSES:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+        case event_t::L1D_MISSES:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_L1D | cache_read_miss;
+            break;
+        case event_t::LLC_MISSES:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_LL | cache_read_miss;
+            break;
+        }
+    }
+#endif
+
+    std::array<int, event_cnt> _fd;
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+#endif // __PERF_COUNTERS_H__
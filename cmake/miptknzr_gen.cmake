@@ -0,0 +1,43 @@
+#
+# miptknzr_generate_scanner(<class name>
+#     OUTPUT <generated source>
+#     GRAMMAR <grammar file> | GRAMMAR_TOOL <executable target>)
+#
+# Generate the source of a scanner class specialized for a tokenizer 
+# grammar by means of miptknzr_gen (see mip_lexgen.h). The grammar is 
+# either a file written by tknzr_t::save_grammar() or the output of an 
+# executable target which defines it through tknzr_bldr_t and saves it 
+# into the file passed as its first argument. The scanner is generated 
+# again whenever the grammar (or the program defining it) changes.
+#
+
+include(CMakeParseArguments)
+
+function(miptknzr_generate_scanner class_name)
+    cmake_parse_arguments(GEN "" "OUTPUT;GRAMMAR;GRAMMAR_TOOL" "" ${ARGN})
+
+    if(NOT GEN_OUTPUT)
+        message(FATAL_ERROR "miptknzr_generate_scanner: OUTPUT is required")
+    endif()
+
+    if(GEN_GRAMMAR_TOOL)
+        set(grammar "${CMAKE_CURRENT_BINARY_DIR}/${class_name}.mtkg")
+
+        add_custom_command(
+            OUTPUT ${grammar}
+            COMMAND ${GEN_GRAMMAR_TOOL} ${grammar}
+            DEPENDS ${GEN_GRAMMAR_TOOL}
+            COMMENT "Saving grammar of ${class_name}")
+    elseif(GEN_GRAMMAR)
+        get_filename_component(grammar ${GEN_GRAMMAR} ABSOLUTE)
+    else()
+        message(FATAL_ERROR 
+            "miptknzr_generate_scanner: GRAMMAR or GRAMMAR_TOOL is required")
+    endif()
+
+    add_custom_command(
+        OUTPUT ${GEN_OUTPUT}
+        COMMAND miptknzr_gen ${grammar} ${GEN_OUTPUT} ${class_name}
+        DEPENDS miptknzr_gen ${grammar}
+        COMMENT "Generating scanner ${class_name}")
+endfunction()
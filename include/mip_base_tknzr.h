@@ -16,6 +16,7 @@
 /* -------------------------------------------------------------------------- */
 
 #include "mip_token.h"
+#include "mip_tknzr_stats.h"
 
 #include <memory>
 #include <istream>
@@ -37,6 +38,22 @@ struct base_tknzr_t
         LF
     };
 
+    //! Number formats
+    enum class num_t {
+        DEC,   // 123
+        HEX,   // 0x1F
+        OCT,   // 017
+        BIN,   // 0b101
+        FLOAT  // 1.5, .5, 1e3, 1.5e-3
+    };
+
+    //! Multi-line comment delivery
+    enum class comment_t {
+        VALUE,   // a token holding the whole comment text
+        EXTENT,  // a token holding no text, just positions (pos, end)
+        CHUNKS   // a token per line holding the text of that line
+    };
+
     //! dtor
     virtual ~base_tknzr_t() {}
 
@@ -45,6 +62,34 @@ struct base_tknzr_t
 
     //! Return true if there is no more data to process
     virtual bool eos(_istream & is) = 0;
+
+    //! Scan the input stream up to its end collecting statistics 
+    //! without building any token; return false in case of error.
+    //! The default implementation counts the tokens returned by next()
+    virtual bool stats(_istream & is, tknzr_stats_t & st) {
+        size_t first_line = 0;
+        bool first = true;
+
+        while (true) {
+            auto tkn = next(is);
+
+            if (!tkn) {
+                return false;
+            }
+
+            if (first) {
+                first_line = tkn->line();
+                first = false;
+            }
+
+            st.count(tkn->type(), tkn->value().size());
+
+            if (tkn->type() == token_t::tcl_t::END_OF_FILE) {
+                st.lines += tkn->line() + 1 - first_line;
+                return true;
+            }
+        }
+    }
 };
 
 
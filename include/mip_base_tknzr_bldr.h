@@ -29,7 +29,8 @@ namespace mip {
 
 /* -------------------------------------------------------------------------- */
 
-//! Abstract base class of tokenizer builder objects
+//! Abstract base class of tokenizer builder objects: optional definitions
+//! have default implementations returning false (not supported)
 struct base_tknzr_bldr_t
 {
     //! dtor
@@ -38,24 +39,139 @@ struct base_tknzr_bldr_t
     //! Build a tokenizer object
     virtual std::unique_ptr< base_tknzr_t > build() = 0;
 
-    //! Add a definition of an atomic token
+    //! Add a definition of an atomic token; definitions without an 
+    //! explicit id are numbered one above the highest id of their class 
+    //! (0, 1, 2, ... if no explicit id is given) and matching tokens 
+    //! carry their id (see token_t::id())
     virtual bool def_atom(const string_t& value) = 0;
 
+    //! Add a definition of an atomic token with a given id; fails if 
+    //! the id is already used by another definition of the same class
+    virtual bool def_atom(const string_t& /*value*/, size_t /*id*/) {
+        return false;
+    }
+
     //! Define a set of atomic tokens
     virtual bool def_atom(const std::set<string_t>& value_set) = 0;
 
+    //! Add a definition of a keyword: other tokens whose whole value is 
+    //! a keyword are classified as keyword tokens (unlike atoms, keywords 
+    //! never split other tokens); ids are assigned as for atoms
+    virtual bool def_keyword(const string_t& /*value*/) {
+        return false;
+    }
+
+    //! Add a definition of a keyword with a given id
+    virtual bool def_keyword(const string_t& /*value*/, size_t /*id*/) {
+        return false;
+    }
+
+    //! Define a set of keywords
+    virtual bool def_keyword(const std::set<string_t>& /*value_set*/) {
+        return false;
+    }
+
+    //! Add a definition of a pattern token (see dfa_t for the syntax, 
+    //! e.g. "[A-Za-z_]\\w*" or "0[xX][0-9a-fA-F]+"); the longest text 
+    //! matching either a pattern or an atom is taken, on equal length 
+    //! atoms win over patterns and lower pattern ids over higher ones. 
+    //! Ids are assigned as for atoms
+    virtual bool def_pattern(const string_t& /*pattern*/) {
+        return false;
+    }
+
+    //! Add a definition of a pattern token with a given id
+    virtual bool def_pattern(const string_t& /*pattern*/, size_t /*id*/) {
+        return false;
+    }
+
+    //! Add a definition of a bracket pair (opener and closer are defined 
+    //! as atoms if not yet defined): the tokenizer then indexes matching 
+    //! brackets while scanning (see tknzr_t::brackets())
+    virtual bool def_bracket(
+        const string_t& /*open*/, const string_t& /*close*/) {
+        return false;
+    }
+
     //! Add a definition of a blank token
     virtual bool def_blank(const string_t& value) = 0;
 
+    //! Add a definition of a blank token with a given id
+    virtual bool def_blank(const string_t& /*value*/, size_t /*id*/) {
+        return false;
+    }
+
     //! Define a set of blank tokens
     virtual bool def_blank(const std::set<string_t>& value_set) = 0;
 
+    //! Tokenize raw UTF-8 input with the narrow character engine: each 
+    //! line read is validated (invalid input makes scanning fail) and, 
+    //! if unicode_blanks is true, the non-ASCII Unicode white space 
+    //! characters are defined as blanks. Not available if _UNICODE is 
+    //! defined.
+    virtual bool def_utf8(bool /*unicode_blanks*/ = true) {
+        return false;
+    }
+
+    //! Scan long lines through a sliding window of the given size rather 
+    //! than reading each line as a whole: memory is bounded by about 
+    //! three times the window size plus the longest token. The window 
+    //! must be larger than any defined token; it grows to fit a longer 
+    //! token (such as a long other token, string or single-line comment) 
+    //! up to max_token characters (64 times the window size if 0), and 
+    //! scanning fails (tknzr_t::error() is error_t::TOKEN_SIZE) on a 
+    //! longer one. Multi-line comments are still collected as a whole.
+    virtual bool def_window(size_t /*size*/, size_t /*max_token*/ = 0) {
+        return false;
+    }
+
+    //! Collect the line starts while scanning, so that line and column 
+    //! of any absolute token position can be resolved on demand 
+    //! (see tknzr_t::lines())
+    virtual bool def_line_index(bool /*enable*/ = true) {
+        return false;
+    }
+
+    //! Deliver tokens carrying only their absolute position (pos, end): 
+    //! line and offset are not maintained for each token (they are left 
+    //! 0, and so are the positions of bracket mismatches), the line 
+    //! starts are collected instead, so that line and column of a token 
+    //! are resolved on demand (see tknzr_t::lines())
+    virtual bool def_offsets_only(bool /*enable*/ = true) {
+        return false;
+    }
+
+    //! Merge any run of consecutive blanks into a single blank token 
+    //! (whose id is the one of the first blank of the run)
+    virtual bool def_blank_run(bool /*enable*/ = true) {
+        return false;
+    }
+
     //! Add a definition of a multi-line comment
     virtual bool def_ml_comment(const string_t& begin, const string_t& end) = 0;
 
+    //! Add a definition of a multi-line comment with a given id
+    virtual bool def_ml_comment(
+        const string_t& /*begin*/, const string_t& /*end*/, size_t /*id*/) {
+        return false;
+    }
+
+    //! Select how multi-line comments are delivered: whole (default), 
+    //! as extents only, so that their text is never collected, or as 
+    //! a series of comment tokens, one per line, separated by the 
+    //! end-of-line tokens
+    virtual bool def_ml_comment_mode(base_tknzr_t::comment_t /*mode*/) {
+        return false;
+    }
+
     //! Add a definition of a single-line comment
     virtual bool def_sl_comment(const string_t& prefix) = 0;
 
+    //! Add a definition of a single-line comment with a given id
+    virtual bool def_sl_comment(const string_t& /*prefix*/, size_t /*id*/) {
+        return false;
+    }
+
     //! Define of a set of single-line comments
     virtual bool def_sl_comment(const std::set<string_t>& prefix_set) = 0;
 
@@ -65,6 +181,31 @@ struct base_tknzr_bldr_t
     //! Define a set of end-of-line tokens
     virtual bool def_eol(const std::set<base_tknzr_t::eol_t>& value_set) = 0;
 
+    //! Add a number format: numbers are classified as number tokens 
+    //! and their value is parsed while scanning (see token_t::num())
+    virtual bool def_number(const base_tknzr_t::num_t& /*value*/) {
+        return false;
+    }
+
+    //! Define a set of number formats
+    virtual bool def_number(
+        const std::set<base_tknzr_t::num_t>& /*value_set*/) {
+        return false;
+    }
+
+    //! Enable indentation tracking for offside-rule languages: whenever 
+    //! the leading white space width of a line increases an indent token 
+    //! is emitted at the line beginning, whenever it decreases a dedent 
+    //! token is emitted for each closed level (and at end of file). 
+    //! Blank and comment-only lines are ignored. Indent and dedent tokens
+    //! carry the width of the level they open or close (see 
+    //! token_t::width()). A line dedented to a width matching no outer 
+    //! level makes scanning fail (tknzr_t::error_t::INDENT).
+    //! @param tab_size is the tab stop width used to expand tabs
+    virtual bool def_indent(size_t /*tab_size*/ = 8) {
+        return false;
+    }
+
     //! Add a definition of a string token
     virtual bool def_string(char_t quote, std::shared_ptr<base_esc_cnvrtr_t> et = nullptr) = 0;
 };
@@ -38,7 +38,12 @@ struct base_token_t
         COMMENT,
         STRING,
         ATOM,
-        OTHER
+        OTHER,
+        KEYWORD,
+        PATTERN,
+        NUMBER,
+        INDENT,
+        DEDENT
     };
 
     //! Return <quota, escape prefix> of string token
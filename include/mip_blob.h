@@ -0,0 +1,166 @@
+//  
+// This file is part of MipTknzr Library Project
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.  
+// Licensed under the MIT License. 
+// See COPYING file in the project root for full license information.
+//
+
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef __MIP_BLOB_H__
+#define __MIP_BLOB_H__
+
+
+/* -------------------------------------------------------------------------- */
+
+#include "mip_unicode.h"
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+
+/* -------------------------------------------------------------------------- */
+
+namespace mip {
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Writer of a flat binary blob (values are stored in native byte order,
+//! sizes as 64-bit integers)
+class blob_writer_t {
+public:
+    explicit blob_writer_t(std::vector<char> & out) noexcept : _out(out) {}
+
+    template <class T>
+    void put(const T & value) {
+        static_assert(std::is_trivially_copyable<T>::value, "POD expected");
+        const auto * p = reinterpret_cast<const char *>(&value);
+        _out.insert(_out.end(), p, p + sizeof(T));
+    }
+
+    void put_size(size_t size) {
+        put(static_cast<uint64_t>(size));
+    }
+
+    void put_str(const string_t & s) {
+        put_size(s.size());
+        const auto * p = reinterpret_cast<const char *>(s.data());
+        _out.insert(_out.end(), p, p + s.size() * sizeof(char_t));
+    }
+
+    template <class T>
+    void put_vec(const std::vector<T> & v) {
+        static_assert(std::is_trivially_copyable<T>::value, "POD expected");
+        put_size(v.size());
+        const auto * p = reinterpret_cast<const char *>(v.data());
+        _out.insert(_out.end(), p, p + v.size() * sizeof(T));
+    }
+
+private:
+    std::vector<char> & _out;
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Reader of a blob written by blob_writer_t: any read past the end of 
+//! data fails and leaves the reader in error state (see ok())
+class blob_reader_t {
+public:
+    blob_reader_t(const char * data, size_t size) noexcept : 
+        _p(data), _end(data + size) 
+    {}
+
+    template <class T>
+    bool get(T & value) noexcept {
+        static_assert(std::is_trivially_copyable<T>::value, "POD expected");
+
+        if (!_ok || size_t(_end - _p) < sizeof(T)) {
+            return _ok = false;
+        }
+
+        std::memcpy(&value, _p, sizeof(T));
+        _p += sizeof(T);
+
+        return true;
+    }
+
+    bool get_size(size_t & size) noexcept {
+        uint64_t value = 0;
+
+        if (!get(value) || value > uint64_t(_end - _p)) {
+            return _ok = false;
+        }
+
+        size = static_cast<size_t>(value);
+
+        return true;
+    }
+
+    bool get_str(string_t & s) {
+        size_t size = 0;
+
+        if (!get_size(size) || size_t(_end - _p) / sizeof(char_t) < size) {
+            return _ok = false;
+        }
+
+        s.resize(size);
+
+        if (size) {
+            std::memcpy(&s[0], _p, size * sizeof(char_t));
+        }
+
+        _p += size * sizeof(char_t);
+
+        return true;
+    }
+
+    template <class T>
+    bool get_vec(std::vector<T> & v) {
+        size_t size = 0;
+
+        if (!get_size(size) || size_t(_end - _p) / sizeof(T) < size) {
+            return _ok = false;
+        }
+
+        v.resize(size);
+
+        if (size) {
+            std::memcpy(v.data(), _p, size * sizeof(T));
+        }
+
+        _p += size * sizeof(T);
+
+        return true;
+    }
+
+    //! Return false if any read failed
+    bool ok() const noexcept {
+        return _ok;
+    }
+
+    //! Return true if all data has been read
+    bool end() const noexcept {
+        return _p == _end;
+    }
+
+private:
+    const char * _p = nullptr;
+    const char * _end = nullptr;
+    bool _ok = true;
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+} // namespace mip
+
+
+/* -------------------------------------------------------------------------- */
+
+#endif // __MIP_BLOB_H__
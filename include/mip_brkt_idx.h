@@ -0,0 +1,162 @@
+//  
+// This file is part of MipTknzr Library Project
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.  
+// Licensed under the MIT License. 
+// See COPYING file in the project root for full license information.
+//
+
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef __MIP_BRKT_IDX_H__
+#define __MIP_BRKT_IDX_H__
+
+
+/* -------------------------------------------------------------------------- */
+
+#include "mip_tkn_view.h"
+
+#include <unordered_map>
+#include <vector>
+
+
+/* -------------------------------------------------------------------------- */
+
+namespace mip {
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ *  Index of matching bracket tokens built while scanning. Tokens are 
+ *  identified by their index in the token stream (see token_t::index()).
+ */
+class brkt_idx_t {
+public:
+    //! Invalid index
+    static const size_t npos = static_cast<size_t>(-1);
+
+    //! Mismatch kinds
+    enum class err_t {
+        UNCLOSED,   // opener without closer
+        UNOPENED,   // closer without opener
+        MISMATCHED  // closer of a different pair than the innermost opener
+    };
+
+    //! Mismatch description
+    struct mismatch_t {
+        err_t error;
+        size_t index;
+        size_t line;
+        size_t offset;
+    };
+
+    //! Return the index of the token matching a given opener or closer
+    //! token index, or npos if it is not a matched bracket
+    size_t match(size_t index) const {
+        auto it = _match.find(index);
+        return it == _match.end() ? npos : it->second;
+    }
+
+    //! Return the mismatches found so far
+    const std::vector<mismatch_t> & mismatches() const noexcept {
+        return _mismatches;
+    }
+
+    //! Return current nesting depth
+    size_t depth() const noexcept {
+        return _stack.size();
+    }
+
+    //! Account an opener of a given bracket pair
+    void open(size_t pair, const tkn_view_t & tkn, size_t index) {
+        _stack.push_back(frame_t{ pair, index, tkn.line, tkn.offset });
+    }
+
+    //! Account a closer of a given bracket pair
+    void close(size_t pair, const tkn_view_t & tkn, size_t index) {
+        size_t i = _stack.size();
+
+        while (i > 0 && _stack[i - 1].pair != pair) {
+            --i;
+        }
+
+        if (i == 0) {
+            _mismatches.push_back(
+                mismatch_t{ err_t::UNOPENED, index, tkn.line, tkn.offset });
+
+            return;
+        }
+
+        if (i != _stack.size()) {
+            _mismatches.push_back(
+                mismatch_t{ err_t::MISMATCHED, index, tkn.line, tkn.offset });
+
+            // openers enclosed by the matching one are left unclosed
+            while (_stack.size() > i) {
+                _unclosed(_stack.back());
+                _stack.pop_back();
+            }
+        }
+
+        const auto opener = _stack.back().index;
+        _stack.pop_back();
+
+        _match[opener] = index;
+        _match[index] = opener;
+    }
+
+    //! Account the end of the stream: any pending opener is unclosed
+    void end() {
+        for (const auto & frame : _stack) {
+            _unclosed(frame);
+        }
+
+        _stack.clear();
+    }
+
+    void clear() {
+        _match.clear();
+        _stack.clear();
+        _mismatches.clear();
+    }
+
+    //! Return the bytes of heap memory held (estimated for the map)
+    size_t mem_size() const noexcept {
+        const size_t node_size = 
+            sizeof(std::pair<const size_t, size_t>) + 2 * sizeof(void*);
+
+        return _match.size() * node_size + 
+            _match.bucket_count() * sizeof(void*) +
+            _stack.capacity() * sizeof(frame_t) + 
+            _mismatches.capacity() * sizeof(mismatch_t);
+    }
+
+private:
+    struct frame_t {
+        size_t pair;
+        size_t index;
+        size_t line;
+        size_t offset;
+    };
+
+    void _unclosed(const frame_t & frame) {
+        _mismatches.push_back(mismatch_t{ 
+            err_t::UNCLOSED, frame.index, frame.line, frame.offset });
+    }
+
+    std::unordered_map<size_t, size_t> _match;
+    std::vector<frame_t> _stack;
+    std::vector<mismatch_t> _mismatches;
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+} // namespace mip
+
+
+/* -------------------------------------------------------------------------- */
+
+#endif // __MIP_BRKT_IDX_H__
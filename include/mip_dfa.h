@@ -0,0 +1,176 @@
+//  
+// This file is part of MipTknzr Library Project
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.  
+// Licensed under the MIT License. 
+// See COPYING file in the project root for full license information.
+//
+
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef __MIP_DFA_H__
+#define __MIP_DFA_H__
+
+
+/* -------------------------------------------------------------------------- */
+
+#include "mip_unicode.h"
+#include "mip_blob.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include <type_traits>
+
+
+/* -------------------------------------------------------------------------- */
+
+namespace mip {
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ *  Deterministic automaton recognizing a set of patterns.
+ *
+ *  Patterns use a small regular expression syntax:
+ *    c        a literal character
+ *    .        any character
+ *    [a-z_]   a character class ([^...] for its complement)
+ *    \d \w \s digits, word characters, white spaces (\D \W \S complements)
+ *    \n \t \r \f \v control characters; any other escaped char is literal
+ *    (r)      grouping
+ *    r|s      alternation
+ *    r* r+ r? repetitions
+ *
+ *  Patterns are compiled into a NFA by add(), then build() turns the 
+ *  whole set into a single DFA so that scanning costs one table lookup
+ *  per character.
+ */
+class dfa_t {
+    friend class lexgen_t;
+
+public:
+    //! Invalid id
+    static const size_t npos = static_cast<size_t>(-1);
+
+    //! Add a pattern with a given id 
+    //! @return false if pattern syntax is invalid or it matches an empty 
+    //!         string
+    bool add(const string_t & pattern, size_t id);
+
+    //! Return true if a pattern is valid
+    static bool valid(const string_t & pattern);
+
+    //! Compile the patterns added into the DFA
+    //! @return true in case of success, false otherwise
+    bool build();
+
+    //! Remove all the patterns
+    void clear();
+
+    //! Serialize the built automaton
+    void save(blob_writer_t & out) const;
+
+    //! Restore an automaton serialized by save(): it is ready for 
+    //! matching, but no further pattern can be added
+    bool load(blob_reader_t & in);
+
+    //! Return true if there are no patterns
+    bool empty() const noexcept {
+        return _accept.empty();
+    }
+
+    /**
+     * Search the longest match of patterns at a given text position
+     * @param text is the text to match
+     * @param pos is the position of first character to match
+     * @param id will hold the id of matching pattern (the lowest one if 
+     *        several patterns match the same text)
+     * @return the length of matching text, 0 if no pattern matches
+     */
+    size_t match(const string_t & text, size_t pos, size_t & id) const noexcept {
+        if (_accept.empty()) {
+            return 0;
+        }
+
+        size_t state = 0;
+        size_t len = 0;
+
+        for (size_t i = pos; i < text.size(); ++i) {
+            const auto cl = _class(text[i]);
+
+            if (cl < 0) {
+                break;
+            }
+
+            const auto next = _trans[state * _class_cnt + cl];
+
+            if (next < 0) {
+                break;
+            }
+
+            state = static_cast<size_t>(next);
+
+            if (_accept[state] != npos) {
+                len = i + 1 - pos;
+                id = _accept[state];
+            }
+        }
+
+        return len;
+    }
+
+private:
+    using uchar_t = std::make_unsigned<char_t>::type;
+    using range_t = std::pair<uint32_t, uint32_t>;
+    using ranges_t = std::vector<range_t>;
+
+    struct nfa_state_t {
+        std::vector<size_t> eps;
+        ranges_t ranges;
+        size_t next = npos;
+        size_t accept = npos;
+    };
+
+    struct frag_t {
+        size_t begin;
+        size_t end;
+    };
+
+    class parser_t;
+
+    int32_t _class(char_t ch) const noexcept {
+        const auto uch = static_cast<uchar_t>(ch);
+
+        if (uch < _low_class.size()) {
+            return _low_class[uch];
+        }
+
+        return _high_class(static_cast<uint32_t>(uch));
+    }
+
+    int32_t _high_class(uint32_t ch) const noexcept;
+
+    void _closure(std::vector<size_t> & states) const;
+
+    std::vector<nfa_state_t> _nfa;
+    std::vector<size_t> _nfa_begin;
+
+    size_t _class_cnt = 0;
+    std::vector<uint32_t> _bounds;
+    std::array<int32_t, 256> _low_class;
+    std::vector<int32_t> _trans;
+    std::vector<size_t> _accept;
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+} // namespace mip
+
+
+/* -------------------------------------------------------------------------- */
+
+#endif // __MIP_DFA_H__
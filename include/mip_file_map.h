@@ -0,0 +1,75 @@
+//  
+// This file is part of MipTknzr Library Project
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.  
+// Licensed under the MIT License. 
+// See COPYING file in the project root for full license information.
+//
+
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef __MIP_FILE_MAP_H__
+#define __MIP_FILE_MAP_H__
+
+
+/* -------------------------------------------------------------------------- */
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+
+/* -------------------------------------------------------------------------- */
+
+namespace mip {
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ *  Read-only view of a whole file: the file is memory-mapped where 
+ *  supported (POSIX systems), otherwise it is read into memory
+ */
+class file_map_t {
+public:
+    file_map_t() = default;
+    file_map_t(const file_map_t&) = delete;
+    file_map_t& operator=(const file_map_t&) = delete;
+
+    ~file_map_t() {
+        close();
+    }
+
+    //! Map a given file; return false in case of error
+    bool open(const std::string & path);
+
+    //! Release the file
+    void close() noexcept;
+
+    //! Return the file content
+    const char * data() const noexcept {
+        return _data;
+    }
+
+    //! Return the file size
+    size_t size() const noexcept {
+        return _size;
+    }
+
+private:
+    const char * _data = nullptr;
+    size_t _size = 0;
+    bool _mapped = false;
+    std::vector<char> _buf;
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+} // namespace mip
+
+
+/* -------------------------------------------------------------------------- */
+
+#endif // __MIP_FILE_MAP_H__
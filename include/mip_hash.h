@@ -0,0 +1,99 @@
+//  
+// This file is part of MipTknzr Library Project
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.  
+// Licensed under the MIT License. 
+// See COPYING file in the project root for full license information.
+//
+
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef __MIP_HASH_H__
+#define __MIP_HASH_H__
+
+
+/* -------------------------------------------------------------------------- */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+
+/* -------------------------------------------------------------------------- */
+
+namespace mip {
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ *  Fast non-cryptographic 64-bit hash of a byte sequence, consuming 
+ *  a machine word per step; used to key cached and serialized data 
+ *  (e.g. by content and grammar)
+ */
+class hash64_t {
+public:
+    //! Return the hash of a given sequence of bytes
+    static uint64_t hash(
+        const void * data, 
+        size_t size, 
+        uint64_t seed = 0) noexcept 
+    {
+        const auto * p = static_cast<const unsigned char *>(data);
+        uint64_t h = seed ^ (size * _k1);
+
+        while (size >= sizeof(uint64_t)) {
+            uint64_t word;
+            std::memcpy(&word, p, sizeof(word));
+
+            h = _rotl(h ^ (word * _k2), 29) * _k1;
+
+            p += sizeof(uint64_t);
+            size -= sizeof(uint64_t);
+        }
+
+        uint64_t tail = 0;
+
+        for (size_t i = 0; i < size; ++i) {
+            tail |= uint64_t(p[i]) << (8 * i);
+        }
+
+        h = _rotl(h ^ (tail * _k2), 29) * _k1;
+
+        return _mix(h);
+    }
+
+    //! Combine a hash with another value
+    static uint64_t combine(uint64_t h, uint64_t value) noexcept {
+        return _mix(h ^ (value + _k1 + (h << 6) + (h >> 2)));
+    }
+
+private:
+    static const uint64_t _k1 = 0x9E3779B97F4A7C15ULL;
+    static const uint64_t _k2 = 0xC2B2AE3D27D4EB4FULL;
+
+    static uint64_t _rotl(uint64_t x, unsigned r) noexcept {
+        return (x << r) | (x >> (64 - r));
+    }
+
+    //! final avalanche
+    static uint64_t _mix(uint64_t h) noexcept {
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDULL;
+        h ^= h >> 33;
+        h *= 0xC4CEB9FE1A85EC53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+} // namespace mip
+
+
+/* -------------------------------------------------------------------------- */
+
+#endif // __MIP_HASH_H__
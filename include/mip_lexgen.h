@@ -0,0 +1,76 @@
+//  
+// This file is part of MipTknzr Library Project
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.  
+// Licensed under the MIT License. 
+// See COPYING file in the project root for full license information.
+//
+
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef __MIP_LEXGEN_H__
+#define __MIP_LEXGEN_H__
+
+
+/* -------------------------------------------------------------------------- */
+
+#include "mip_tknzr.h"
+
+#include <ostream>
+#include <string>
+
+
+/* -------------------------------------------------------------------------- */
+
+namespace mip {
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ *  Ahead-of-time scanner generator: turns the grammar of a tokenizer 
+ *  into the C++ source of a grammar policy for static_tknzr_t, with 
+ *  switch-based dispatch on the first character, inlined atom, keyword 
+ *  and comment comparisons and the pattern DFA as constant tables.
+ *
+ *  The generated source only depends on the library headers and 
+ *  declares a scanner class as an alias of static_tknzr_t, yielding the
+ *  same token stream as the tokenizer. The features not supported by 
+ *  static_tknzr_t are rejected.
+ */
+class lexgen_t {
+public:
+    /**
+     * Write the source of a scanner class
+     * @param tknzr is the tokenizer whose grammar is compiled
+     * @param class_name is the name of the generated class
+     * @param os is the output stream of the generated source
+     * @return false if the class name is not a valid identifier, if the 
+     *         grammar uses a feature not supported (see unsupported()) 
+     *         or on write error
+     */
+    static bool generate(
+        const tknzr_t & tknzr, 
+        const std::string & class_name, 
+        std::ostream & os);
+
+    //! Return the name of the first grammar feature which cannot be 
+    //! compiled, or an empty string
+    static std::string unsupported(const tknzr_t & tknzr);
+
+private:
+    static void _gen_start(std::ostream & os, const tknzr_t & tknzr);
+    static void _gen_patterns(std::ostream & os, const dfa_t & dfa);
+    static void _gen_quotes(std::ostream & os, const tknzr_t & tknzr);
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+} // namespace mip
+
+
+/* -------------------------------------------------------------------------- */
+
+#endif // __MIP_LEXGEN_H__
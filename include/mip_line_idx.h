@@ -0,0 +1,83 @@
+//  
+// This file is part of MipTknzr Library Project
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.  
+// Licensed under the MIT License. 
+// See COPYING file in the project root for full license information.
+//
+
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef __MIP_LINE_IDX_H__
+#define __MIP_LINE_IDX_H__
+
+
+/* -------------------------------------------------------------------------- */
+
+#include <algorithm>
+#include <vector>
+#include <cstddef>
+
+
+/* -------------------------------------------------------------------------- */
+
+namespace mip {
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Index of the text line starts, collected by the tokenizer while 
+//! reading the input, which resolves the line and column of an absolute
+//! token position (see tkn_view_t::pos) on demand
+class line_idx_t {
+public:
+    //! Record the absolute position of the next line start
+    void add(size_t start) {
+        _starts.push_back(start);
+    }
+
+    //! Return the number of the line containing the given position
+    size_t line(size_t pos) const noexcept {
+        auto it = std::upper_bound(_starts.begin(), _starts.end(), pos);
+        return it == _starts.begin() ? 0 : (it - _starts.begin()) - 1;
+    }
+
+    //! Return the offset of a position within its line
+    size_t column(size_t pos) const noexcept {
+        return _starts.empty() ? pos : pos - _starts[line(pos)];
+    }
+
+    //! Return the absolute position of a line start
+    size_t start(size_t line) const noexcept {
+        return line < _starts.size() ? _starts[line] : 0;
+    }
+
+    //! Return the number of indexed lines
+    size_t size() const noexcept {
+        return _starts.size();
+    }
+
+    //! Remove all the lines
+    void clear() noexcept {
+        _starts.clear();
+    }
+
+    //! Return the bytes of heap memory held
+    size_t mem_size() const noexcept {
+        return _starts.capacity() * sizeof(size_t);
+    }
+
+private:
+    std::vector<size_t> _starts;
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+} // namespace mip
+
+
+/* -------------------------------------------------------------------------- */
+
+#endif // __MIP_LINE_IDX_H__
@@ -0,0 +1,189 @@
+//  
+// This file is part of MipTknzr Library Project
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.  
+// Licensed under the MIT License. 
+// See COPYING file in the project root for full license information.
+//
+
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef __MIP_MEM_POOL_H__
+#define __MIP_MEM_POOL_H__
+
+
+/* -------------------------------------------------------------------------- */
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+
+/* -------------------------------------------------------------------------- */
+
+namespace mip {
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ *  Bytes of heap memory held by a tokenizer (see tknzr_t::mem_usage()), 
+ *  a token list builder or a memory pool, per kind of memory. 
+ *  Usages can be merged by using operator +=
+ */
+struct mem_usage_t
+{
+    //! Kinds of memory
+    enum class mem_t {
+        BUFFERS,    //!< text line buffers
+        VALUES,     //!< token value buffers (converted strings, comments)
+        INDEXES,    //!< line and bracket indexes, indentation levels
+        LISTS       //!< token lists (see tknlst_bldr_t)
+    };
+
+    //! number of kinds of memory
+    static const size_t mem_cnt = 4;
+
+    //! bytes per kind of memory
+    std::array<size_t, mem_cnt> bytes{};
+
+    //! Return bytes of a given kind of memory
+    size_t of(mem_t kind) const noexcept {
+        return bytes[static_cast<size_t>(kind)];
+    }
+
+    //! Return total bytes
+    size_t total() const noexcept {
+        size_t res = 0;
+
+        for (const auto & cnt : bytes) {
+            res += cnt;
+        }
+
+        return res;
+    }
+
+    //! Merge another usage
+    mem_usage_t& operator+=(const mem_usage_t& other) noexcept {
+        for (size_t k = 0; k < mem_cnt; ++k) {
+            bytes[k] += other.bytes[k];
+        }
+
+        return *this;
+    }
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ *  Memory accounting shared by several tokenizers and token list builders
+ *  (e.g. the sessions of a service), which charge the bytes they hold as 
+ *  they grow, against an optional hard limit, and release them when they 
+ *  shrink or are destroyed. A charge exceeding the limit is refused, so 
+ *  that the member requesting it fails (see tknzr_t::error_t::MEM_LIMIT). 
+ *  The pool can be shared among threads
+ */
+class mem_pool_t {
+public:
+    using mem_t = mem_usage_t::mem_t;
+
+    //! ctor
+    //! @param limit is the maximum number of bytes held (0 for no limit)
+    explicit mem_pool_t(size_t limit = 0) noexcept : _limit(limit) {
+        for (auto & cnt : _bytes) {
+            cnt = 0;
+        }
+    }
+
+    mem_pool_t(const mem_pool_t&) = delete;
+    mem_pool_t& operator=(const mem_pool_t&) = delete;
+
+    //! Set the maximum number of bytes held (0 for no limit), which only
+    //! applies to further charges
+    void set_limit(size_t limit) noexcept {
+        _limit = limit;
+    }
+
+    //! Return the maximum number of bytes held (0 for no limit)
+    size_t limit() const noexcept {
+        return _limit;
+    }
+
+    //! Charge bytes of a given kind of memory, unless the limit would be 
+    //! exceeded
+    //! @return false if the charge is refused
+    bool charge(mem_t kind, size_t bytes) noexcept {
+        const size_t limit = _limit;
+        size_t used = _used.load();
+
+        do {
+            if (limit && used + bytes > limit) {
+                ++_refused;
+                return false;
+            }
+        } 
+        while (!_used.compare_exchange_weak(used, used + bytes));
+
+        _bytes[static_cast<size_t>(kind)] += bytes;
+
+        size_t peak = _peak.load();
+
+        while (used + bytes > peak && 
+               !_peak.compare_exchange_weak(peak, used + bytes)) 
+        {
+        }
+
+        return true;
+    }
+
+    //! Release bytes of a given kind of memory previously charged
+    void release(mem_t kind, size_t bytes) noexcept {
+        _bytes[static_cast<size_t>(kind)] -= bytes;
+        _used -= bytes;
+    }
+
+    //! Return the bytes currently held per kind of memory
+    mem_usage_t usage() const noexcept {
+        mem_usage_t res;
+
+        for (size_t k = 0; k < mem_usage_t::mem_cnt; ++k) {
+            res.bytes[k] = _bytes[k];
+        }
+
+        return res;
+    }
+
+    //! Return the bytes currently held
+    size_t used() const noexcept {
+        return _used;
+    }
+
+    //! Return the highest number of bytes held
+    size_t peak() const noexcept {
+        return _peak;
+    }
+
+    //! Return the number of charges refused
+    size_t refused() const noexcept {
+        return _refused;
+    }
+
+private:
+    std::atomic<size_t> _limit;
+    std::atomic<size_t> _used { 0 };
+    std::atomic<size_t> _peak { 0 };
+    std::atomic<size_t> _refused { 0 };
+    std::array<std::atomic<size_t>, mem_usage_t::mem_cnt> _bytes;
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+} // namespace mip
+
+
+/* -------------------------------------------------------------------------- */
+
+#endif // __MIP_MEM_POOL_H__
@@ -0,0 +1,122 @@
+//  
+// This file is part of MipTknzr Library Project
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.  
+// Licensed under the MIT License. 
+// See COPYING file in the project root for full license information.
+//
+
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef __MIP_PHASH_H__
+#define __MIP_PHASH_H__
+
+
+/* -------------------------------------------------------------------------- */
+
+#include "mip_unicode.h"
+#include "mip_blob.h"
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+
+/* -------------------------------------------------------------------------- */
+
+namespace mip {
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ *  Static perfect hash table (hash and displace) mapping a set of strings 
+ *  to their ids. The table is generated once by build(), then a lookup 
+ *  costs one hash of the probed value and at most one string compare.
+ */
+class phash_t {
+public:
+    //! Invalid id
+    static const size_t npos = static_cast<size_t>(-1);
+
+    //! Generate the table for a map <key, id>
+    //! @return true in case of success, false otherwise
+    bool build(const std::map<string_t, size_t> & keys);
+
+    //! Return the id of a given value or npos if it is not a key
+    size_t find(const char_t * data, size_t size) const noexcept {
+        if (_slots.empty()) {
+            return npos;
+        }
+
+        const auto h = _hash(data, size, _salt);
+        const auto seed = _seeds[h % _seeds.size()];
+        const auto & slot = _slots[_slot(h, seed, _slots.size())];
+
+        if (slot.id != npos && 
+            slot.key.compare(0, slot.key.size(), data, size) == 0) 
+        {
+            return slot.id;
+        }
+
+        return npos;
+    }
+
+    //! Return true if the table has no keys
+    bool empty() const noexcept {
+        return _slots.empty();
+    }
+
+    //! Serialize the table
+    void save(blob_writer_t & out) const;
+
+    //! Restore a table serialized by save()
+    bool load(blob_reader_t & in);
+
+private:
+    struct slot_t {
+        string_t key;
+        size_t id = npos;
+    };
+
+    static uint64_t _hash(
+        const char_t * data, size_t size, uint64_t salt) noexcept 
+    {
+        // FNV-1a
+        uint64_t h = 14695981039346656037ULL ^ salt;
+
+        for (size_t i = 0; i < size; ++i) {
+            h ^= static_cast<uint64_t>(data[i]);
+            h *= 1099511628211ULL;
+        }
+
+        return h;
+    }
+
+    static size_t _slot(uint64_t h, uint32_t seed, size_t cnt) noexcept {
+        // splitmix64 finalizer
+        h ^= static_cast<uint64_t>(seed) * 0x9e3779b97f4a7c15ULL;
+        h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+        h ^= h >> 31;
+
+        return static_cast<size_t>(h % cnt);
+    }
+
+    bool _build(const std::map<string_t, size_t> & keys, uint64_t salt);
+
+    uint64_t _salt = 0;
+    std::vector<uint32_t> _seeds;
+    std::vector<slot_t> _slots;
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+} // namespace mip
+
+
+/* -------------------------------------------------------------------------- */
+
+#endif // __MIP_PHASH_H__
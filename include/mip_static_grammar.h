@@ -0,0 +1,655 @@
+//  
+// This file is part of MipTknzr Library Project
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.  
+// Licensed under the MIT License. 
+// See COPYING file in the project root for full license information.
+//
+
+
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef __MIP_STATIC_GRAMMAR_H__
+#define __MIP_STATIC_GRAMMAR_H__
+
+
+/* -------------------------------------------------------------------------- */
+
+#include "mip_static_tknzr.h"
+#include "mip_base_tknzr_bldr.h"
+#include "mip_esc_cnvrtr.h"
+
+#include <memory>
+#include <type_traits>
+
+
+/* -------------------------------------------------------------------------- */
+
+namespace mip {
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ *  Grammars declared at compile time: a static_grammar_t is a list of 
+ *  definition lists whose literals are constant arrays with linkage, e.g.
+ *
+ *  static constexpr char_t arrow[] = _T("->");
+ *  static constexpr char_t lpar[] = _T("(");
+ *  static constexpr char_t rpar[] = _T(")");
+ *  static constexpr char_t space[] = _T(" ");
+ *  static constexpr char_t slash2[] = _T("//");
+ *
+ *  using my_grammar_t = static_grammar_t<
+ *      atoms_t<arrow, lpar, rpar>,
+ *      blanks_t<space>,
+ *      sl_comments_t<slash2>,
+ *      strings_t<quote_t<_T('"'), _T('\\')>>,
+ *      eols_t<base_tknzr_t::eol_t::LF>>;
+ *
+ *  static_tknzr_t<my_grammar_t> tknzr;
+ *
+ *  Matching code is expanded from the lists, the tables are constant: 
+ *  tokens are the same of a tknzr_t whose definitions are given in the 
+ *  same order (see static_grammar_t::define()). Patterns are not 
+ *  supported.
+ */
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Return the length of a literal
+constexpr size_t _lit_len(const char_t * s, size_t n = 0) {
+    return s[n] ? _lit_len(s, n + 1) : n;
+}
+
+
+//! Return true if two literals are equal
+constexpr bool _lit_same(const char_t * a, const char_t * b) {
+    return *a == *b && (*a == 0 || _lit_same(a + 1, b + 1));
+}
+
+
+//! Return true if a text begins with the first n characters of a literal
+inline bool _lit_eq(const char_t * p, const char_t * s, size_t n) noexcept {
+    for (size_t i = 0; i < n; ++i) {
+        if (p[i] != s[i]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+//! True if no literal in a list is equal to another one or empty
+template <const char_t *... S> 
+struct _lit_distinct_t {
+    static constexpr bool value = true;
+};
+
+template <const char_t * H, const char_t *... T>
+struct _lit_distinct_t<H, T...> {
+    template <const char_t *... U> 
+    struct differ_t {
+        static constexpr bool value = true;
+    };
+
+    template <const char_t * V, const char_t *... U> 
+    struct differ_t<V, U...> {
+        static constexpr bool value = 
+            !_lit_same(H, V) && differ_t<U...>::value;
+    };
+
+    static constexpr bool value = 
+        H[0] != 0 && differ_t<T...>::value && _lit_distinct_t<T...>::value;
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Definition kinds
+struct _atom_kind_t {
+    static bool def(base_tknzr_bldr_t & bldr, const char_t * s, size_t id) {
+        return bldr.def_atom(s, id);
+    }
+};
+
+struct _keyword_kind_t {
+    static bool def(base_tknzr_bldr_t & bldr, const char_t * s, size_t id) {
+        return bldr.def_keyword(s, id);
+    }
+};
+
+struct _blank_kind_t {
+    static bool def(base_tknzr_bldr_t & bldr, const char_t * s, size_t id) {
+        return bldr.def_blank(s, id);
+    }
+};
+
+struct _sl_comment_kind_t {
+    static bool def(base_tknzr_bldr_t & bldr, const char_t * s, size_t id) {
+        return bldr.def_sl_comment(s, id);
+    }
+};
+
+struct _ml_comment_kind_t {};
+struct _string_kind_t {};
+struct _eol_kind_t {};
+struct _number_kind_t {};
+struct _blank_run_kind_t {};
+
+
+/* -------------------------------------------------------------------------- */
+
+//! List of literal definitions of a given kind, whose ids are their 
+//! positions in the list
+template <class Kind, const char_t *... S>
+struct _lit_list_t {
+    using kind = Kind;
+    using uchar_t = std::make_unsigned<char_t>::type;
+
+    static_assert(_lit_distinct_t<S...>::value, 
+        "definitions must be distinct and not empty");
+
+    //! Return true if a definition begins with a given character
+    static constexpr bool head(uchar_t ch) {
+        return _head<S...>(ch);
+    }
+
+    //! Return the length of the longest definition matching the text p 
+    //! (avail >= 1 characters) setting its id, or 0
+    static size_t match(const char_t * p, size_t avail, size_t & id) noexcept {
+        size_t len = 0;
+        size_t i = 0;
+
+        using expand_t = int[];
+        (void)expand_t{ 0, (_try(S, p, avail, i++, len, id), 0)... };
+        (void)p;
+        (void)avail;
+
+        return len;
+    }
+
+    //! Return the id of the definition equal to a text, or npos
+    static size_t find(const char_t * p, size_t size) noexcept {
+        size_t id = token_t::npos;
+        size_t i = 0;
+
+        using expand_t = int[];
+        (void)expand_t{ 0, (_find(S, p, size, i++, id), 0)... };
+        (void)p;
+        (void)size;
+
+        return id;
+    }
+
+    //! Define the list by means of a runtime builder
+    static bool define(base_tknzr_bldr_t & bldr) {
+        bool ok = true;
+        size_t i = 0;
+
+        using expand_t = int[];
+        (void)expand_t{ 0, (ok = Kind::def(bldr, S, i++) && ok, 0)... };
+        (void)bldr;
+
+        return ok;
+    }
+
+private:
+    template <class T = void>
+    static constexpr bool _head(uchar_t) {
+        return false;
+    }
+
+    template <const char_t * H, const char_t *... T>
+    static constexpr bool _head(uchar_t ch) {
+        return static_cast<uchar_t>(H[0]) == ch || _head<T...>(ch);
+    }
+
+    static void _try(
+        const char_t * s, 
+        const char_t * p, 
+        size_t avail, 
+        size_t i, 
+        size_t & len, 
+        size_t & id) noexcept
+    {
+        const size_t n = _lit_len(s);
+
+        if (n > len && n <= avail && _lit_eq(p, s, n)) {
+            len = n;
+            id = i;
+        }
+    }
+
+    static void _find(
+        const char_t * s, 
+        const char_t * p, 
+        size_t size, 
+        size_t i, 
+        size_t & id) noexcept
+    {
+        if (_lit_len(s) == size && _lit_eq(p, s, size)) {
+            id = i;
+        }
+    }
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Atom definitions
+template <const char_t *... S>
+using atoms_t = _lit_list_t<_atom_kind_t, S...>;
+
+//! Keyword definitions
+template <const char_t *... S>
+using keywords_t = _lit_list_t<_keyword_kind_t, S...>;
+
+//! Blank definitions
+template <const char_t *... S>
+using blanks_t = _lit_list_t<_blank_kind_t, S...>;
+
+//! Single-line comment prefixes
+template <const char_t *... S>
+using sl_comments_t = _lit_list_t<_sl_comment_kind_t, S...>;
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Multi-line comment delimiters
+template <const char_t * Begin, const char_t * End>
+struct ml_comment_t {
+    static_assert(Begin[0] != 0 && End[0] != 0, 
+        "comment delimiters must not be empty");
+};
+
+
+//! Multi-line comment definitions (their openers must be distinct)
+template <class... C>
+struct ml_comments_t;
+
+template <const char_t *... B, const char_t *... E>
+struct ml_comments_t<ml_comment_t<B, E>...> {
+    using kind = _ml_comment_kind_t;
+    using uchar_t = std::make_unsigned<char_t>::type;
+
+    static_assert(_lit_distinct_t<B...>::value, 
+        "comment openers must be distinct");
+
+    static constexpr bool head(uchar_t ch) {
+        return _lit_list_t<_ml_comment_kind_t, B...>::head(ch);
+    }
+
+    static size_t match(
+        const char_t * p, 
+        size_t avail, 
+        size_t & id, 
+        const char_t * & tail, 
+        size_t & tail_size) noexcept 
+    {
+        static const char_t * const tails[] = { E..., nullptr };
+
+        const size_t len = 
+            _lit_list_t<_ml_comment_kind_t, B...>::match(p, avail, id);
+
+        if (len) {
+            tail = tails[id];
+            tail_size = _lit_len(tail);
+        }
+
+        return len;
+    }
+
+    static bool define(base_tknzr_bldr_t & bldr) {
+        bool ok = true;
+        size_t i = 0;
+
+        using expand_t = int[];
+        (void)expand_t{ 0, (ok = bldr.def_ml_comment(B, E, i++) && ok, 0)... };
+        (void)bldr;
+
+        return ok;
+    }
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+//! String quote and its escape character (0 if escapes are not 
+//! converted; they are converted as by esc_cnvrtr_t otherwise)
+template <char_t Quote, char_t Esc = 0>
+struct quote_t {};
+
+
+//! String definitions (their quotes must be distinct)
+template <class... Q>
+struct strings_t;
+
+template <char_t... Q, char_t... E>
+struct strings_t<quote_t<Q, E>...> {
+    using kind = _string_kind_t;
+    using uchar_t = std::make_unsigned<char_t>::type;
+
+    static constexpr bool head(uchar_t ch) {
+        return _head<Q...>(ch);
+    }
+
+    static bool match(char_t ch, char_t & esc) noexcept {
+        bool found = false;
+
+        using expand_t = int[];
+        (void)expand_t{ 0, (_try(Q, E, ch, esc, found), 0)... };
+        (void)ch;
+        (void)esc;
+
+        return found;
+    }
+
+    static bool define(base_tknzr_bldr_t & bldr) {
+        bool ok = true;
+
+        using expand_t = int[];
+        (void)expand_t{ 0, (ok = bldr.def_string(Q, E ? 
+            std::make_shared<esc_cnvrtr_t>(E) : nullptr) && ok, 0)... };
+        (void)bldr;
+
+        return ok;
+    }
+
+private:
+    template <class T = void>
+    static constexpr bool _head(uchar_t) {
+        return false;
+    }
+
+    template <char_t H, char_t... T>
+    static constexpr bool _head(uchar_t ch) {
+        return static_cast<uchar_t>(H) == ch || _head<T...>(ch);
+    }
+
+    static void _try(
+        char_t quote, 
+        char_t quote_esc, 
+        char_t ch, 
+        char_t & esc, 
+        bool & found) noexcept
+    {
+        if (!found && quote == ch) {
+            esc = quote_esc;
+            found = true;
+        }
+    }
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+//! End-of-line definitions
+template <base_tknzr_t::eol_t... E>
+struct eols_t {
+    using kind = _eol_kind_t;
+
+    static constexpr bool has(base_tknzr_t::eol_t eol) {
+        return _has<E...>(eol);
+    }
+
+    static bool define(base_tknzr_bldr_t & bldr) {
+        bool ok = true;
+
+        using expand_t = int[];
+        (void)expand_t{ 0, (ok = bldr.def_eol(E) && ok, 0)... };
+        (void)bldr;
+
+        return ok;
+    }
+
+private:
+    template <class T = void>
+    static constexpr bool _has(base_tknzr_t::eol_t) {
+        return false;
+    }
+
+    template <base_tknzr_t::eol_t H, base_tknzr_t::eol_t... T>
+    static constexpr bool _has(base_tknzr_t::eol_t eol) {
+        return H == eol || _has<T...>(eol);
+    }
+};
+
+
+//! Number format definitions
+template <base_tknzr_t::num_t... N>
+struct numbers_t {
+    using kind = _number_kind_t;
+
+    static constexpr bool has(base_tknzr_t::num_t num) {
+        return _has<N...>(num);
+    }
+
+    static bool define(base_tknzr_bldr_t & bldr) {
+        bool ok = true;
+
+        using expand_t = int[];
+        (void)expand_t{ 0, (ok = bldr.def_number(N) && ok, 0)... };
+        (void)bldr;
+
+        return ok;
+    }
+
+private:
+    template <class T = void>
+    static constexpr bool _has(base_tknzr_t::num_t) {
+        return false;
+    }
+
+    template <base_tknzr_t::num_t H, base_tknzr_t::num_t... T>
+    static constexpr bool _has(base_tknzr_t::num_t num) {
+        return H == num || _has<T...>(num);
+    }
+};
+
+
+//! Merge consecutive blanks (see base_tknzr_bldr_t::def_blank_run())
+struct blank_run_t {
+    using kind = _blank_run_kind_t;
+
+    static bool define(base_tknzr_bldr_t & bldr) {
+        return bldr.def_blank_run();
+    }
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Select the definition list of a given kind (or a default one)
+template <class Kind, class Default, class... Defs>
+struct _select_def_t {
+    using type = Default;
+    static const size_t count = 0;
+};
+
+template <class Kind, class Default, class D, class... Defs>
+struct _select_def_t<Kind, Default, D, Defs...> {
+    using next_t = _select_def_t<Kind, Default, Defs...>;
+    static const bool match = std::is_same<typename D::kind, Kind>::value;
+
+    using type = typename std::conditional<
+        match, D, typename next_t::type>::type;
+
+    static const size_t count = next_t::count + (match ? 1 : 0);
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Character set of a table (see static_grammar_t::is_start())
+struct _char_set_t {
+    bool value[256];
+};
+
+template <size_t... I> 
+struct _idx_seq_t {};
+
+template <size_t N, size_t... I>
+struct _make_idx_seq_t : _make_idx_seq_t<N - 1, N - 1, I...> {};
+
+template <size_t... I>
+struct _make_idx_seq_t<0, I...> {
+    using type = _idx_seq_t<I...>;
+};
+
+
+//! Characters which can begin any token but an other one
+template <class MlComments, class Blanks, class SlComments, class Atoms, 
+          class Strings, bool Digits, bool Dot>
+struct _start_set_t {
+    using uchar_t = std::make_unsigned<char_t>::type;
+
+    static constexpr bool starts(uchar_t ch) {
+        return MlComments::head(ch) || Blanks::head(ch) || 
+            SlComments::head(ch) || Atoms::head(ch) || Strings::head(ch) ||
+            (Digits && ch >= '0' && ch <= '9') || (Dot && ch == '.');
+    }
+
+    template <size_t... I>
+    static constexpr _char_set_t make(_idx_seq_t<I...>) {
+        return _char_set_t{ { starts(static_cast<uchar_t>(I))... } };
+    }
+
+    static constexpr _char_set_t value = 
+        make(typename _make_idx_seq_t<256>::type());
+};
+
+template <class MlComments, class Blanks, class SlComments, class Atoms, 
+          class Strings, bool Digits, bool Dot>
+constexpr _char_set_t _start_set_t<
+    MlComments, Blanks, SlComments, Atoms, Strings, Digits, Dot>::value;
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ *  Grammar policy of static_tknzr_t declared by a list of definitions:
+ *  atoms_t, keywords_t, blanks_t, sl_comments_t, ml_comments_t, 
+ *  strings_t, eols_t, numbers_t and blank_run_t, each given at most once
+ */
+template <class... Defs>
+struct static_grammar_t {
+    using uchar_t = std::make_unsigned<char_t>::type;
+
+    using atoms = typename _select_def_t<
+        _atom_kind_t, atoms_t<>, Defs...>::type;
+    using keywords = typename _select_def_t<
+        _keyword_kind_t, keywords_t<>, Defs...>::type;
+    using blanks = typename _select_def_t<
+        _blank_kind_t, blanks_t<>, Defs...>::type;
+    using sl_comments = typename _select_def_t<
+        _sl_comment_kind_t, sl_comments_t<>, Defs...>::type;
+    using ml_comments = typename _select_def_t<
+        _ml_comment_kind_t, ml_comments_t<>, Defs...>::type;
+    using strings = typename _select_def_t<
+        _string_kind_t, strings_t<>, Defs...>::type;
+    using eols = typename _select_def_t<
+        _eol_kind_t, eols_t<>, Defs...>::type;
+    using numbers = typename _select_def_t<
+        _number_kind_t, numbers_t<>, Defs...>::type;
+
+    static const bool has_blank_run = _select_def_t<
+        _blank_run_kind_t, void, Defs...>::count > 0;
+
+    static_assert(
+        _select_def_t<_atom_kind_t, void, Defs...>::count <= 1 &&
+        _select_def_t<_keyword_kind_t, void, Defs...>::count <= 1 &&
+        _select_def_t<_blank_kind_t, void, Defs...>::count <= 1 &&
+        _select_def_t<_sl_comment_kind_t, void, Defs...>::count <= 1 &&
+        _select_def_t<_ml_comment_kind_t, void, Defs...>::count <= 1 &&
+        _select_def_t<_string_kind_t, void, Defs...>::count <= 1 &&
+        _select_def_t<_eol_kind_t, void, Defs...>::count <= 1 &&
+        _select_def_t<_number_kind_t, void, Defs...>::count <= 1 &&
+        _select_def_t<_blank_run_kind_t, void, Defs...>::count <= 1,
+        "each kind of definition list must be given at most once");
+
+    static constexpr bool eol_cr = eols::has(base_tknzr_t::eol_t::CR);
+    static constexpr bool eol_lf = eols::has(base_tknzr_t::eol_t::LF);
+    static constexpr bool blank_run = has_blank_run;
+    static constexpr bool num_dec = numbers::has(base_tknzr_t::num_t::DEC);
+    static constexpr bool num_hex = numbers::has(base_tknzr_t::num_t::HEX);
+    static constexpr bool num_oct = numbers::has(base_tknzr_t::num_t::OCT);
+    static constexpr bool num_bin = numbers::has(base_tknzr_t::num_t::BIN);
+    static constexpr bool num_float = numbers::has(base_tknzr_t::num_t::FLOAT);
+
+    static bool is_start(char_t ch) noexcept {
+        using start_t = _start_set_t<ml_comments, blanks, sl_comments, 
+            atoms, strings, num_dec || num_hex || num_oct || num_bin || 
+            num_float, num_float>;
+
+        const size_t uch = static_cast<uchar_t>(ch);
+        return (uch >> 8) != 0 || start_t::value.value[uch];
+    }
+
+    static size_t match_ml_comment(
+        const char_t * p, 
+        size_t avail, 
+        size_t & id, 
+        const char_t * & tail, 
+        size_t & tail_size) noexcept 
+    {
+        return ml_comments::match(p, avail, id, tail, tail_size);
+    }
+
+    static size_t match_blank(
+        const char_t * p, size_t avail, size_t & id) noexcept 
+    {
+        return blanks::match(p, avail, id);
+    }
+
+    static size_t match_sl_comment(
+        const char_t * p, size_t avail, size_t & id) noexcept 
+    {
+        return sl_comments::match(p, avail, id);
+    }
+
+    static size_t match_atom(
+        const char_t * p, size_t avail, size_t & id) noexcept 
+    {
+        return atoms::match(p, avail, id);
+    }
+
+    static size_t match_pattern(const char_t *, size_t, size_t &) noexcept {
+        return 0;
+    }
+
+    static size_t match_keyword(const char_t * p, size_t size) noexcept {
+        return keywords::find(p, size);
+    }
+
+    static bool match_quote(char_t ch, char_t & esc) noexcept {
+        return strings::match(ch, esc);
+    }
+
+    //! Add the same definitions to a runtime builder, so that it builds 
+    //! a tokenizer yielding the same tokens
+    static bool define(base_tknzr_bldr_t & bldr) {
+        bool ok = true;
+
+        using expand_t = int[];
+        (void)expand_t{ 0, (ok = Defs::define(bldr) && ok, 0)... };
+        (void)bldr;
+
+        return ok;
+    }
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+} // namespace mip
+
+
+/* -------------------------------------------------------------------------- */
+
+#endif // __MIP_STATIC_GRAMMAR_H__
@@ -0,0 +1,913 @@
+//  
+// This file is part of MipTknzr Library Project
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.  
+// Licensed under the MIT License. 
+// See COPYING file in the project root for full license information.
+//
+
+
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef __MIP_STATIC_TKNZR_H__
+#define __MIP_STATIC_TKNZR_H__
+
+
+/* -------------------------------------------------------------------------- */
+
+#include "mip_base_tknzr.h"
+#include "mip_tkn_view.h"
+#include "mip_tkn_sink.h"
+
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+
+/* -------------------------------------------------------------------------- */
+
+namespace mip {
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ *  Tokenizer specialized at compile time for a grammar G, yielding the 
+ *  same token stream as a tknzr_t built with the same definitions, with
+ *  no set or map lookup and no virtual call on its scanning path.
+ *
+ *  G is declared by means of static_grammar_t (see mip_static_grammar.h)
+ *  or generated by lexgen_t, and provides as static members:
+ *    eol_cr, eol_lf       end-of-line characters (see eol_t)
+ *    blank_run            consecutive blanks are merged
+ *    num_dec, num_hex, num_oct, num_bin, num_float   number formats
+ *    is_start(ch)         false if ch cannot begin any token but an 
+ *                         other one
+ *    match_blank(p, avail, id), match_sl_comment(p, avail, id),
+ *    match_atom(p, avail, id), match_pattern(p, avail, id),
+ *    match_ml_comment(p, avail, id, tail, tail_size)
+ *                         length of the longest definition matching the
+ *                         text p (avail >= 1 characters) or 0, setting 
+ *                         its id (and multi-line comment terminator)
+ *    match_keyword(p, size) id of the keyword spelled by p or npos
+ *    match_quote(ch, esc) true if ch opens a string, setting its escape
+ *                         character (0 if escapes are not converted)
+ *
+ *  Symbol tables, windowed scanning, indentation, bracket and line 
+ *  indexes, UTF-8 validation and comment modes other than VALUE are not 
+ *  supported.
+ */
+template <class G>
+class static_tknzr_t : public base_tknzr_t
+{
+public:
+    using grammar_t = G;
+
+    //! Return next token found in a given input stream
+    std::unique_ptr<token_t> next(_istream & is) override {
+        tkn_view_t tkn;
+
+        if (!scan(is, tkn)) {
+            return nullptr;
+        }
+
+        return std::unique_ptr<token_t>(new token_t(
+            tkn.type,
+            tkn.value(),
+            tkn.line,
+            tkn.offset,
+            tkn.quote,
+            tkn.esc,
+            tkn.sym,
+            tkn.id,
+            tkn.num,
+            tkn.index,
+            tkn.pos,
+            tkn.end,
+            tkn.width));
+    }
+
+    //! Return true if there is no more data to process
+    bool eos(_istream & is) override {
+        if (_pos >= _line.size() &&
+            _other_pos == string_t::npos &&
+            _eol.empty())
+        {
+            return is.eof();
+        }
+
+        return false;
+    }
+
+    //! Scan the input stream up to its end collecting statistics
+    bool stats(_istream & is, tknzr_stats_t & st) override {
+        const size_t first_line = _line_number;
+
+        return tokenize(is, [&](const tkn_view_t & tkn) {
+            st.count(tkn.type, tkn.size);
+
+            if (tkn.type == tcl_t::END_OF_FILE) {
+                st.lines += tkn.line + 1 - first_line;
+            }
+        });
+    }
+
+    //! Scan next token without building any token object
+    //! (see tknzr_t::scan())
+    bool scan(_istream & is, tkn_view_t & tkn) {
+        if (!_scan_tkn(is, tkn)) {
+            reset();
+            return false;
+        }
+
+        tkn.index = _tkn_index;
+
+        // end-of-file token is repeated on any further call
+        if (tkn.type != tcl_t::END_OF_FILE) {
+            ++_tkn_index;
+        }
+
+        return true;
+    }
+
+    //! Deliver each token to a sink (see tknzr_t::tokenize())
+    template <class Sink>
+    bool tokenize(_istream & is, Sink && sink) {
+        tkn_view_t tkn;
+
+        do {
+            if (!scan(is, tkn)) {
+                return false;
+            }
+
+            if (!tkn_deliver(sink, tkn)) {
+                break;
+            }
+        }
+        while (tkn.type != tcl_t::END_OF_FILE);
+
+        return true;
+    }
+
+    //! Reset the scanning state
+    void reset() {
+        _line.clear();
+        _eol.clear();
+        _pos = 0;
+        _other_pos = string_t::npos;
+        _line_number = 0;
+        _eof = false;
+        _tkn_index = 0;
+        _line_start = 0;
+        _next_line_start = 0;
+    }
+
+private:
+    using tcl_t = token_t::tcl_t;
+
+    static const bool _has_numbers = G::num_dec || G::num_hex || 
+        G::num_oct || G::num_bin || G::num_float;
+
+    string_t _line;
+    string_t _eol;
+    string_t _value;
+    size_t _pos = 0;
+    size_t _other_pos = string_t::npos;
+    size_t _line_number = 0;
+    bool _eof = false;
+    size_t _tkn_index = 0;
+    size_t _line_start = 0;
+    size_t _next_line_start = 0;
+
+    bool _read_line(_istream & is) {
+        using traits_t = _istream::traits_type;
+
+        _line.clear();
+        _eof = is.eof();
+
+        auto sb = is.rdbuf();
+
+        if (!sb) {
+            is.setstate(std::ios_base::badbit);
+            return false;
+        }
+
+        if (_eof || is.bad()) {
+            return false;
+        }
+
+        while (true) {
+            const auto ich = sb->sbumpc();
+
+            if (traits_t::eq_int_type(ich, traits_t::eof())) {
+                is.setstate(std::ios_base::eofbit | std::ios_base::failbit);
+                _eof = true;
+                _eol.clear();
+                break;
+            }
+
+            const char_t ch = traits_t::to_char_type(ich);
+
+            if (ch == 0) {
+                _eof = true;
+                _eol.clear();
+                break;
+            }
+
+            if (G::eol_cr && ch == _T('\r')) {
+                _eol = _T("\r");
+                break;
+            }
+
+            if (G::eol_lf && ch == _T('\n')) {
+                _eol = _T("\n");
+                break;
+            }
+
+            _line.push_back(ch);
+        }
+
+        _line_start = _next_line_start;
+        _next_line_start += _line.size() + _eol.size();
+        _pos = 0;
+
+        return true;
+    }
+
+    void _set_tkn(
+        tkn_view_t & tkn,
+        tcl_t type,
+        const char_t * data,
+        size_t size,
+        size_t offset) const noexcept
+    {
+        tkn.type = type;
+        tkn.data = data;
+        tkn.size = size;
+        tkn.line = _line_number;
+        tkn.offset = offset;
+        tkn.pos = _line_start + offset;
+        tkn.end = tkn.pos + size;
+        tkn.quote = 0;
+        tkn.esc = 0;
+        tkn.sym = token_t::npos;
+        tkn.id = token_t::npos;
+        tkn.num = numval_t();
+        tkn.width = 0;
+    }
+
+    void _classify(tkn_view_t & tkn) const noexcept {
+        const size_t id = G::match_keyword(tkn.data, tkn.size);
+
+        if (id != token_t::npos) {
+            tkn.type = tcl_t::KEYWORD;
+            tkn.id = id;
+        }
+    }
+
+    bool _search_other_tkn(tkn_view_t & tkn) {
+        if (_other_pos == string_t::npos) {
+            return false;
+        }
+
+        _set_tkn(
+            tkn,
+            tcl_t::OTHER,
+            _line.data() + _other_pos,
+            _pos - _other_pos,
+            _other_pos);
+
+        _other_pos = string_t::npos;
+
+        _classify(tkn);
+
+        return true;
+    }
+
+    bool _get_comment(
+        _istream & is,
+        tkn_view_t & tkn,
+        size_t len,
+        size_t id,
+        const char_t * tail,
+        size_t tail_size)
+    {
+        const size_t comment_line = _line_number;
+        const size_t comment_offset = _pos;
+        const size_t comment_pos = _line_start + _pos;
+
+        size_t end_offset = _line.find(tail, _pos + len, tail_size);
+
+        if (end_offset != string_t::npos) {
+            const size_t size = end_offset + tail_size - _pos;
+
+            _set_tkn(tkn, tcl_t::COMMENT, _line.data() + _pos, size, _pos);
+            tkn.id = id;
+            _pos += size;
+
+            return true;
+        }
+
+        _value.assign(_line, _pos, string_t::npos);
+        _pos = _line.size();
+
+        while (end_offset == string_t::npos) {
+            _value += _eol;
+
+            // unterminated comment
+            if (_eof) {
+                return false;
+            }
+
+            ++_line_number;
+
+            if (!_read_line(is)) {
+                return false;
+            }
+
+            end_offset = _line.find(tail, 0, tail_size);
+
+            if (end_offset == string_t::npos) {
+                _value += _line;
+                _pos = _line.size();
+            }
+        }
+
+        const size_t end_pos = end_offset + tail_size;
+
+        _value.append(_line, _pos, end_pos - _pos);
+        _pos = end_pos;
+
+        _set_tkn(tkn, tcl_t::COMMENT, _value.data(), _value.size(), 0);
+
+        tkn.line = comment_line;
+        tkn.offset = comment_offset;
+        tkn.pos = comment_pos;
+        tkn.end = _line_start + end_pos;
+        tkn.id = id;
+
+        return true;
+    }
+
+    //! Convert an escape sequence (same conversions as esc_cnvrtr_t)
+    static bool _convert(
+        const char_t * s,
+        size_t n,
+        size_t & rcnt,
+        char_t & ch) noexcept
+    {
+        if (n <= 1) {
+            return false;
+        }
+
+        const char_t prefix = s[1];
+        rcnt = 2;
+
+        switch (prefix) {
+        case _T('\''):
+        case _T('"'):
+        case _T('\\'):
+            ch = prefix;
+            return true;
+        case _T('n'):
+            ch = _T('\n');
+            return true;
+        case _T('r'):
+            ch = _T('\r');
+            return true;
+        case _T('t'):
+            ch = _T('\t');
+            return true;
+        case _T('b'):
+            ch = _T('\b');
+            return true;
+        case _T('f'):
+            ch = _T('\f');
+            return true;
+        default:
+            break;
+        }
+
+        // octal: all the (up to 3) digits must be octal
+        if (n >= 3 && prefix >= _T('0') && prefix <= _T('7')) {
+            const size_t cnt = n - 1 < 3 ? n - 1 : 3;
+            unsigned res = 0;
+
+            for (size_t i = 0; i < cnt; ++i) {
+                const char_t digit = s[1 + i];
+
+                if (digit < _T('0') || digit > _T('7')) {
+                    return false;
+                }
+
+                res += (digit - _T('0')) << (3 * (cnt - i - 1));
+            }
+
+            ch = static_cast<char_t>(res);
+            rcnt = cnt + 1;
+
+            return true;
+        }
+
+        // hexadecimal: digits 0-9, a-e, value fitting an int
+        if (n >= 3 && (prefix == _T('x') || prefix == _T('X'))) {
+            uint64_t res = 0;
+            size_t cnt = 0;
+
+            for (; 2 + cnt < n; ++cnt) {
+                const char_t digit = s[2 + cnt];
+                unsigned value = 0;
+
+                if (digit >= _T('0') && digit <= _T('9')) {
+                    value = digit - _T('0');
+                }
+                else if (digit >= _T('a') && digit < _T('f')) {
+                    value = digit - _T('a') + 10;
+                }
+                else if (digit >= _T('A') && digit < _T('F')) {
+                    value = digit - _T('A') + 10;
+                }
+                else {
+                    break;
+                }
+
+                if (res <= 0x7fffffff) {
+                    res = res * 16 + value;
+                }
+            }
+
+            if (cnt == 0 || res > 0x7fffffff) {
+                return false;
+            }
+
+            ch = static_cast<char_t>(res);
+            rcnt = cnt + 2;
+
+            return true;
+        }
+
+        return false;
+    }
+
+    bool _get_string(tkn_view_t & tkn) {
+        const size_t size = _line.size();
+
+        if (size - _pos < 2) {
+            return false;
+        }
+
+        const char_t quote_ch = _line[_pos];
+        char_t esc_ch = 0;
+
+        if (!G::match_quote(quote_ch, esc_ch)) {
+            return false;
+        }
+
+        if (size - _pos == 2 && _line[_pos + 1] != quote_ch) {
+            return false;
+        }
+
+        _value.clear();
+
+        for (size_t i = _pos + 1; i < size; ++i) {
+            char_t ch = _line[i];
+
+            if (esc_ch && ch == esc_ch) {
+                size_t remove_cnt = 0;
+
+                if (!_convert(_line.data() + i, size - i, remove_cnt, ch)) {
+                    return false;
+                }
+
+                i += remove_cnt - 1;
+            }
+            else if (ch == quote_ch) {
+                if (_search_other_tkn(tkn)) {
+                    return true;
+                }
+
+                _set_tkn(
+                    tkn,
+                    tcl_t::STRING,
+                    _value.data(),
+                    _value.size(),
+                    _pos);
+
+                tkn.end = _line_start + i + 1;
+                tkn.quote = quote_ch;
+                tkn.esc = esc_ch;
+                _pos = i + 1;
+
+                return true;
+            }
+
+            _value.push_back(ch);
+        }
+
+        return false;
+    }
+
+    static bool _parse_integer(
+        const string_t & text,
+        size_t begin,
+        size_t end,
+        unsigned base,
+        numval_t & num) noexcept
+    {
+        const uint64_t max_value = static_cast<uint64_t>(-1);
+
+        num.floating = false;
+        num.overflow = false;
+        num.integer = 0;
+
+        for (size_t i = begin; i < end; ++i) {
+            const char_t ch = text[i];
+            unsigned digit = 0;
+
+            if (ch >= _T('0') && ch <= _T('9')) {
+                digit = ch - _T('0');
+            }
+            else if (ch >= _T('a') && ch <= _T('f')) {
+                digit = ch - _T('a') + 10;
+            }
+            else if (ch >= _T('A') && ch <= _T('F')) {
+                digit = ch - _T('A') + 10;
+            }
+            else {
+                return false;
+            }
+
+            if (digit >= base) {
+                return false;
+            }
+
+            if (!num.overflow && num.integer > (max_value - digit) / base) {
+                num.overflow = true;
+                num.integer = max_value;
+            }
+
+            if (!num.overflow) {
+                num.integer = num.integer * base + digit;
+            }
+        }
+
+        return true;
+    }
+
+    static void _parse_real(
+        const string_t & text,
+        size_t begin,
+        size_t end,
+        numval_t & num)
+    {
+        char buf[64];
+        std::string big;
+
+        const size_t size = end - begin;
+        char * str = buf;
+
+        if (size >= sizeof(buf)) {
+            big.resize(size);
+            str = &big[0];
+        }
+
+        for (size_t i = 0; i < size; ++i) {
+            str[i] = static_cast<char>(text[begin + i]);
+        }
+
+        str[size] = 0;
+
+        errno = 0;
+
+        num.floating = true;
+        num.real = std::strtod(str, nullptr);
+        num.overflow = errno == ERANGE && std::fabs(num.real) == HUGE_VAL;
+        num.integer = 0;
+    }
+
+    size_t _scan_number(numval_t & num) const {
+        const auto & text = _line;
+        const size_t begin = _pos;
+        const size_t n = text.size();
+
+        auto is_digit = [](char_t ch) {
+            return ch >= _T('0') && ch <= _T('9');
+        };
+
+        auto is_xdigit = [&](char_t ch) {
+            return is_digit(ch) ||
+                (ch >= _T('a') && ch <= _T('f')) ||
+                (ch >= _T('A') && ch <= _T('F'));
+        };
+
+        // prefixed integers
+        if (text[begin] == _T('0') && begin + 2 < n) {
+            const char_t prefix = text[begin + 1];
+
+            if (G::num_hex && (prefix == _T('x') || prefix == _T('X')) &&
+                is_xdigit(text[begin + 2]))
+            {
+                size_t end = begin + 2;
+
+                while (end < n && is_xdigit(text[end])) {
+                    ++end;
+                }
+
+                _parse_integer(text, begin + 2, end, 16, num);
+                return end - begin;
+            }
+
+            if (G::num_bin && (prefix == _T('b') || prefix == _T('B')) &&
+                (text[begin + 2] == _T('0') || text[begin + 2] == _T('1')))
+            {
+                size_t end = begin + 2;
+
+                while (end < n &&
+                       (text[end] == _T('0') || text[end] == _T('1')))
+                {
+                    ++end;
+                }
+
+                _parse_integer(text, begin + 2, end, 2, num);
+                return end - begin;
+            }
+        }
+
+        // decimal integer part
+        size_t end = begin;
+
+        while (end < n && is_digit(text[end])) {
+            ++end;
+        }
+
+        const size_t int_end = end;
+        bool floating = false;
+
+        if (G::num_float) {
+            // fraction
+            if (end < n && text[end] == _T('.') &&
+                (end > begin || (end + 1 < n && is_digit(text[end + 1]))))
+            {
+                ++end;
+
+                while (end < n && is_digit(text[end])) {
+                    ++end;
+                }
+
+                floating = true;
+            }
+
+            // exponent
+            if (end > begin && end < n &&
+                (text[end] == _T('e') || text[end] == _T('E')))
+            {
+                size_t exp = end + 1;
+
+                if (exp < n && (text[exp] == _T('+') || text[exp] == _T('-'))) {
+                    ++exp;
+                }
+
+                if (exp < n && is_digit(text[exp])) {
+                    while (exp < n && is_digit(text[exp])) {
+                        ++exp;
+                    }
+
+                    end = exp;
+                    floating = true;
+                }
+            }
+        }
+
+        if (end == begin) {
+            return 0;
+        }
+
+        if (floating) {
+            _parse_real(text, begin, end, num);
+            return end - begin;
+        }
+
+        // octal integer
+        if (G::num_oct && text[begin] == _T('0') && int_end - begin > 1) {
+            size_t oct_end = begin + 1;
+
+            while (oct_end < int_end &&
+                   text[oct_end] >= _T('0') && text[oct_end] <= _T('7'))
+            {
+                ++oct_end;
+            }
+
+            if (oct_end == int_end || !G::num_dec) {
+                _parse_integer(text, begin + 1, oct_end, 8, num);
+                return oct_end - begin;
+            }
+        }
+
+        if (G::num_dec ||
+            (G::num_oct && int_end - begin == 1 && text[begin] == _T('0')))
+        {
+            _parse_integer(text, begin, int_end, 10, num);
+            return int_end - begin;
+        }
+
+        if (G::num_float) {
+            _parse_real(text, begin, int_end, num);
+            return int_end - begin;
+        }
+
+        return 0;
+    }
+
+    bool _scan_tkn(_istream & is, tkn_view_t & tkn) {
+        is.unsetf(std::ios_base::skipws);
+
+        while (true) {
+            const size_t size = _line.size();
+
+            if (_pos >= size) {
+                // other token
+                if (_search_other_tkn(tkn)) {
+                    return true;
+                }
+
+                // end-of-line token
+                if (!_eol.empty()) {
+                    _value = _eol;
+
+                    _set_tkn(
+                        tkn,
+                        tcl_t::END_OF_LINE,
+                        _value.data(),
+                        _value.size(),
+                        _pos);
+
+                    ++_line_number;
+                    _eol.clear();
+
+                    return true;
+                }
+
+                // end-of-file (virtual) token
+                if (_eof) {
+                    _set_tkn(
+                        tkn,
+                        tcl_t::END_OF_FILE,
+                        _eol.data(),
+                        _eol.size(),
+                        _pos);
+
+                    return true;
+                }
+
+                if (!_read_line(is)) {
+                    return false;
+                }
+
+                continue;
+            }
+
+            const char_t * const text = _line.data();
+
+            // characters which cannot begin any token extend other token
+            if (!G::is_start(text[_pos])) {
+                if (_other_pos == string_t::npos) {
+                    _other_pos = _pos;
+                }
+
+                do {
+                    ++_pos;
+                }
+                while (_pos < size && !G::is_start(text[_pos]));
+
+                continue;
+            }
+
+            const char_t * const p = text + _pos;
+            const size_t avail = size - _pos;
+            size_t id = token_t::npos;
+            size_t len = 0;
+
+            // multi-line comment
+            const char_t * tail = nullptr;
+            size_t tail_size = 0;
+
+            if ((len = G::match_ml_comment(p, avail, id, tail, tail_size)) != 0) {
+                if (_search_other_tkn(tkn)) {
+                    return true;
+                }
+
+                return _get_comment(is, tkn, len, id, tail, tail_size);
+            }
+
+            // blank
+            if ((len = G::match_blank(p, avail, id)) != 0) {
+                if (_search_other_tkn(tkn)) {
+                    return true;
+                }
+
+                if (G::blank_run) {
+                    size_t next_id = 0;
+                    size_t next = 0;
+
+                    while (len < avail &&
+                           (next = G::match_blank(p + len, avail - len, next_id)) != 0)
+                    {
+                        len += next;
+                    }
+                }
+
+                _set_tkn(tkn, tcl_t::BLANK, p, len, _pos);
+                tkn.id = id;
+                _pos += len;
+
+                return true;
+            }
+
+            // single-line comment
+            if (G::match_sl_comment(p, avail, id) != 0) {
+                if (_search_other_tkn(tkn)) {
+                    return true;
+                }
+
+                _set_tkn(tkn, tcl_t::COMMENT, p, avail, _pos);
+                tkn.id = id;
+                _pos = size;
+
+                return true;
+            }
+
+            size_t atom_id = token_t::npos;
+            const size_t atom_len = G::match_atom(p, avail, atom_id);
+
+            size_t pat_id = token_t::npos;
+            const size_t pat_len = G::match_pattern(p, avail, pat_id);
+
+            // number (if longer than any atom or pattern)
+            if (_has_numbers && _other_pos == string_t::npos) {
+                numval_t num;
+                len = _scan_number(num);
+
+                if (len > 0 && pat_len <= len && atom_len < len) {
+                    _set_tkn(tkn, tcl_t::NUMBER, p, len, _pos);
+                    tkn.num = num;
+                    _pos += len;
+
+                    return true;
+                }
+            }
+
+            // pattern (if longer than any atom)
+            if (pat_len > atom_len) {
+                if (_search_other_tkn(tkn)) {
+                    return true;
+                }
+
+                _set_tkn(tkn, tcl_t::PATTERN, p, pat_len, _pos);
+                tkn.id = pat_id;
+                _pos += pat_len;
+
+                _classify(tkn);
+
+                return true;
+            }
+
+            // atomic token
+            if (atom_len > 0) {
+                if (_search_other_tkn(tkn)) {
+                    return true;
+                }
+
+                _set_tkn(tkn, tcl_t::ATOM, p, atom_len, _pos);
+                tkn.id = atom_id;
+                _pos += atom_len;
+
+                return true;
+            }
+
+            // string
+            if (_get_string(tkn)) {
+                return true;
+            }
+
+            // append to other token
+            if (_other_pos == string_t::npos) {
+                _other_pos = _pos;
+            }
+
+            ++_pos;
+        }
+    }
+};
+
+/* -------------------------------------------------------------------------- */
+
+} // namespace mip
+
+
+/* -------------------------------------------------------------------------- */
+
+#endif // __MIP_STATIC_TKNZR_H__
@@ -0,0 +1,106 @@
+//  
+// This file is part of MipTknzr Library Project
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.  
+// Licensed under the MIT License. 
+// See COPYING file in the project root for full license information.
+//
+
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef __MIP_SYMTBL_H__
+#define __MIP_SYMTBL_H__
+
+
+/* -------------------------------------------------------------------------- */
+
+#include "mip_unicode.h"
+
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <unordered_map>
+
+
+/* -------------------------------------------------------------------------- */
+
+namespace mip {
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ *  Symbol table which interns token values assigning them dense ids 
+ *  (0, 1, 2, ...). A table can be shared by several tokenizers, also 
+ *  running in parallel threads: lookups are partitioned in shards, each 
+ *  one protected by its own mutex. Interning an already known value 
+ *  costs a hash probe and no allocation.
+ */
+class symtbl_t {
+public:
+    //! Invalid symbol id
+    static const size_t npos = static_cast<size_t>(-1);
+
+    //! ctor
+    //! @param shards is the number of independent partitions of the table
+    explicit symtbl_t(size_t shards = 16);
+
+    symtbl_t(const symtbl_t&) = delete;
+    symtbl_t& operator=(const symtbl_t&) = delete;
+
+    //! Return the id of a value, adding it to the table if not yet present
+    size_t intern(const char_t * data, size_t size);
+
+    size_t intern(const string_t & value) {
+        return intern(value.data(), value.size());
+    }
+
+    //! Return the id of a value or npos if it is not in the table
+    size_t find(const char_t * data, size_t size) const;
+
+    size_t find(const string_t & value) const {
+        return find(value.data(), value.size());
+    }
+
+    //! Return the value of a given symbol id or nullptr if it is unknown
+    const string_t * value(size_t id) const;
+
+    //! Return the number of symbols
+    size_t size() const;
+
+private:
+    struct entry_t {
+        string_t value;
+        size_t id;
+    };
+
+    struct shard_t {
+        mutable std::mutex mtx;
+        std::deque<entry_t> entries;
+        std::unordered_multimap<size_t /*hash*/, const entry_t*> index;
+    };
+
+    static size_t _hash(const char_t * data, size_t size) noexcept;
+
+    static const entry_t * _lookup(
+        const shard_t & shard, 
+        size_t hash, 
+        const char_t * data, 
+        size_t size);
+
+    std::vector<shard_t> _shards;
+
+    mutable std::mutex _ids_mtx;
+    std::vector<const entry_t*> _ids;
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+} // namespace mip
+
+
+/* -------------------------------------------------------------------------- */
+
+#endif // __MIP_SYMTBL_H__
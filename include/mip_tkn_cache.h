@@ -0,0 +1,98 @@
+//  
+// This file is part of MipTknzr Library Project
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.  
+// Licensed under the MIT License. 
+// See COPYING file in the project root for full license information.
+//
+
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef __MIP_TKN_CACHE_H__
+#define __MIP_TKN_CACHE_H__
+
+
+/* -------------------------------------------------------------------------- */
+
+#include "mip_tknzr.h"
+#include "mip_tkn_stream.h"
+
+#include <cstdint>
+#include <string>
+
+
+/* -------------------------------------------------------------------------- */
+
+namespace mip {
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ *  Persistent cache of token streams: the tokens of a file are stored in 
+ *  a directory as a tkn_stream_t keyed by the hash of the file content 
+ *  and by the grammar fingerprint of the tokenizer (see 
+ *  tknzr_t::fingerprint()). Tokenizing an unchanged file then costs a 
+ *  content hash and a file mapping.
+ */
+class tkn_cache_t {
+public:
+    //! ctor
+    //! @param dir is an existing directory holding the cached streams
+    explicit tkn_cache_t(const std::string & dir) : _dir(dir) {}
+
+    /**
+     * Get the token stream of a file, tokenizing and storing it unless 
+     * it is found in the cache
+     * @param tknzr is the tokenizer (reset before scanning a file)
+     * @param path is the file to tokenize
+     * @param stream will refer to the tokens of the file
+     * @return true in case of success, false otherwise
+     */
+    bool load(tknzr_t & tknzr, const std::string & path, tkn_stream_t & stream);
+
+    //! Remove the stored stream of a file (if any), so that next load() 
+    //! tokenizes it again
+    //! @return true if a stored stream has been removed
+    bool evict(const tknzr_t & tknzr, const std::string & path);
+
+    //! Deliver the tokens of a file to a sink (see tknzr_t::tokenize())
+    template <class Sink>
+    bool tokenize(tknzr_t & tknzr, const std::string & path, Sink && sink) {
+        tkn_stream_t stream;
+        return load(tknzr, path, stream) && stream.replay(sink);
+    }
+
+    //! Return the number of files found in the cache
+    size_t hits() const noexcept {
+        return _hits;
+    }
+
+    //! Return the number of files tokenized
+    size_t misses() const noexcept {
+        return _misses;
+    }
+
+private:
+    bool _entry(
+        const tknzr_t & tknzr, 
+        const std::string & path, 
+        file_map_t & content,
+        uint64_t & key, 
+        std::string & cache_path) const;
+
+    std::string _dir;
+    size_t _hits = 0;
+    size_t _misses = 0;
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+} // namespace mip
+
+
+/* -------------------------------------------------------------------------- */
+
+#endif // __MIP_TKN_CACHE_H__
@@ -0,0 +1,203 @@
+//  
+// This file is part of MipTknzr Library Project
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.  
+// Licensed under the MIT License. 
+// See COPYING file in the project root for full license information.
+//
+
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef __MIP_TKN_IDX_H__
+#define __MIP_TKN_IDX_H__
+
+
+/* -------------------------------------------------------------------------- */
+
+#include "mip_unicode.h"
+
+#include <array>
+#include <map>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+
+
+/* -------------------------------------------------------------------------- */
+
+namespace mip {
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ *  Dispatch table of token definitions indexed by their first character.
+ *  Candidates sharing the same first character are sorted by decreasing
+ *  length, so the first one matching the text is the longest match.
+ */
+class tkn_idx_t {
+public:
+    struct entry_t {
+        const string_t * value;
+        size_t id;
+
+        //! end of a multi-line comment definition, nullptr otherwise
+        const string_t * tail;
+
+        //! ordinal of the definition in the map the table is built from, 
+        //! plus a given base (see build())
+        size_t slot;
+    };
+
+    using entries_t = std::vector<entry_t>;
+
+    //! Build the table from a map of definitions <value, id>
+    //! (referred values must outlive the table), numbering them in the
+    //! order of the map from a given slot
+    template <class M>
+    void build(const M & defs, size_t slot = 0) {
+        for (auto & entries : _low) {
+            entries.clear();
+        }
+
+        _high.clear();
+
+        for (const auto & def : defs) {
+            const string_t & value = _key(def.first);
+
+            if (!value.empty()) {
+                _entries(value[0]).push_back(
+                    entry_t{ &value, def.second, _tail(def.first), slot });
+            }
+
+            ++slot;
+        }
+
+        auto longest_first = [](const entry_t & a, const entry_t & b) {
+            return a.value->size() > b.value->size();
+        };
+
+        for (auto & entries : _low) {
+            std::stable_sort(entries.begin(), entries.end(), longest_first);
+        }
+
+        for (auto & item : _high) {
+            std::stable_sort(
+                item.second.begin(), item.second.end(), longest_first);
+        }
+    }
+
+    //! Return the candidates starting with a given character or nullptr
+    const entries_t * find(char_t ch) const noexcept {
+        const auto uch = static_cast<uchar_t>(ch);
+
+        if (uch < _low.size()) {
+            return _low[uch].empty() ? nullptr : &_low[uch];
+        }
+
+        auto it = _high.find(ch);
+        return it == _high.end() ? nullptr : &it->second;
+    }
+
+    //! Return the longest definition matching the text at a given 
+    //! position or nullptr
+    const entry_t * match(const string_t & text, size_t pos) const noexcept {
+        const auto entries = find(text[pos]);
+
+        if (entries) {
+            const size_t avail = text.size() - pos;
+
+            for (const auto & entry : *entries) {
+                const auto & value = *entry.value;
+
+                if (value.size() <= avail && 
+                    text.compare(pos, value.size(), value) == 0) 
+                {
+                    return &entry;
+                }
+            }
+        }
+
+        return nullptr;
+    }
+
+    /**
+     * Return the longest definition matching the text at a given 
+     * position or nullptr, reporting each definition compared against 
+     * the text
+     * @param probe is any callable accepting (const entry_t&, bool), 
+     *        invoked for each candidate compared, along with the result
+     */
+    template <class Probe>
+    const entry_t * match(
+        const string_t & text, 
+        size_t pos, 
+        Probe && probe) const 
+    {
+        const auto entries = find(text[pos]);
+
+        if (entries) {
+            const size_t avail = text.size() - pos;
+
+            for (const auto & entry : *entries) {
+                const auto & value = *entry.value;
+
+                if (value.size() <= avail) {
+                    const bool hit = 
+                        text.compare(pos, value.size(), value) == 0;
+
+                    probe(entry, hit);
+
+                    if (hit) {
+                        return &entry;
+                    }
+                }
+            }
+        }
+
+        return nullptr;
+    }
+
+private:
+    using uchar_t = std::make_unsigned<char_t>::type;
+
+    static const string_t & _key(const string_t & key) noexcept {
+        return key;
+    }
+
+    static const string_t * _tail(const string_t &) noexcept {
+        return nullptr;
+    }
+
+    //! multi-line comments are indexed by their begin prefix
+    static const string_t & _key(
+        const std::pair<string_t, string_t> & key) noexcept 
+    {
+        return key.first;
+    }
+
+    static const string_t * _tail(
+        const std::pair<string_t, string_t> & key) noexcept 
+    {
+        return &key.second;
+    }
+
+    entries_t & _entries(char_t ch) {
+        const auto uch = static_cast<uchar_t>(ch);
+        return uch < _low.size() ? _low[uch] : _high[ch];
+    }
+
+    std::array<entries_t, 256> _low;
+    std::map<char_t, entries_t> _high;
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+} // namespace mip
+
+
+/* -------------------------------------------------------------------------- */
+
+#endif // __MIP_TKN_IDX_H__
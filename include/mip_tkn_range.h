@@ -0,0 +1,146 @@
+//  
+// This file is part of MipTknzr Library Project
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.  
+// Licensed under the MIT License. 
+// See COPYING file in the project root for full license information.
+//
+
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef __MIP_TKN_RANGE_H__
+#define __MIP_TKN_RANGE_H__
+
+
+/* -------------------------------------------------------------------------- */
+
+#include "mip_tknzr.h"
+
+#include <iterator>
+
+
+/* -------------------------------------------------------------------------- */
+
+namespace mip {
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ *  Input range of the tokens scanned from an input stream, e.g.
+ *
+ *  tkn_range_t range(*tknzr, is);
+ *  for (const auto & tkn : range) { ... }
+ *
+ *  The range ends after the end-of-file token or on error (see error()).
+ *  A token view is valid until the iterator is incremented.
+ */
+class tkn_range_t {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = tkn_view_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const tkn_view_t*;
+        using reference = const tkn_view_t&;
+
+        iterator() noexcept {}
+
+        explicit iterator(tkn_range_t * range) : _range(range) {
+            _range->_advance();
+        }
+
+        reference operator*() const noexcept {
+            return _range->_tkn;
+        }
+
+        pointer operator->() const noexcept {
+            return &_range->_tkn;
+        }
+
+        iterator& operator++() {
+            _range->_advance();
+            return *this;
+        }
+
+        void operator++(int) {
+            ++*this;
+        }
+
+        bool operator==(const iterator & other) const noexcept {
+            return _done() == other._done();
+        }
+
+        bool operator!=(const iterator & other) const noexcept {
+            return !(*this == other);
+        }
+
+    private:
+        bool _done() const noexcept {
+            return !_range || _range->_done;
+        }
+
+        tkn_range_t * _range = nullptr;
+    };
+
+    tkn_range_t(tknzr_t & tknzr, _istream & is) noexcept :
+        _tknzr(tknzr),
+        _is(is)
+    {}
+
+    tkn_range_t(const tkn_range_t&) = delete;
+    tkn_range_t& operator=(const tkn_range_t&) = delete;
+
+    //! Return an iterator to the first token not yet scanned
+    iterator begin() {
+        return iterator(this);
+    }
+
+    iterator end() noexcept {
+        return iterator();
+    }
+
+    //! Return true if the scan stopped because of an error
+    bool error() const noexcept {
+        return _error;
+    }
+
+private:
+    void _advance() {
+        if (_done) {
+            return;
+        }
+
+        if (_last) {
+            _done = true;
+            return;
+        }
+
+        if (!_tknzr.scan(_is, _tkn)) {
+            _error = true;
+            _done = true;
+            return;
+        }
+
+        _last = _tkn.type == token_t::tcl_t::END_OF_FILE;
+    }
+
+    tknzr_t & _tknzr;
+    _istream & _is;
+    tkn_view_t _tkn;
+    bool _last = false;
+    bool _done = false;
+    bool _error = false;
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+} // namespace mip
+
+
+/* -------------------------------------------------------------------------- */
+
+#endif // __MIP_TKN_RANGE_H__
@@ -0,0 +1,267 @@
+//  
+// This file is part of MipTknzr Library Project
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.  
+// Licensed under the MIT License. 
+// See COPYING file in the project root for full license information.
+//
+
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef __MIP_TKN_SINK_H__
+#define __MIP_TKN_SINK_H__
+
+
+/* -------------------------------------------------------------------------- */
+
+#include "mip_tkn_view.h"
+
+#include <set>
+#include <vector>
+#include <utility>
+
+
+/* -------------------------------------------------------------------------- */
+
+namespace mip {
+
+
+/* -------------------------------------------------------------------------- */
+
+template <class Sink, class T>
+inline auto _tkn_deliver(Sink & sink, const T & tkn, int)
+    -> decltype(bool(sink(tkn)))
+{
+    return bool(sink(tkn));
+}
+
+template <class Sink, class T>
+inline bool _tkn_deliver(Sink & sink, const T & tkn, long)
+{
+    sink(tkn);
+    return true;
+}
+
+//! Deliver a token to a sink; return false if the sink asks to stop
+//! the scan (sinks whose return type is void never do)
+template <class Sink, class T>
+inline bool tkn_deliver(Sink & sink, const T & tkn)
+{
+    return _tkn_deliver(sink, tkn, 0);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ *  The following adaptors wrap a downstream sink and can be nested to 
+ *  build a pipeline which runs lazily inside tknzr_t::tokenize(), in a 
+ *  single pass and with no intermediate token container, e.g.
+ *
+ *  tknzr->tokenize(is, 
+ *      drop_class({ token_t::tcl_t::BLANK }, 
+ *          take_until_atom(_T(";"), 
+ *              map_value(to_enum, consumer))));
+ *
+ *  An lvalue downstream sink is held by reference, an rvalue by value.
+ */
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Forward tokens whose class is (or, if keep is false, is not) in a set
+template <class Sink>
+class class_filter_t {
+public:
+    class_filter_t(
+        const std::set<token_t::tcl_t> & classes, 
+        bool keep, 
+        Sink && sink) 
+        :
+        _keep(keep),
+        _sink(std::forward<Sink>(sink))
+    {
+        for (const auto & cl : classes) {
+            _mask |= 1u << static_cast<unsigned>(cl);
+        }
+    }
+
+    bool operator()(const tkn_view_t & tkn) {
+        const bool in_set = 
+            (_mask & (1u << static_cast<unsigned>(tkn.type))) != 0;
+
+        return in_set == _keep ? tkn_deliver(_sink, tkn) : true;
+    }
+
+private:
+    unsigned _mask = 0;
+    bool _keep = true;
+    Sink _sink;
+};
+
+
+//! Forward only tokens of given classes
+template <class Sink>
+class_filter_t<Sink> filter_class(
+    const std::set<token_t::tcl_t> & classes, Sink && sink)
+{
+    return class_filter_t<Sink>(classes, true, std::forward<Sink>(sink));
+}
+
+
+//! Forward all the tokens but the ones of given classes
+template <class Sink>
+class_filter_t<Sink> drop_class(
+    const std::set<token_t::tcl_t> & classes, Sink && sink)
+{
+    return class_filter_t<Sink>(classes, false, std::forward<Sink>(sink));
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Forward tokens and stop the scan once a given atom has been found 
+//! (the atom itself is not forwarded)
+template <class Sink>
+class atom_limiter_t {
+public:
+    atom_limiter_t(const string_t & atom, Sink && sink) :
+        _atom(atom),
+        _sink(std::forward<Sink>(sink))
+    {}
+
+    bool operator()(const tkn_view_t & tkn) {
+        if (tkn.type == token_t::tcl_t::ATOM &&
+            _atom.compare(0, _atom.size(), tkn.data, tkn.size) == 0) 
+        {
+            return false;
+        }
+
+        return tkn_deliver(_sink, tkn);
+    }
+
+private:
+    string_t _atom;
+    Sink _sink;
+};
+
+
+//! Forward tokens up to a given atom
+template <class Sink>
+atom_limiter_t<Sink> take_until_atom(const string_t & atom, Sink && sink)
+{
+    return atom_limiter_t<Sink>(atom, std::forward<Sink>(sink));
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Forward the result of a function applied to each token
+template <class F, class Sink>
+class value_mapper_t {
+public:
+    value_mapper_t(F && fn, Sink && sink) :
+        _fn(std::forward<F>(fn)),
+        _sink(std::forward<Sink>(sink))
+    {}
+
+    bool operator()(const tkn_view_t & tkn) {
+        return tkn_deliver(_sink, _fn(tkn));
+    }
+
+private:
+    F _fn;
+    Sink _sink;
+};
+
+
+//! Map each token to fn(token)
+template <class F, class Sink>
+value_mapper_t<F, Sink> map_value(F && fn, Sink && sink)
+{
+    return value_mapper_t<F, Sink>(
+        std::forward<F>(fn), std::forward<Sink>(sink));
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Sliding window of the last tokens; index 0 refers to the oldest one.
+//! Values are owned by the window so they outlive the scanned line
+class tkn_window_t {
+public:
+    explicit tkn_window_t(size_t size) :
+        _slots(size ? size : 1)
+    {}
+
+    size_t size() const noexcept {
+        return _count < _slots.size() ? _count : _slots.size();
+    }
+
+    bool full() const noexcept {
+        return _count >= _slots.size();
+    }
+
+    const tkn_view_t & operator[](size_t i) const noexcept {
+        return _slots[(_count - size() + i) % _slots.size()].view;
+    }
+
+    void push(const tkn_view_t & tkn) {
+        auto & slot = _slots[_count % _slots.size()];
+
+        slot.value.assign(tkn.data, tkn.size);
+        slot.view = tkn;
+        slot.view.data = slot.value.data();
+
+        ++_count;
+    }
+
+private:
+    struct slot_t {
+        tkn_view_t view;
+        string_t value;
+    };
+
+    std::vector<slot_t> _slots;
+    size_t _count = 0;
+};
+
+
+//! Forward a window of the last N tokens for each token scanned once
+//! at least N tokens have been found
+template <class Sink>
+class tkn_windower_t {
+public:
+    tkn_windower_t(size_t size, Sink && sink) :
+        _window(size),
+        _sink(std::forward<Sink>(sink))
+    {}
+
+    bool operator()(const tkn_view_t & tkn) {
+        _window.push(tkn);
+        return _window.full() ? tkn_deliver(_sink, _window) : true;
+    }
+
+private:
+    tkn_window_t _window;
+    Sink _sink;
+};
+
+
+//! Group tokens in sliding windows of a given size
+template <class Sink>
+tkn_windower_t<Sink> window(size_t size, Sink && sink)
+{
+    return tkn_windower_t<Sink>(size, std::forward<Sink>(sink));
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+} // namespace mip
+
+
+/* -------------------------------------------------------------------------- */
+
+#endif // __MIP_TKN_SINK_H__
@@ -0,0 +1,226 @@
+//  
+// This file is part of MipTknzr Library Project
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.  
+// Licensed under the MIT License. 
+// See COPYING file in the project root for full license information.
+//
+
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef __MIP_TKN_STREAM_H__
+#define __MIP_TKN_STREAM_H__
+
+
+/* -------------------------------------------------------------------------- */
+
+#include "mip_tkn_view.h"
+#include "mip_tkn_sink.h"
+#include "mip_file_map.h"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+
+/* -------------------------------------------------------------------------- */
+
+namespace mip {
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ *  Compact binary serialization of a token stream: a header, a sequence 
+ *  of variable-length token records (positions and lines delta-encoded, 
+ *  optional fields present only if needed, indentation width of indent 
+ *  and dedent tokens) and a pool of token values. 
+ *  A stored stream is replayed in place, by mapping its file, decoding 
+ *  records on the fly. Symbol ids are not serialized.
+ */
+class tkn_stream_t {
+public:
+    //! Format version (streams of different versions are rejected)
+    static const uint32_t version = 2;
+
+    tkn_stream_t() = default;
+    tkn_stream_t(const tkn_stream_t&) = delete;
+    tkn_stream_t& operator=(const tkn_stream_t&) = delete;
+
+    //! Remove any token
+    void clear();
+
+    //! Append a token (tokens must be added in stream order)
+    void add(const tkn_view_t & tkn);
+
+    //! Store the stream into a file tagged by a given key
+    bool save(const std::string & path, uint64_t key);
+
+    //! Map a stored stream; return false if the file is missing or was 
+    //! not written with the same key, version, byte order and char_t
+    bool open(const std::string & path, uint64_t key);
+
+    //! Return the number of tokens
+    size_t size() const noexcept {
+        return _count;
+    }
+
+    //! Deliver each token to a sink (see tknzr_t::tokenize())
+    template <class Sink>
+    bool replay(Sink && sink) const;
+
+private:
+    struct header_t {
+        char magic[4];
+        uint32_t endian;
+        uint32_t version;
+        uint32_t char_size;
+        uint64_t key;
+        uint64_t count;
+        uint64_t code;
+        uint64_t pool;
+    };
+
+    //! record flags (the low nibble holds the token class)
+    enum : uint8_t {
+        REC_LINE = 0x10,
+        REC_ID = 0x20,
+        REC_STR = 0x40,
+        REC_NUM = 0x80
+    };
+
+    //! number flags
+    enum : uint8_t {
+        NUM_FLOATING = 1,
+        NUM_OVERFLOW = 2
+    };
+
+    static const uint32_t _endian_mark = 0x01020304;
+
+    void _put(uint64_t value);
+
+    static bool _has_width(token_t::tcl_t type) noexcept {
+        return type == token_t::tcl_t::INDENT || 
+            type == token_t::tcl_t::DEDENT;
+    }
+
+    static uint64_t _get(const unsigned char * & p) noexcept {
+        uint64_t value = 0;
+        unsigned shift = 0;
+
+        while (*p & 0x80) {
+            value |= uint64_t(*p++ & 0x7F) << shift;
+            shift += 7;
+        }
+
+        return value | (uint64_t(*p++) << shift);
+    }
+
+    //! bounded variant of _get(), false if the varint crosses end
+    static bool _get(const unsigned char * & p, const unsigned char * end,
+        uint64_t & value) noexcept;
+
+    //! walks every record of a mapped stream checking it stays in bounds
+    static bool _check(const char * data) noexcept;
+
+    void _set_data(const char * data) noexcept;
+
+    //! records and pool being built
+    std::string _code_buf;
+    string_t _pool;
+    size_t _last_line = 0;
+    size_t _last_start = 0;
+    size_t _last_end = 0;
+
+    //! serialized stream (built or mapped)
+    std::vector<char> _buf;
+    file_map_t _map;
+
+    const unsigned char * _code = nullptr;
+    const char_t * _values = nullptr;
+    size_t _count = 0;
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+template <class Sink>
+bool tkn_stream_t::replay(Sink && sink) const
+{
+    tkn_view_t tkn;
+    const unsigned char * p = _code;
+    const char_t * value = _values;
+    size_t line = 0;
+    size_t line_start = 0;
+    size_t end = 0;
+
+    for (size_t i = 0; i < _count; ++i) {
+        const uint8_t head = *p++;
+
+        if (head & REC_LINE) {
+            line += static_cast<size_t>(_get(p));
+            line_start += static_cast<size_t>(_get(p));
+        }
+
+        tkn.type = static_cast<token_t::tcl_t>(head & 0x0F);
+        // position delta is zigzag-encoded
+        const uint64_t delta = _get(p);
+        tkn.pos = end + static_cast<size_t>((delta >> 1) ^ (0 - (delta & 1)));
+        tkn.end = tkn.pos + static_cast<size_t>(_get(p));
+        tkn.size = static_cast<size_t>(_get(p));
+        tkn.data = value;
+        tkn.line = line;
+        tkn.offset = tkn.pos - line_start;
+        tkn.index = i;
+        tkn.sym = token_t::npos;
+        tkn.id = (head & REC_ID) ? static_cast<size_t>(_get(p)) : token_t::npos;
+        tkn.width = _has_width(tkn.type) ? static_cast<size_t>(_get(p)) : 0;
+        tkn.quote = 0;
+        tkn.esc = 0;
+        tkn.num = numval_t();
+
+        if (head & REC_STR) {
+            tkn.quote = static_cast<char_t>(_get(p));
+            tkn.esc = static_cast<char_t>(_get(p));
+        }
+
+        if (head & REC_NUM) {
+            const uint8_t flags = *p++;
+            uint64_t bits = 0;
+
+            std::memcpy(&bits, p, sizeof(bits));
+            p += sizeof(bits);
+
+            tkn.num.floating = (flags & NUM_FLOATING) != 0;
+            tkn.num.overflow = (flags & NUM_OVERFLOW) != 0;
+
+            if (tkn.num.floating) {
+                std::memcpy(&tkn.num.real, &bits, sizeof(bits));
+            }
+            else {
+                tkn.num.integer = bits;
+            }
+        }
+
+        value += tkn.size;
+        end = tkn.end;
+
+        if (!tkn_deliver(sink, tkn)) {
+            break;
+        }
+    }
+
+    return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+} // namespace mip
+
+
+/* -------------------------------------------------------------------------- */
+
+#endif // __MIP_TKN_STREAM_H__
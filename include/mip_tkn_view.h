@@ -0,0 +1,89 @@
+//  
+// This file is part of MipTknzr Library Project
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.  
+// Licensed under the MIT License. 
+// See COPYING file in the project root for full license information.
+//
+
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef __MIP_TKN_VIEW_H__
+#define __MIP_TKN_VIEW_H__
+
+
+/* -------------------------------------------------------------------------- */
+
+#include "mip_token.h"
+
+
+/* -------------------------------------------------------------------------- */
+
+namespace mip {
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Non-owning description of a token found by the tokenizer engine.
+//! Referred data are valid until the engine is called again.
+struct tkn_view_t
+{
+    //! token type
+    token_t::tcl_t type = token_t::tcl_t::OTHER;
+
+    //! token value (not null-terminated)
+    const char_t* data = nullptr;
+
+    //! token value length
+    size_t size = 0;
+
+    //! text line number
+    size_t line = 0;
+
+    //! token offset in the text line
+    size_t offset = 0;
+
+    //! absolute token position in the input (see line_idx_t)
+    size_t pos = 0;
+
+    //! absolute position of the input following the token
+    size_t end = 0;
+
+    //! quote of any string token
+    char_t quote = 0;
+
+    //! escape sequence prefix; defined for token representing string
+    char_t esc = 0;
+
+    //! symbol id of an interned token value (see symtbl_t)
+    size_t sym = token_t::npos;
+
+    //! id of the definition matched by the token (see tknzr_bldr_t)
+    size_t id = token_t::npos;
+
+    //! value of number token
+    numval_t num;
+
+    //! index of the token in the stream (first token -> 0)
+    size_t index = 0;
+
+    //! width of the indentation level opened by an indent token or 
+    //! closed by a dedent token
+    size_t width = 0;
+
+    //! return a copy of token value
+    string_t value() const {
+        return string_t(data, size);
+    }
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+} // namespace mip
+
+
+/* -------------------------------------------------------------------------- */
+
+#endif // __MIP_TKN_VIEW_H__
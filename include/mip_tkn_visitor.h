@@ -0,0 +1,95 @@
+//  
+// This file is part of MipTknzr Library Project
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.  
+// Licensed under the MIT License. 
+// See COPYING file in the project root for full license information.
+//
+
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef __MIP_TKN_VISITOR_H__
+#define __MIP_TKN_VISITOR_H__
+
+
+/* -------------------------------------------------------------------------- */
+
+#include "mip_tkn_view.h"
+
+
+/* -------------------------------------------------------------------------- */
+
+namespace mip {
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ *  Token sink which dispatches each token to a per-class handler of the 
+ *  derived class D (e.g. D::on_atom()). Handlers not redefined by D accept
+ *  the token; a handler returning false stops the scan.
+ *  Dispatch is resolved at compile time, so it can be inlined into 
+ *  tknzr_t::tokenize()
+ */
+template <class D>
+struct tkn_visitor_t
+{
+    bool operator()(const tkn_view_t & tkn) {
+        auto & self = static_cast<D&>(*this);
+
+        switch (tkn.type) {
+        case token_t::tcl_t::BLANK:
+            return self.on_blank(tkn);
+        case token_t::tcl_t::END_OF_LINE:
+            return self.on_eol(tkn);
+        case token_t::tcl_t::END_OF_FILE:
+            return self.on_eof(tkn);
+        case token_t::tcl_t::COMMENT:
+            return self.on_comment(tkn);
+        case token_t::tcl_t::STRING:
+            return self.on_string(tkn);
+        case token_t::tcl_t::ATOM:
+            return self.on_atom(tkn);
+        case token_t::tcl_t::OTHER:
+            return self.on_other(tkn);
+        case token_t::tcl_t::KEYWORD:
+            return self.on_keyword(tkn);
+        case token_t::tcl_t::PATTERN:
+            return self.on_pattern(tkn);
+        case token_t::tcl_t::NUMBER:
+            return self.on_number(tkn);
+        case token_t::tcl_t::INDENT:
+            return self.on_indent(tkn);
+        case token_t::tcl_t::DEDENT:
+            return self.on_dedent(tkn);
+        default:
+            break;
+        }
+
+        return true;
+    }
+
+    bool on_blank(const tkn_view_t &) { return true; }
+    bool on_eol(const tkn_view_t &) { return true; }
+    bool on_eof(const tkn_view_t &) { return true; }
+    bool on_comment(const tkn_view_t &) { return true; }
+    bool on_string(const tkn_view_t &) { return true; }
+    bool on_atom(const tkn_view_t &) { return true; }
+    bool on_other(const tkn_view_t &) { return true; }
+    bool on_keyword(const tkn_view_t &) { return true; }
+    bool on_pattern(const tkn_view_t &) { return true; }
+    bool on_number(const tkn_view_t &) { return true; }
+    bool on_indent(const tkn_view_t &) { return true; }
+    bool on_dedent(const tkn_view_t &) { return true; }
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+} // namespace mip
+
+
+/* -------------------------------------------------------------------------- */
+
+#endif // __MIP_TKN_VISITOR_H__
@@ -61,6 +61,58 @@ public:
     }
 
 
+    //! move ctor
+    tknlst_bldr_t(tknlst_bldr_t && other) noexcept :
+        _tknzr_bldr(std::move(other._tknzr_bldr)),
+        _blnks(std::move(other._blnks)),
+        _tknzr(std::move(other._tknzr)),
+        _mem_limit(other._mem_limit),
+        _mem_pool(std::move(other._mem_pool)),
+        _list_bytes(other._list_bytes),
+        _list_charged(other._list_charged),
+        _error(other._error)
+    {
+        other._list_charged = 0;
+    }
+
+
+    /**
+     * Set a hard limit to the memory held by the tokenizer and by the 
+     * lists being built (token objects, values and list nodes): each 
+     * build fails with tknzr_t::error_t::MEM_LIMIT as soon as it is 
+     * exceeded
+     * @param bytes is the limit or 0 for none
+     */
+    void set_mem_limit(size_t bytes) noexcept {
+        _mem_limit = bytes;
+    }
+
+
+    //! Charge the memory held by the tokenizer and by the lists being 
+    //! built to a memory pool (see tknzr_t::set_mem_pool()); the lists 
+    //! are released from the pool as build() hands them over
+    void set_mem_pool(std::shared_ptr<mem_pool_t> pool) noexcept {
+        _mem_pool = pool;
+    }
+
+
+    //! Return the memory held by the tokenizer and by the lists of the 
+    //! last build
+    mem_usage_t mem_usage() const noexcept {
+        auto usage = _tknzr ? _tknzr->mem_usage() : mem_usage_t();
+        usage.bytes[static_cast<size_t>(mem_usage_t::mem_t::LISTS)] += 
+            _list_bytes;
+
+        return usage;
+    }
+
+
+    //! Return the kind of failure of the last build (see build())
+    tknzr_t::error_t error() const noexcept {
+        return _error;
+    }
+
+
     /**
      * Builds a list of tokens from an input stream
      * @param is must be an input stream
@@ -89,26 +141,81 @@ private:
 
     // -------------------------------------------------------------------------
 
-    void _insert(std::unique_ptr<token_t> tkn, tknlist_t & nonblnks) noexcept {
+    bool _insert(std::unique_ptr<token_t> tkn, tknlist_t & nonblnks) noexcept {
         if (_blnks.find(tkn->type()) == _blnks.end()) {
+            if (!_account(*tkn)) {
+                return false;
+            }
+
             nonblnks.push_back(std::move(tkn));
         }
+
+        return true;
     }
 
 
     // -------------------------------------------------------------------------
 
-    void _insert(
+    bool _insert(
         std::unique_ptr<token_t> tkn,  
         tknlist_t & nonblnks,
         tknlist_t & blanks) noexcept
     {
+        if (!_account(*tkn)) {
+            return false;
+        }
+
         if (_blnks.find(tkn->type()) == _blnks.end()) {
             nonblnks.push_back(std::move(tkn));
         }
         else {
             blanks.push_back(std::move(tkn));
         }
+
+        return true;
+    }
+
+
+    // -------------------------------------------------------------------------
+
+    //! Account the memory of a token added to a list: the token object, 
+    //! its value (unless it fits the string object) and the list node
+    bool _account(const token_t & tkn) noexcept {
+        static const size_t sso_size = string_t().capacity();
+        const size_t capacity = tkn.value().capacity();
+
+        const size_t bytes = sizeof(token_t) + 
+            (capacity > sso_size ? capacity * sizeof(char_t) : 0) + 
+            sizeof(tknlist_t::value_type) + 2 * sizeof(void*);
+
+        if (_mem_limit && 
+            _tknzr->mem_usage().total() + _list_bytes + bytes > _mem_limit) 
+        {
+            return false;
+        }
+
+        if (_mem_pool) {
+            if (!_mem_pool->charge(mem_usage_t::mem_t::LISTS, bytes)) {
+                return false;
+            }
+
+            _list_charged += bytes;
+        }
+
+        _list_bytes += bytes;
+
+        return true;
+    }
+
+
+    // -------------------------------------------------------------------------
+
+    void _release() noexcept {
+        if (_mem_pool) {
+            _mem_pool->release(mem_usage_t::mem_t::LISTS, _list_charged);
+        }
+
+        _list_charged = 0;
     }
 
 
@@ -116,12 +223,35 @@ private:
 
     template <class ... T>
     bool _build(_istream& is, T&& ... args) noexcept {
-        _tknzr = _tknzr_bldr.build();
+        _list_bytes = 0;
+
+        const bool ok = _scan(is, std::forward<T>(args)...);
+
+        // the lists now belong to the caller: they are no longer charged
+        _release();
+
+        return ok;
+    }
+
+
+    // -------------------------------------------------------------------------
+
+    template <class ... T>
+    bool _scan(_istream& is, T&& ... args) noexcept {
+        _error = tknzr_t::error_t::SCAN;
+        _tknzr = _tknzr_bldr.build_engine();
 
         if (!_tknzr) {
             return false;
         }
 
+        _tknzr->set_mem_limit(_mem_limit);
+
+        if (_mem_pool && !_tknzr->set_mem_pool(_mem_pool)) {
+            _error = tknzr_t::error_t::MEM_LIMIT;
+            return false;
+        }
+
         while (! _tknzr->eos(is)) {
             if (is.bad()) {
                 return false;
@@ -130,12 +260,18 @@ private:
             auto tkn = _tknzr->next(is);
 
             if (!tkn) {
+                _error = _tknzr->error();
                 return false;
             }
 
-            _insert(std::move(tkn), std::forward<T>(args)...);
+            if (!_insert(std::move(tkn), std::forward<T>(args)...)) {
+                _error = tknzr_t::error_t::MEM_LIMIT;
+                return false;
+            }
         }
 
+        _error = tknzr_t::error_t::NONE;
+
         return true;
     }
 
@@ -144,7 +280,16 @@ private:
 
     tknzr_bldr_t _tknzr_bldr;
     std::set<token_t::tcl_t> _blnks;
-    std::unique_ptr<base_tknzr_t> _tknzr;
+    std::unique_ptr<tknzr_t> _tknzr;
+
+    //! memory limit, pool, bytes of the lists of the last build and bytes 
+    //! of them charged to the pool during the build
+    size_t _mem_limit = 0;
+    std::shared_ptr<mem_pool_t> _mem_pool;
+    size_t _list_bytes = 0;
+    size_t _list_charged = 0;
+
+    tknzr_t::error_t _error = tknzr_t::error_t::NONE;
 };
 
 
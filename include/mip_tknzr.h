@@ -16,14 +16,27 @@
 /* -------------------------------------------------------------------------- */
 
 #include "mip_token.h"
+#include "mip_tkn_view.h"
+#include "mip_tkn_sink.h"
+#include "mip_symtbl.h"
+#include "mip_tkn_idx.h"
+#include "mip_phash.h"
+#include "mip_dfa.h"
+#include "mip_brkt_idx.h"
+#include "mip_line_idx.h"
 #include "mip_base_tknzr.h"
 #include "mip_base_esc_cnvrtr.h"
+#include "mip_tknzr_metrics.h"
+#include "mip_tknzr_profile.h"
+#include "mip_mem_pool.h"
 
 #include <memory>
 #include <istream>
 #include <set>
 #include <map>
+#include <unordered_map>
 #include <string>
+#include <vector>
 
 
 /* -------------------------------------------------------------------------- */
@@ -36,16 +49,215 @@ namespace mip {
 class tknzr_t : public base_tknzr_t
 {
     friend class tknzr_bldr_t;
+    friend class lexgen_t;
 
 public:
     using ml_commdef_t = std::pair<string_t, string_t>;
 
+    //! Definitions and their ids
+    using tkndef_t = std::map<string_t, size_t>;
+    using ml_comdef_t = std::map<ml_commdef_t, size_t>;
+
+    //! Failure kinds (see error())
+    enum class error_t {
+        NONE,
+        SCAN,       //!< invalid input or stream error
+        MEM_LIMIT,  //!< memory limit reached (see set_mem_limit())
+        TOKEN_SIZE, //!< token longer than the window allows (see 
+                    //!< tknzr_bldr_t::def_window())
+        INDENT      //!< dedent to a width matching no outer indentation 
+                    //!< level (see tknzr_bldr_t::def_indent())
+    };
+
     //! Return next token found in a given input stream
     std::unique_ptr<token_t> next(_istream & is) override;
 
     //! Return true if there is no more data to process
     bool eos(_istream & is) override;
 
+    //! Scan next token without building any token object
+    //! @param is must be an input stream
+    //! @param tkn will describe the token until the next call
+    //! @return true in case of success, false otherwise
+    bool scan(_istream & is, tkn_view_t & tkn) {
+        return _scan(is, tkn);
+    }
+
+    /**
+     * Attach a symbol table: values of other and pattern tokens (and 
+     * optionally of string tokens) are interned while scanning and tokens 
+     * carry their symbol id. The same table can be shared by several tokenizers.
+     * @param symtbl is a symbol table or nullptr to detach it
+     * @param strings if true, string tokens are interned too
+     */
+    void set_symtbl(
+        std::shared_ptr<symtbl_t> symtbl, 
+        bool strings = false) noexcept 
+    {
+        _symtbl = symtbl;
+        _intern_strings = strings;
+    }
+
+    //! Return attached symbol table (if any)
+    std::shared_ptr<symtbl_t> symtbl() const noexcept {
+        return _symtbl;
+    }
+
+    //! Return the id of a given atom definition or token_t::npos
+    size_t atom_id(const string_t & value) const noexcept {
+        auto it = _atomdef.find(value);
+        return it == _atomdef.end() ? token_t::npos : it->second;
+    }
+
+    //! Return the id of a given keyword definition or token_t::npos
+    size_t keyword_id(const string_t & value) const noexcept {
+        return _kwidx.find(value.data(), value.size());
+    }
+
+    //! Return the index of matching bracket tokens found so far 
+    //! (see tknzr_bldr_t::def_bracket())
+    const brkt_idx_t & brackets() const noexcept {
+        return _brkidx;
+    }
+
+    //! Return the column of a token of the current line counted in 
+    //! code points when the UTF-8 mode is enabled (see 
+    //! tknzr_bldr_t::def_utf8()), or its offset otherwise. The input is 
+    //! not retained, so in UTF-8 mode the column is only available while 
+    //! the token line is buffered (e.g. within a tokenize() sink) and 
+    //! token_t::npos is returned for tokens of the lines already dropped
+    size_t column(const tkn_view_t & tkn) const noexcept;
+
+    //! Return the index of line starts collected while scanning 
+    //! (if enabled by tknzr_bldr_t::def_line_index() or 
+    //! tknzr_bldr_t::def_offsets_only())
+    const line_idx_t & lines() const noexcept {
+        return _lineidx;
+    }
+
+    //! Scan the input stream up to its end collecting statistics: token 
+    //! values are only measured, not built (no string or comment text is 
+    //! copied, no number converted, no symbol interned)
+    bool stats(_istream & is, tknzr_stats_t & st) override;
+
+    //! Reset the scanning state, so that a new input stream can be 
+    //! tokenized from its beginning (runtime metrics are kept)
+    void reset() {
+        _reset();
+        _error = error_t::NONE;
+    }
+
+    //! Return the kind of the last failure of next(), scan(), tokenize()
+    //! or stats() (error_t::NONE if none since reset())
+    error_t error() const noexcept {
+        return _error;
+    }
+
+    //! Return the bytes of heap memory currently held by the tokenizer 
+    //! for scanning (definitions excluded)
+    mem_usage_t mem_usage() const noexcept;
+
+    /**
+     * Set a hard limit to the memory held (see mem_usage()): instead of
+     * growing a buffer beyond it (e.g. for a gigantic line or an 
+     * unterminated comment), scanning fails with error_t::MEM_LIMIT and 
+     * the buffers are released
+     * @param bytes is the limit or 0 for none
+     */
+    void set_mem_limit(size_t bytes) noexcept {
+        _mem_limit = bytes;
+        _mem_guard = _mem_limit || _mem_pool;
+    }
+
+    //! Return the limit to the memory held (0 if none)
+    size_t mem_limit() const noexcept {
+        return _mem_limit;
+    }
+
+    /**
+     * Charge the memory held to a pool shared by several tokenizers: 
+     * scanning fails with error_t::MEM_LIMIT as soon as the pool refuses 
+     * a charge (see set_mem_limit())
+     * @param pool is a memory pool or nullptr to detach it
+     * @return false if the pool cannot take the memory already held 
+     *         (the pool is not attached)
+     */
+    bool set_mem_pool(std::shared_ptr<mem_pool_t> pool);
+
+    //! Return attached memory pool (if any)
+    std::shared_ptr<mem_pool_t> mem_pool() const noexcept {
+        return _mem_pool;
+    }
+
+    //! Return true if runtime metrics are collected, i.e. the library 
+    //! has been built with MIP_TKNZR_METRICS defined
+    static bool metrics_enabled() noexcept;
+
+    //! Return a snapshot of the runtime metrics collected so far 
+    //! (see tknzr_metrics_t)
+    tknzr_metrics_t metrics() const {
+        return _metrics;
+    }
+
+    //! Clear runtime metrics
+    void reset_metrics() noexcept {
+        _metrics = tknzr_metrics_t();
+    }
+
+    //! Time one scanning call every given number of calls (default 1024),
+    //! or none if period is 0
+    void set_metrics_sampling(size_t period) noexcept {
+        _mt_period = period;
+        _mt_countdown = 0;
+    }
+
+    //! Return true if the cost of each definition is profiled, i.e. the 
+    //! library has been built with MIP_TKNZR_PROFILE defined
+    static bool profiling_enabled() noexcept;
+
+    //! Return a snapshot of the per-definition profile collected so far 
+    //! (see tknzr_profile_t), empty if profiling is not enabled
+    tknzr_profile_t profile() const {
+        return _profile;
+    }
+
+    //! Clear the counters of the per-definition profile
+    void reset_profile() noexcept;
+
+    //! Return a hash of the definitions and options affecting the token 
+    //! stream (tokenizers built alike have the same fingerprint)
+    uint64_t fingerprint() const;
+
+    //! Grammar blob format version (see save_grammar())
+    static const uint32_t grammar_version = 2;
+
+    /**
+     * Serialize definitions, options and compiled matching structures 
+     * (perfect hash, DFA) into a flat blob, which can be turned into an 
+     * equivalent tokenizer by tknzr_bldr_t::load_engine() skipping any
+     * compilation step
+     * @param blob will contain the serialized grammar
+     * @return false if grammar cannot be serialized (string definitions 
+     *         using a custom escape converter)
+     */
+    bool save_grammar(std::vector<char> & blob) const;
+
+    //! Serialize the grammar into a file (see save_grammar())
+    bool save_grammar(const std::string & path) const;
+
+    /**
+     * Scan the input stream delivering each token to a sink, with no
+     * token object allocation and no virtual call per token
+     * @param is must be an input stream
+     * @param sink is any callable accepting a const tkn_view_t&
+     *        (e.g. an object derived from tkn_visitor_t); the scan stops
+     *        once end-of-file token has been delivered or as soon as the 
+     *        sink returns false (if its return type is not void)
+     * @return true in case of success, false otherwise
+     */
+    template <class Sink>
+    bool tokenize(_istream & is, Sink && sink);
+
     //! dtor
     virtual ~tknzr_t();
 
@@ -57,34 +269,32 @@ private:
 
     enum class get_t {
         JUST_TKN,
+        TKN_RUN,
         WHOLE_LN
     };
 
-    size_t _offset = 0;
     size_t _line_number = 0;
 
+    //! current text line and position of next character to scan
     string_t _textline;
-    string_t _eol_seq;
-    string_t _other_token;
+    size_t _pos = 0;
 
-    bool _eof = false;
+    //! position in the text line of pending other token (if any)
+    size_t _other_pos = string_t::npos;
 
-    static bool _is_prefix_ch(
-        const char_t ch, 
-        const std::set<string_t> & tknset);
+    string_t _eol_seq;
+
+    //! scratch buffer holding values which are not part of text line
+    string_t _value;
 
-    static std::set<string_t>::const_reverse_iterator _search_token(
-        const std::set<string_t>& tknset,
-        string_t & line);
+    bool _eof = false;
 
-    static string_t _extract_token(
-        const string_t& set_tkn,
-        string_t & line,
-        get_t cut_type);
+    std::shared_ptr<symtbl_t> _symtbl;
+    bool _intern_strings = false;
 
-    bool _ml_comment_begin(
-        const std::set<ml_commdef_t> & tknset,
-        string_t & end_comment);
+    bool _build_idx();
+    bool _index_defs();
+    bool _load_grammar(const char * data, size_t size);
 
     void _reset();
 
@@ -92,36 +302,204 @@ private:
         _istream & is, 
         string_t & line, 
         string_t& eol_s, 
-        bool & eof);
-
-    std::unique_ptr<token_t> _extract_comment(
-        string_t & comment,
-        size_t end_comment_offset,
-        string_t& end_comment,
-        size_t line_number,
-        size_t offset);
-
-    std::unique_ptr<token_t> _search_eof();
-    std::unique_ptr<token_t> _search_eol();
-    std::unique_ptr<token_t> _search_other_tkn();
-    std::unique_ptr<token_t> _get_comment(_istream & is);
-
-    std::unique_ptr<token_t> _get_tkn(
-        const std::set<string_t> & tknset,
-        token_t::tcl_t tkncl,
-        get_t cut_type);
-
-    std::unique_ptr<token_t> _get_string();
+        bool & eof,
+        size_t max_size = string_t::npos);
 
-    std::set<string_t> _blkdef;
-    std::set<string_t> _atomdef;
+    void _set_tkn(
+        tkn_view_t & tkn,
+        token_t::tcl_t tkncl,
+        const char_t * data,
+        size_t size,
+        size_t offset) const noexcept;
+
+    bool _scan(_istream & is, tkn_view_t & tkn);
+    bool _scan_tkn(_istream & is, tkn_view_t & tkn);
+    void _mt_mark(tknzr_metrics_t::matcher_t matcher) noexcept;
+    void _mt_grown(size_t old_capacity, size_t capacity) noexcept;
+
+    bool _mem_sync() noexcept;
+    void _mem_release() noexcept;
+    bool _mem_reserve(string_t & buf, mem_usage_t::mem_t kind, size_t size);
+
+    const tkn_idx_t::entry_t * _match(const tkn_idx_t & tknidx, size_t pos);
+    void _pf_index();
+    uint64_t _pf_start(const tkn_idx_t & tknidx) const noexcept;
+    void _pf_hit(size_t slot, uint64_t begin) noexcept;
+    void _pf_miss(uint64_t begin) noexcept;
+    void _track_brackets(const tkn_view_t & tkn);
+
+    bool _read_line(_istream & is);
+    bool _fill_window(_istream & is, size_t keep_back = 0);
+    bool _extend_window(_istream & is, size_t count);
+    bool _grow_window(_istream & is);
+    bool _indent_line();
+    bool _search_indent(tkn_view_t & tkn);
+    bool _search_eof_dedent(tkn_view_t & tkn);
+
+    bool _search_eof(tkn_view_t & tkn);
+    bool _search_eol(tkn_view_t & tkn);
+    bool _search_other_tkn(tkn_view_t & tkn);
+    bool _get_comment(_istream & is, tkn_view_t & tkn, bool & found);
+
+    void _get_comment_chunk(
+        const tkn_idx_t::entry_t * def, 
+        size_t from, 
+        tkn_view_t & tkn);
+
+    bool _get_tkn(
+        const tkn_idx_t & tknidx,
+        token_t::tcl_t tkncl,
+        get_t cut_type,
+        tkn_view_t & tkn);
+
+    bool _match_tkn(tkn_view_t & tkn);
+    bool _get_string(tkn_view_t & tkn);
+    bool _get_pattern(tkn_view_t & tkn);
+    bool _get_number(tkn_view_t & tkn);
+
+    size_t _scan_number(numval_t & num) const;
+
+    static bool _parse_integer(
+        const string_t & text,
+        size_t begin,
+        size_t end,
+        unsigned base,
+        numval_t & num) noexcept;
+
+    static void _parse_real(
+        const string_t & text,
+        size_t begin,
+        size_t end,
+        numval_t & num);
+
+    void _classify(tkn_view_t & tkn);
+
+    tkndef_t _blkdef;
+    tkndef_t _atomdef;
+    tkndef_t _kwdef;
+    tkndef_t _patdef;
     std::set<base_tknzr_t::eol_t> _eoldef;
-    std::set<string_t> _sl_comdef;
-    std::set<ml_commdef_t> _ml_comdef;
+    std::set<base_tknzr_t::num_t> _numdef;
+    tkndef_t _sl_comdef;
+    ml_comdef_t _ml_comdef;
+
+    //! bracket pairs <opener, closer> and their pair ids
+    std::map<std::pair<string_t, string_t>, size_t> _brkdef;
+
+    //! dispatch tables built from definitions by _build_idx()
+    tkn_idx_t _blkidx;
+    tkn_idx_t _atomidx;
+    tkn_idx_t _sl_comidx;
+    tkn_idx_t _ml_comidx;
+    phash_t _kwidx;
+    dfa_t _patdfa;
+
+    //! bracket roles of atoms: atom id -> <pair id, is opener>
+    std::unordered_map<size_t, std::pair<size_t, bool>> _brkatom;
+    brkt_idx_t _brkidx;
+
+    //! absolute positions of current and next line starts
+    size_t _line_start = 0;
+    size_t _next_line_start = 0;
+
+    bool _line_idx_on = false;
+    line_idx_t _lineidx;
+
+    //! tokens carry their absolute position only
+    bool _offsets_only = false;
+
+    //! input lines are validated as UTF-8
+    bool _utf8 = false;
+
+    //! token values are measured but not built (see stats())
+    bool _counts_only = false;
+
+    //! windowed scanning (enabled if _window > 0): lines are read in 
+    //! chunks, text already scanned is discarded; the window grows to 
+    //! fit a longer token up to _window_max
+    size_t _window = 0;
+    size_t _window_max = 0;
+    bool _line_complete = true;
+    bool _str_open = false;
+    bool _tkn_too_long = false;
+
+    //! multi-line comment delivery, and comment left open by a chunk
+    base_tknzr_t::comment_t _ml_com_mode = base_tknzr_t::comment_t::VALUE;
+    const tkn_idx_t::entry_t * _ml_com_open = nullptr;
+    size_t _line_shift = 0;
+    size_t _line_shift_cp = 0;
+
+    //! index of next token in the stream
+    size_t _tkn_index = 0;
+
+    //! runtime metrics, timing state of sampled calls (matcher being 
+    //! timed, time of its start and number of time readings)
+    tknzr_metrics_t _metrics;
+    size_t _mt_period = 1024;
+    size_t _mt_countdown = 0;
+    bool _mt_timing = false;
+    size_t _mt_matcher = 0;
+    uint64_t _mt_last = 0;
+    uint64_t _mt_reads = 0;
+
+    //! per-definition profile, and slots of definitions probed in vain 
+    //! by the last lookup
+    tknzr_profile_t _profile;
+    std::vector<size_t> _pf_failed;
+
+    //! memory accounting (enabled if a limit or a pool is set): bytes 
+    //! charged to the pool per kind, and whether a charge was refused
+    size_t _mem_limit = 0;
+    std::shared_ptr<mem_pool_t> _mem_pool;
+    mem_usage_t _mem_charged;
+    bool _mem_guard = false;
+    bool _mem_failed = false;
+
+    error_t _error = error_t::NONE;
+
+    //! consecutive blanks are merged into a single token
+    bool _blank_run = false;
+
+    //! indentation tracking (enabled if _tab_size > 0)
+    size_t _tab_size = 0;
+    std::vector<size_t> _indents;
+    size_t _dedent_pending = 0;
+    bool _indent_pending = false;
+    size_t _indent_width = 0;
+    bool _bad_indent = false;
+
+    //! number formats (from _numdef)
+    bool _num_dec = false;
+    bool _num_hex = false;
+    bool _num_oct = false;
+    bool _num_bin = false;
+    bool _num_float = false;
     std::map< char_t /*quote*/, std::shared_ptr<base_esc_cnvrtr_t > > _strdef;
 };
 
 
+/* -------------------------------------------------------------------------- */
+
+template <class Sink>
+bool tknzr_t::tokenize(_istream & is, Sink && sink)
+{
+    tkn_view_t tkn;
+
+    do {
+        if (!_scan(is, tkn)) {
+            return false;
+        }
+
+        if (!tkn_deliver(sink, tkn)) {
+            break;
+        }
+    } 
+    while (tkn.type != token_t::tcl_t::END_OF_FILE);
+
+    return true;
+}
+
+
 /* -------------------------------------------------------------------------- */
 
 } // namespace mip
@@ -20,6 +20,9 @@
 
 #include <cassert>
 #include <memory>
+#include <map>
+#include <set>
+#include <unordered_map>
 
 
 /* -------------------------------------------------------------------------- */
@@ -53,6 +56,49 @@ private:
         return true;
     }
 
+    template <class T, class M>
+    bool _def_item(const T& value, size_t id, M& map)
+    {
+        if (!_build_tknzr()) {
+            return false;
+        }
+
+        auto it = map.find(value);
+
+        if (it != map.end()) {
+            return false;
+        }
+
+        // ids identify definitions within their class
+        auto & ids = _ids[&map];
+
+        if (!ids.used.insert(id).second) {
+            return false;
+        }
+
+        if (id >= ids.next) {
+            ids.next = id + 1;
+        }
+
+        map.insert(std::make_pair(value, id));
+
+        return true;
+    }
+
+    //! Return the id given to a definition of a class without an 
+    //! explicit one: one above the highest id of the class
+    template <class M>
+    size_t _next_id(const M& map)
+    {
+        return _ids[&map].next;
+    }
+
+    template <class T, class U>
+    bool _def_item(const T& value, std::map<T, U>& map)
+    {
+        return _def_item(value, _next_id(map), map);
+    }
+
     template <class T, class S>
     bool _def_item(const std::set<T>& value_set, S& set)
     {
@@ -69,6 +115,16 @@ private:
 
     std::unique_ptr< tknzr_t > _tknzr;
 
+    //! ids used by the definitions of a class and the id of the next 
+    //! definition without an explicit one (one above the highest)
+    struct ids_t {
+        std::set<size_t> used;
+        size_t next = 0;
+    };
+
+    //! ids of each class of the tokenizer being built, by definition map
+    std::unordered_map<const void *, ids_t> _ids;
+
 public:
     tknzr_bldr_t() noexcept : _tknzr(new tknzr_t()) {
         assert(_tknzr);
@@ -76,19 +132,57 @@ public:
 
     std::unique_ptr< base_tknzr_t > build() override;
 
+    //! Build a tokenizer object exposing the concrete engine interface
+    //! (e.g. tknzr_t::tokenize())
+    std::unique_ptr< tknzr_t > build_engine();
+
+    //! Create a tokenizer from a grammar serialized by 
+    //! tknzr_t::save_grammar(), or return nullptr if the blob is invalid 
+    //! or was written by a different format version, byte order or char_t
+    static std::unique_ptr< tknzr_t > load_engine(
+        const char * data, size_t size);
+
+    //! Create a tokenizer from a grammar file (see load_engine())
+    static std::unique_ptr< tknzr_t > load_engine(const std::string & path);
+
     bool def_atom(const string_t& value) override;
+    bool def_atom(const string_t& value, size_t id) override;
     bool def_atom(const std::set<string_t>& value_set) override;
 
+    bool def_keyword(const string_t& value) override;
+    bool def_keyword(const string_t& value, size_t id) override;
+    bool def_keyword(const std::set<string_t>& value_set) override;
+
+    bool def_pattern(const string_t& pattern) override;
+    bool def_pattern(const string_t& pattern, size_t id) override;
+
+    bool def_bracket(const string_t& open, const string_t& close) override;
+
     bool def_blank(const string_t& value) override;
+    bool def_blank(const string_t& value, size_t id) override;
     bool def_blank(const std::set<string_t>& value_set) override;
+    bool def_blank_run(bool enable = true) override;
+    bool def_line_index(bool enable = true) override;
+    bool def_offsets_only(bool enable = true) override;
+    bool def_window(size_t size, size_t max_token = 0) override;
+    bool def_utf8(bool unicode_blanks = true) override;
 
     bool def_eol(const base_tknzr_t::eol_t& value) override;
     bool def_eol(const std::set<base_tknzr_t::eol_t>& value_set) override;
 
+    bool def_number(const base_tknzr_t::num_t& value) override;
+    bool def_number(const std::set<base_tknzr_t::num_t>& value_set) override;
+
     bool def_sl_comment(const string_t& prefix) override;
+    bool def_sl_comment(const string_t& prefix, size_t id) override;
     bool def_sl_comment(const std::set<string_t>& prefix_set) override;
 
     bool def_ml_comment(const string_t& begin, const string_t& end) override;
+    bool def_ml_comment(
+        const string_t& begin, const string_t& end, size_t id) override;
+    bool def_ml_comment_mode(base_tknzr_t::comment_t mode) override;
+
+    bool def_indent(size_t tab_size = 8) override;
 
     bool def_string(char_t quote, std::shared_ptr<base_esc_cnvrtr_t> et = nullptr) override;
 };
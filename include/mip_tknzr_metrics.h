@@ -0,0 +1,261 @@
+//  
+// This file is part of MipTknzr Library Project
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.  
+// Licensed under the MIT License. 
+// See COPYING file in the project root for full license information.
+//
+
+
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef __MIP_TKNZR_METRICS_H__
+#define __MIP_TKNZR_METRICS_H__
+
+
+/* -------------------------------------------------------------------------- */
+
+#include "mip_token.h"
+
+#include <array>
+#include <cstdint>
+
+
+/* -------------------------------------------------------------------------- */
+
+namespace mip {
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ *  Latency histogram with log-linear buckets (HDR-style): values below 
+ *  2^sub_bits nanoseconds have their own bucket, any power-of-two range 
+ *  above is split into 2^sub_bits buckets, so that a value is known 
+ *  within 1/2^sub_bits of its magnitude. Histograms can be merged by 
+ *  using operator +=
+ */
+struct latency_hist_t
+{
+    //! bits of linear sub-buckets per power of two
+    static const size_t sub_bits = 3;
+    static const size_t sub_cnt = size_t(1) << sub_bits;
+
+    //! number of buckets, covering the whole range of 64-bit values
+    static const size_t bucket_cnt = sub_cnt * (64 - sub_bits + 1);
+
+    //! number of values per bucket
+    std::array<uint64_t, bucket_cnt> counts{};
+
+    //! number of values, their sum and extremes
+    uint64_t total = 0;
+    uint64_t sum = 0;
+    uint64_t min = UINT64_MAX;
+    uint64_t max = 0;
+
+    //! Return the bucket of a value
+    static size_t bucket(uint64_t value) noexcept {
+        if (value < sub_cnt) {
+            return static_cast<size_t>(value);
+        }
+
+        size_t msb = 0;
+        for (auto v = value; v >>= 1;) {
+            ++msb;
+        }
+
+        const size_t shift = msb - sub_bits;
+        return (shift + 1) * sub_cnt + 
+            static_cast<size_t>((value >> shift) & (sub_cnt - 1));
+    }
+
+    //! Return the lowest value of a bucket
+    static uint64_t lowest(size_t b) noexcept {
+        if (b < sub_cnt) {
+            return b;
+        }
+
+        const size_t shift = b / sub_cnt - 1;
+        return (uint64_t(sub_cnt) + b % sub_cnt) << shift;
+    }
+
+    //! Add a value (in nanoseconds)
+    void record(uint64_t value) noexcept {
+        ++counts[bucket(value)];
+        ++total;
+        sum += value;
+
+        if (value < min) {
+            min = value;
+        }
+
+        if (value > max) {
+            max = value;
+        }
+    }
+
+    //! Return the average value
+    double mean() const noexcept {
+        return total ? double(sum) / double(total) : 0.0;
+    }
+
+    //! Return the value below which falls a given percentage (0-100) of 
+    //! values, with the precision of buckets (0 if empty)
+    uint64_t percentile(double pct) const noexcept {
+        if (!total) {
+            return 0;
+        }
+
+        auto rank = static_cast<uint64_t>(pct / 100.0 * double(total) + 0.5);
+        rank = rank < 1 ? 1 : rank > total ? total : rank;
+
+        uint64_t seen = 0;
+
+        for (size_t b = 0; b < bucket_cnt; ++b) {
+            seen += counts[b];
+
+            if (seen >= rank) {
+                // highest value of the bucket, bounded by the maximum
+                const uint64_t high = b + 1 < bucket_cnt ? 
+                    lowest(b + 1) - 1 : UINT64_MAX;
+
+                return high < max ? high : max;
+            }
+        }
+
+        return max;
+    }
+
+    //! Merge another histogram
+    latency_hist_t& operator+=(const latency_hist_t& other) noexcept {
+        for (size_t b = 0; b < bucket_cnt; ++b) {
+            counts[b] += other.counts[b];
+        }
+
+        total += other.total;
+        sum += other.sum;
+
+        if (other.min < min) {
+            min = other.min;
+        }
+
+        if (other.max > max) {
+            max = other.max;
+        }
+
+        return *this;
+    }
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ *  Runtime metrics of a tokenizer (see tknzr_t::metrics()), collected 
+ *  only if the library is built with MIP_TKNZR_METRICS defined (CMake 
+ *  option MIPTKNZR_METRICS). 
+ *  Counters are exact, while timings are taken for one scanning call 
+ *  every sampling period (see tknzr_t::set_metrics_sampling()). Metrics 
+ *  of different tokenizers can be merged by using operator +=
+ */
+struct tknzr_metrics_t
+{
+    //! number of token classes
+    static const size_t tcl_cnt = token_t::tcl_cnt;
+
+    //! Matchers whose time is measured
+    enum class matcher_t {
+        READ,       //!< reading of text lines
+        COMMENT,    //!< single-line and multi-line comments
+        BLANK,
+        NUMBER,
+        PATTERN,
+        ATOM,
+        STRING,
+        OTHER       //!< other tokens, end-of-line, end-of-file, indentation
+    };
+
+    //! number of matchers
+    static const size_t matcher_cnt = 8;
+
+    using counters_t = std::array<uint64_t, tcl_cnt>;
+    using timers_t = std::array<uint64_t, matcher_cnt>;
+
+    //! number of tokens per class
+    counters_t tokens{};
+
+    //! bytes of text read, end-of-line sequences included
+    uint64_t bytes_scanned = 0;
+
+    //! number of text lines read
+    uint64_t lines = 0;
+
+    //! number of reads from input streams (a line can be read in chunks
+    //! when windowed scanning is enabled)
+    uint64_t getline_calls = 0;
+
+    //! heap allocations made by the tokenizer: token objects and values 
+    //! built by next(), growth of line and value buffers
+    uint64_t allocations = 0;
+
+    //! bytes copied into token values: values of token objects built by 
+    //! next(), converted strings and comments spanning several lines
+    uint64_t bytes_copied = 0;
+
+    //! number of scanning calls timed, and nanoseconds spent by each 
+    //! matcher during those calls
+    uint64_t sampled = 0;
+    timers_t matcher_ns{};
+
+    //! nanoseconds spent scanning a token by timed calls (of next() or 
+    //! scan(), or for a token delivered by tokenize())
+    latency_hist_t latency;
+
+    //! Return total number of tokens
+    uint64_t total() const noexcept {
+        uint64_t res = 0;
+
+        for (const auto & cnt : tokens) {
+            res += cnt;
+        }
+
+        return res;
+    }
+
+    //! Return nanoseconds spent by a given matcher during timed calls
+    uint64_t time(matcher_t m) const noexcept {
+        return matcher_ns[static_cast<size_t>(m)];
+    }
+
+    //! Merge metrics of another tokenizer
+    tknzr_metrics_t& operator+=(const tknzr_metrics_t& other) noexcept {
+        for (size_t cl = 0; cl < tcl_cnt; ++cl) {
+            tokens[cl] += other.tokens[cl];
+        }
+
+        for (size_t m = 0; m < matcher_cnt; ++m) {
+            matcher_ns[m] += other.matcher_ns[m];
+        }
+
+        bytes_scanned += other.bytes_scanned;
+        lines += other.lines;
+        getline_calls += other.getline_calls;
+        allocations += other.allocations;
+        bytes_copied += other.bytes_copied;
+        sampled += other.sampled;
+        latency += other.latency;
+
+        return *this;
+    }
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+} // namespace mip
+
+
+/* -------------------------------------------------------------------------- */
+
+#endif // __MIP_TKNZR_METRICS_H__
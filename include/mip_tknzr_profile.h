@@ -0,0 +1,151 @@
+//  
+// This file is part of MipTknzr Library Project
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.  
+// Licensed under the MIT License. 
+// See COPYING file in the project root for full license information.
+//
+
+
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef __MIP_TKNZR_PROFILE_H__
+#define __MIP_TKNZR_PROFILE_H__
+
+
+/* -------------------------------------------------------------------------- */
+
+#include "mip_token.h"
+
+#include <cstdint>
+#include <vector>
+
+
+/* -------------------------------------------------------------------------- */
+
+namespace mip {
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ *  Cost profile of a single definition: a blank, an atom, a single-line 
+ *  comment prefix, a multi-line comment pair or a string quote.
+ *  A definition is probed whenever it is compared against the text, 
+ *  which happens for any definition sharing the first character of the 
+ *  text, from the longest to the shortest one, until one matches
+ */
+struct def_profile_t
+{
+    //! class of tokens of the definition (BLANK, ATOM, COMMENT, STRING)
+    token_t::tcl_t type = token_t::tcl_t::OTHER;
+
+    //! definition: blank, atom, comment prefix or opener, or quote
+    string_t value;
+
+    //! terminator of a multi-line comment, empty otherwise
+    string_t tail;
+
+    //! definition id (token_t::npos for quotes)
+    size_t id = token_t::npos;
+
+    //! number of times compared against the text
+    uint64_t probes = 0;
+
+    //! number of probes matching the text (for quotes, the ones which 
+    //! scanned a whole string)
+    uint64_t hits = 0;
+
+    //! failed probes of lookups matched by another definition, i.e. 
+    //! extra work caused by a longer definition sharing the same prefix
+    uint64_t collisions = 0;
+
+    //! nanoseconds spent matching tokens of this definition (scanning 
+    //! of string bodies and comment terminators included)
+    uint64_t hit_ns = 0;
+
+    //! nanoseconds of lookups matching no definition, charged evenly to 
+    //! the definitions probed in vain
+    uint64_t miss_ns = 0;
+
+    //! Return number of failed probes
+    uint64_t misses() const noexcept {
+        return probes - hits;
+    }
+
+    //! Return the rate of probes matching the text (0-1)
+    double hit_rate() const noexcept {
+        return probes ? double(hits) / double(probes) : 0.0;
+    }
+
+    //! Return nanoseconds charged to this definition
+    uint64_t ns() const noexcept {
+        return hit_ns + miss_ns;
+    }
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ *  Per-definition cost profile of a tokenizer (see tknzr_t::profile()), 
+ *  collected only if the library is built with MIP_TKNZR_PROFILE defined
+ *  (CMake option MIPTKNZR_PROFILE). 
+ *  Counters are exact, while any lookup probing a definition is timed, 
+ *  so that timings include a few tens of nanoseconds of clock reading 
+ *  per lookup less their estimated cost.
+ *  Profiles of tokenizers built alike can be merged by using operator +=
+ */
+struct tknzr_profile_t
+{
+    //! definitions in the order blanks, atoms, single-line comments, 
+    //! multi-line comments and quotes
+    std::vector<def_profile_t> defs;
+
+    //! number of lookups probing at least a definition, and the ones 
+    //! matching none
+    uint64_t lookups = 0;
+    uint64_t failed_lookups = 0;
+
+    //! Return nanoseconds charged to all definitions
+    uint64_t ns() const noexcept {
+        uint64_t res = 0;
+
+        for (const auto & def : defs) {
+            res += def.ns();
+        }
+
+        return res;
+    }
+
+    //! Merge the profile of a tokenizer having the same definitions
+    tknzr_profile_t& operator+=(const tknzr_profile_t& other) noexcept {
+        if (defs.size() != other.defs.size()) {
+            return *this;
+        }
+
+        for (size_t i = 0; i < defs.size(); ++i) {
+            defs[i].probes += other.defs[i].probes;
+            defs[i].hits += other.defs[i].hits;
+            defs[i].collisions += other.defs[i].collisions;
+            defs[i].hit_ns += other.defs[i].hit_ns;
+            defs[i].miss_ns += other.defs[i].miss_ns;
+        }
+
+        lookups += other.lookups;
+        failed_lookups += other.failed_lookups;
+
+        return *this;
+    }
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+} // namespace mip
+
+
+/* -------------------------------------------------------------------------- */
+
+#endif // __MIP_TKNZR_PROFILE_H__
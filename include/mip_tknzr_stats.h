@@ -0,0 +1,128 @@
+//  
+// This file is part of MipTknzr Library Project
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.  
+// Licensed under the MIT License. 
+// See COPYING file in the project root for full license information.
+//
+
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef __MIP_TKNZR_STATS_H__
+#define __MIP_TKNZR_STATS_H__
+
+
+/* -------------------------------------------------------------------------- */
+
+#include "mip_token.h"
+
+#include <array>
+
+
+/* -------------------------------------------------------------------------- */
+
+namespace mip {
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ *  Aggregate statistics collected by scanning an input stream without
+ *  building any token object. Statistics of different inputs (e.g. scanned
+ *  by different threads) can be merged by using operator +=
+ */
+struct tknzr_stats_t
+{
+    //! number of token classes
+    static const size_t tcl_cnt = token_t::tcl_cnt;
+
+    //! number of buckets of length histograms: bucket n (n>0) holds
+    //! tokens whose length is in the range [2^(n-1), 2^n)
+    static const size_t hist_cnt = 32;
+
+    using counters_t = std::array<size_t, tcl_cnt>;
+    using histogram_t = std::array<size_t, hist_cnt>;
+
+    //! number of tokens per class
+    counters_t tokens{};
+
+    //! sum of token lengths per class
+    counters_t length{};
+
+    //! longest token length per class
+    counters_t longest{};
+
+    //! token length histograms per class
+    std::array<histogram_t, tcl_cnt> histogram{};
+
+    //! number of text lines
+    size_t lines = 0;
+
+    //! Account a token of given class and length
+    void count(token_t::tcl_t type, size_t size) noexcept {
+        const auto cl = static_cast<size_t>(type);
+
+        ++tokens[cl];
+        length[cl] += size;
+
+        if (size > longest[cl]) {
+            longest[cl] = size;
+        }
+
+        size_t bucket = 0;
+        while (size && bucket < hist_cnt - 1) {
+            size >>= 1;
+            ++bucket;
+        }
+
+        ++histogram[cl][bucket];
+    }
+
+    //! Return total number of tokens
+    size_t total() const noexcept {
+        size_t res = 0;
+
+        for (const auto & cnt : tokens) {
+            res += cnt;
+        }
+
+        return res;
+    }
+
+    //! Return average token length of a given class
+    double average(token_t::tcl_t type) const noexcept {
+        const auto cl = static_cast<size_t>(type);
+        return tokens[cl] ? double(length[cl]) / double(tokens[cl]) : 0.0;
+    }
+
+    //! Merge statistics of another input
+    tknzr_stats_t& operator+=(const tknzr_stats_t& other) noexcept {
+        for (size_t cl = 0; cl < tcl_cnt; ++cl) {
+            tokens[cl] += other.tokens[cl];
+            length[cl] += other.length[cl];
+
+            if (other.longest[cl] > longest[cl]) {
+                longest[cl] = other.longest[cl];
+            }
+
+            for (size_t b = 0; b < hist_cnt; ++b) {
+                histogram[cl][b] += other.histogram[cl][b];
+            }
+        }
+
+        lines += other.lines;
+
+        return *this;
+    }
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+} // namespace mip
+
+
+/* -------------------------------------------------------------------------- */
+
+#endif // __MIP_TKNZR_STATS_H__
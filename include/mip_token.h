@@ -19,7 +19,7 @@
 
 #include <string>
 #include <ostream>
-#include <string>
+#include <cstdint>
 
 
 /* -------------------------------------------------------------------------- */
@@ -27,11 +27,33 @@
 namespace mip {
 
 
+/* -------------------------------------------------------------------------- */
+
+//! Value of number tokens, parsed while scanning
+struct numval_t {
+    //! true if value is a floating point number
+    bool floating = false;
+
+    //! true if value is out of range (integer is then set to its 
+    //! maximum value, real to infinity)
+    bool overflow = false;
+
+    //! value of integer numbers
+    uint64_t integer = 0;
+
+    //! value of floating point numbers
+    double real = 0.0;
+};
+
+
 /* -------------------------------------------------------------------------- */
 
 class token_t
 {
 public:
+    //! Invalid id
+    static const size_t npos = static_cast<size_t>(-1);
+
     enum class tcl_t {
         BLANK,
         END_OF_LINE,
@@ -39,16 +61,32 @@ public:
         COMMENT,
         STRING,
         ATOM,
-        OTHER
+        OTHER,
+        KEYWORD,
+        PATTERN,
+        NUMBER,
+        INDENT,
+        DEDENT
     };
 
+    //! number of token classes
+    static const size_t tcl_cnt = static_cast<size_t>(tcl_t::DEDENT) + 1;
+
+
     token_t(
         const tcl_t& type,
         const string_t& value,
         size_t line,
         size_t column,
         char_t quote = 0,
-        char_t esc = 0)
+        char_t esc = 0,
+        size_t sym = npos,
+        size_t id = npos,
+        const numval_t & num = numval_t(),
+        size_t index = 0,
+        size_t pos = 0,
+        size_t end = 0,
+        size_t width = 0)
         noexcept
         :
         _type(type),
@@ -56,7 +94,14 @@ public:
         _line(line),
         _offset(column),
         _quote(quote),
-        _esc(esc)
+        _esc(esc),
+        _sym(sym),
+        _id(id),
+        _num(num),
+        _index(index),
+        _pos(pos),
+        _end(end),
+        _width(width)
     {}
 
     //! return quote and escape sequence prefix
@@ -84,6 +129,43 @@ public:
         return _offset;
     }
 
+    //! return the symbol id of an interned token value or npos
+    size_t sym() const noexcept {
+        return _sym;
+    }
+
+    //! return the id of the matched atom, keyword, pattern, blank or 
+    //! comment definition or npos
+    size_t id() const noexcept {
+        return _id;
+    }
+
+    //! return the value of a number token
+    const numval_t & num() const noexcept {
+        return _num;
+    }
+
+    //! return the index of the token in the stream (first token -> 0)
+    size_t index() const noexcept {
+        return _index;
+    }
+
+    //! return the absolute position of the token in the input
+    size_t pos() const noexcept {
+        return _pos;
+    }
+
+    //! return the absolute position of the input following the token
+    size_t end() const noexcept {
+        return _end;
+    }
+
+    //! return the width of the indentation level opened by an indent 
+    //! token or closed by a dedent token
+    size_t width() const noexcept {
+        return _width;
+    }
+
 
     friend _ostream& operator<<(_ostream& os, token_t& tkn);
 
@@ -108,6 +190,26 @@ private:
     //! escape sequence prefix; defined for token representing string
     char_t _esc = 0;
 
+    //! symbol id (see symtbl_t)
+    size_t _sym = npos;
+
+    //! definition id (see tknzr_bldr_t)
+    size_t _id = npos;
+
+    //! value of number token
+    numval_t _num;
+
+    //! index of the token in the stream
+    size_t _index = 0;
+
+    //! absolute position of the token in the input
+    size_t _pos = 0;
+
+    //! absolute position of the input following the token
+    size_t _end = 0;
+
+    //! indentation width of indent and dedent tokens
+    size_t _width = 0;
 };
 
 
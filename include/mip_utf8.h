@@ -0,0 +1,57 @@
+//  
+// This file is part of MipTknzr Library Project
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.  
+// Licensed under the MIT License. 
+// See COPYING file in the project root for full license information.
+//
+
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef __MIP_UTF8_H__
+#define __MIP_UTF8_H__
+
+
+/* -------------------------------------------------------------------------- */
+
+#include <cstddef>
+#include <set>
+#include <string>
+
+
+/* -------------------------------------------------------------------------- */
+
+namespace mip {
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ *  Helpers for tokenizing raw UTF-8 text with the narrow character engine. 
+ *  ASCII runs are processed a machine word at a time.
+ */
+class utf8_t {
+public:
+    //! Return true if the given bytes are well-formed UTF-8 
+    //! (no overlong forms, surrogates or code points beyond U+10FFFF)
+    static bool valid(const char * data, size_t size) noexcept;
+
+    //! Return the number of code points encoded by the given bytes
+    static size_t length(const char * data, size_t size) noexcept;
+
+    //! Return the UTF-8 encoding of the non-ASCII Unicode white space 
+    //! characters (U+0085, U+00A0, U+1680, U+2000-U+200A, U+2028, U+2029,
+    //! U+202F, U+205F, U+3000)
+    static const std::set<std::string> & blanks();
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+} // namespace mip
+
+
+/* -------------------------------------------------------------------------- */
+
+#endif // __MIP_UTF8_H__
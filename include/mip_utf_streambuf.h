@@ -0,0 +1,236 @@
+//  
+// This file is part of MipTknzr Library Project
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.  
+// Licensed under the MIT License. 
+// See COPYING file in the project root for full license information.
+//
+
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef __MIP_UTF_STREAMBUF_H__
+#define __MIP_UTF_STREAMBUF_H__
+
+
+/* -------------------------------------------------------------------------- */
+
+#include <algorithm>
+#include <cstdint>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+
+/* -------------------------------------------------------------------------- */
+
+namespace mip {
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ *  Input stream buffer presenting a stream of wide code units (UTF-16 for 
+ *  2-byte, UTF-32 for 4-byte types, e.g. char16_t, char32_t, wchar_t) as 
+ *  UTF-8 bytes, so that a single narrow build of the tokenizer, in UTF-8 
+ *  mode (see tknzr_bldr_t::def_utf8()), can scan inputs of any width.
+ *  Code units are encoded while read, a buffer at a time: the input is 
+ *  never converted as a whole. Ill-formed sequences produce U+FFFD.
+ *
+ *  Token positions (tkn_view_t::pos, end, offset) are then UTF-8 byte 
+ *  offsets of the transcoded stream, not source code unit offsets. If 
+ *  created with map_positions set, the buffer records where the two 
+ *  diverge (one entry per non-ASCII code point) so that source_pos() can 
+ *  map them back.
+ */
+template<class CharT>
+class utf8_streambuf_t : public std::streambuf {
+public:
+    using source_t = std::basic_streambuf<CharT>;
+
+    explicit utf8_streambuf_t(
+        source_t * source, bool map_positions = false) noexcept 
+        :
+        _source(source),
+        _map_on(map_positions)
+    {}
+
+    utf8_streambuf_t(const utf8_streambuf_t&) = delete;
+    utf8_streambuf_t& operator=(const utf8_streambuf_t&) = delete;
+
+    //! Return the source code unit position of a UTF-8 byte position 
+    //! of the transcoded stream which starts a code point (such as a 
+    //! token position); requires map_positions
+    size_t source_pos(size_t pos) const noexcept {
+        auto it = std::upper_bound(
+            _map.begin(), _map.end(), pos, 
+            [](size_t p, const mark_t & m) { return p < m.bytes; });
+
+        if (it == _map.begin()) {
+            return pos;
+        }
+
+        --it;
+
+        return it->units + (pos - it->bytes);
+    }
+
+protected:
+    int_type underflow() override {
+        if (gptr() < egptr()) {
+            return traits_type::to_int_type(*gptr());
+        }
+
+        size_t size = 0;
+
+        while (_source && size + 4 <= sizeof(_buf)) {
+            uint32_t cp = 0;
+            const size_t units = _units - (_has_pending ? 1 : 0);
+
+            if (!_next_cp(cp)) {
+                break;
+            }
+
+            const size_t len = _encode(cp, _buf + size);
+            size += len;
+            _bytes += len;
+
+            if (_map_on) {
+                const size_t end = _units - (_has_pending ? 1 : 0);
+
+                if (end - units != len) {
+                    _map.push_back(mark_t{ _bytes, end });
+                }
+            }
+        }
+
+        if (size == 0) {
+            return traits_type::eof();
+        }
+
+        setg(_buf, _buf, _buf + size);
+
+        return traits_type::to_int_type(*gptr());
+    }
+
+private:
+    using src_traits_t = typename source_t::traits_type;
+
+    static const uint32_t _replacement = 0xFFFD;
+
+    //! end of a code point whose encoding length differs from the 
+    //! number of its source code units
+    struct mark_t {
+        size_t bytes;
+        size_t units;
+    };
+
+    //! get next code unit from the source
+    bool _next_unit(uint32_t & unit) {
+        const auto ich = _source->sbumpc();
+
+        if (src_traits_t::eq_int_type(ich, src_traits_t::eof())) {
+            return false;
+        }
+
+        ++_units;
+
+        unit = static_cast<uint32_t>(src_traits_t::to_char_type(ich));
+
+        if (sizeof(CharT) == 2) {
+            unit &= 0xFFFF;
+        }
+
+        return true;
+    }
+
+    //! decode next code point from the source
+    bool _next_cp(uint32_t & cp) {
+        if (_has_pending) {
+            _has_pending = false;
+            cp = _pending;
+        }
+        else if (!_next_unit(cp)) {
+            return false;
+        }
+
+        if (sizeof(CharT) != 2) {
+            if (cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) {
+                cp = _replacement;
+            }
+
+            return true;
+        }
+
+        // UTF-16 surrogate pairs
+        if (cp >= 0xDC00 && cp <= 0xDFFF) {
+            cp = _replacement;
+        }
+        else if (cp >= 0xD800 && cp <= 0xDBFF) {
+            uint32_t low = 0;
+
+            if (!_next_unit(low)) {
+                cp = _replacement;
+            }
+            else if (low < 0xDC00 || low > 0xDFFF) {
+                _pending = low;
+                _has_pending = true;
+                cp = _replacement;
+            }
+            else {
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+            }
+        }
+
+        return true;
+    }
+
+    //! encode a code point returning the number of bytes written
+    static size_t _encode(uint32_t cp, char * out) noexcept {
+        if (cp < 0x80) {
+            out[0] = static_cast<char>(cp);
+            return 1;
+        }
+
+        if (cp < 0x800) {
+            out[0] = static_cast<char>(0xC0 | (cp >> 6));
+            out[1] = static_cast<char>(0x80 | (cp & 0x3F));
+            return 2;
+        }
+
+        if (cp < 0x10000) {
+            out[0] = static_cast<char>(0xE0 | (cp >> 12));
+            out[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out[2] = static_cast<char>(0x80 | (cp & 0x3F));
+            return 3;
+        }
+
+        out[0] = static_cast<char>(0xF0 | (cp >> 18));
+        out[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out[3] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 4;
+    }
+
+    source_t * _source = nullptr;
+    uint32_t _pending = 0;
+    bool _has_pending = false;
+    char _buf[4096];
+
+    //! code units read and bytes produced so far
+    size_t _units = 0;
+    size_t _bytes = 0;
+
+    bool _map_on = false;
+    std::vector<mark_t> _map;
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+} // namespace mip
+
+
+/* -------------------------------------------------------------------------- */
+
+#endif // __MIP_UTF_STREAMBUF_H__
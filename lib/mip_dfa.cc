@@ -0,0 +1,678 @@
+//  
+// This file is part of MipTknzr Library Project
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.  
+// Licensed under the MIT License. 
+// See COPYING file in the project root for full license information.
+//
+
+
+/* -------------------------------------------------------------------------- */
+
+#include "mip_dfa.h"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+
+
+/* -------------------------------------------------------------------------- */
+
+namespace mip {
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Recursive descent parser building the NFA of a pattern
+class dfa_t::parser_t {
+public:
+    parser_t(const string_t & pattern, std::vector<nfa_state_t> & nfa) :
+        _pattern(pattern),
+        _nfa(nfa)
+    {}
+
+    bool parse(frag_t & frag) {
+        return _alt(frag) && _pos == _pattern.size();
+    }
+
+private:
+    static uint32_t _max_ch() noexcept {
+        return std::numeric_limits<uchar_t>::max();
+    }
+
+    bool _eop() const noexcept {
+        return _pos >= _pattern.size();
+    }
+
+    char_t _peek() const noexcept {
+        return _pattern[_pos];
+    }
+
+    size_t _new_state() {
+        _nfa.push_back(nfa_state_t());
+        return _nfa.size() - 1;
+    }
+
+    static uint32_t _code(char_t ch) noexcept {
+        return static_cast<uint32_t>(static_cast<uchar_t>(ch));
+    }
+
+    static void _normalize(ranges_t & ranges) {
+        std::sort(ranges.begin(), ranges.end());
+
+        ranges_t res;
+
+        for (const auto & r : ranges) {
+            if (!res.empty() && 
+                (res.back().second == _max_ch() || r.first <= res.back().second + 1)) 
+            {
+                res.back().second = std::max(res.back().second, r.second);
+            }
+            else {
+                res.push_back(r);
+            }
+        }
+
+        ranges.swap(res);
+    }
+
+    static void _complement(ranges_t & ranges) {
+        _normalize(ranges);
+
+        ranges_t res;
+        uint32_t next = 0;
+        bool done = false;
+
+        for (const auto & r : ranges) {
+            if (r.first > next) {
+                res.push_back(range_t(next, r.first - 1));
+            }
+
+            if (r.second == _max_ch()) {
+                done = true;
+                break;
+            }
+
+            next = r.second + 1;
+        }
+
+        if (!done) {
+            res.push_back(range_t(next, _max_ch()));
+        }
+
+        ranges.swap(res);
+    }
+
+    //! Parse an escape sequence (following the '\')
+    bool _escape(ranges_t & ranges) {
+        if (_eop()) {
+            return false;
+        }
+
+        const char_t ch = _pattern[_pos++];
+        ranges_t cl;
+
+        switch (ch) {
+        case _T('d'): case _T('D'):
+            cl.push_back(range_t(_code(_T('0')), _code(_T('9'))));
+            break;
+        case _T('w'): case _T('W'):
+            cl.push_back(range_t(_code(_T('0')), _code(_T('9'))));
+            cl.push_back(range_t(_code(_T('A')), _code(_T('Z'))));
+            cl.push_back(range_t(_code(_T('a')), _code(_T('z'))));
+            cl.push_back(range_t(_code(_T('_')), _code(_T('_'))));
+            break;
+        case _T('s'): case _T('S'):
+            cl.push_back(range_t(_code(_T('\t')), _code(_T('\r'))));
+            cl.push_back(range_t(_code(_T(' ')), _code(_T(' '))));
+            break;
+        case _T('n'):
+            cl.push_back(range_t(_code(_T('\n')), _code(_T('\n'))));
+            break;
+        case _T('t'):
+            cl.push_back(range_t(_code(_T('\t')), _code(_T('\t'))));
+            break;
+        case _T('r'):
+            cl.push_back(range_t(_code(_T('\r')), _code(_T('\r'))));
+            break;
+        case _T('f'):
+            cl.push_back(range_t(_code(_T('\f')), _code(_T('\f'))));
+            break;
+        case _T('v'):
+            cl.push_back(range_t(_code(_T('\v')), _code(_T('\v'))));
+            break;
+        default:
+            cl.push_back(range_t(_code(ch), _code(ch)));
+            break;
+        }
+
+        if (ch == _T('D') || ch == _T('W') || ch == _T('S')) {
+            _complement(cl);
+        }
+
+        ranges.insert(ranges.end(), cl.begin(), cl.end());
+
+        return true;
+    }
+
+    //! Parse a character class (following the '[')
+    bool _class(ranges_t & ranges) {
+        bool negate = false;
+
+        if (!_eop() && _peek() == _T('^')) {
+            negate = true;
+            ++_pos;
+        }
+
+        bool first = true;
+
+        while (!_eop() && (first || _peek() != _T(']'))) {
+            first = false;
+
+            char_t ch = _pattern[_pos++];
+
+            if (ch == _T('\\')) {
+                ranges_t esc;
+
+                if (!_escape(esc)) {
+                    return false;
+                }
+
+                if (esc.size() != 1 || esc[0].first != esc[0].second) {
+                    ranges.insert(ranges.end(), esc.begin(), esc.end());
+                    continue;
+                }
+
+                ch = static_cast<char_t>(esc[0].first);
+            }
+
+            uint32_t lo = _code(ch);
+            uint32_t hi = lo;
+
+            if (_pos + 1 < _pattern.size() && 
+                _peek() == _T('-') && 
+                _pattern[_pos + 1] != _T(']')) 
+            {
+                ++_pos;
+                char_t hi_ch = _pattern[_pos++];
+
+                if (hi_ch == _T('\\')) {
+                    ranges_t esc;
+
+                    if (!_escape(esc) || 
+                        esc.size() != 1 || 
+                        esc[0].first != esc[0].second) 
+                    {
+                        return false;
+                    }
+
+                    hi_ch = static_cast<char_t>(esc[0].first);
+                }
+
+                hi = _code(hi_ch);
+
+                if (hi < lo) {
+                    return false;
+                }
+            }
+
+            ranges.push_back(range_t(lo, hi));
+        }
+
+        if (_eop()) {
+            return false;
+        }
+
+        ++_pos; // ']'
+
+        if (negate) {
+            _complement(ranges);
+        }
+        else {
+            _normalize(ranges);
+        }
+
+        return !ranges.empty();
+    }
+
+    bool _atom(frag_t & frag) {
+        if (_eop()) {
+            return false;
+        }
+
+        const char_t ch = _pattern[_pos++];
+        ranges_t ranges;
+
+        switch (ch) {
+        case _T('('):
+            if (!_alt(frag) || _eop() || _peek() != _T(')')) {
+                return false;
+            }
+            ++_pos;
+            return true;
+
+        case _T('['):
+            if (!_class(ranges)) {
+                return false;
+            }
+            break;
+
+        case _T('.'):
+            ranges.push_back(range_t(0, _max_ch()));
+            break;
+
+        case _T('\\'):
+            if (!_escape(ranges)) {
+                return false;
+            }
+            _normalize(ranges);
+            break;
+
+        case _T(')'): case _T('|'): case _T('*'): case _T('+'): case _T('?'):
+            return false;
+
+        default:
+            ranges.push_back(range_t(_code(ch), _code(ch)));
+            break;
+        }
+
+        frag.begin = _new_state();
+        frag.end = _new_state();
+
+        _nfa[frag.begin].ranges.swap(ranges);
+        _nfa[frag.begin].next = frag.end;
+
+        return true;
+    }
+
+    bool _rep(frag_t & frag) {
+        if (!_atom(frag)) {
+            return false;
+        }
+
+        while (!_eop()) {
+            const char_t op = _peek();
+
+            if (op != _T('*') && op != _T('+') && op != _T('?')) {
+                break;
+            }
+
+            ++_pos;
+
+            const auto begin = _new_state();
+            const auto end = _new_state();
+
+            _nfa[begin].eps.push_back(frag.begin);
+            _nfa[frag.end].eps.push_back(end);
+
+            if (op != _T('+')) {
+                _nfa[begin].eps.push_back(end);
+            }
+
+            if (op != _T('?')) {
+                _nfa[frag.end].eps.push_back(frag.begin);
+            }
+
+            frag.begin = begin;
+            frag.end = end;
+        }
+
+        return true;
+    }
+
+    bool _seq(frag_t & frag) {
+        frag.begin = frag.end = _new_state();
+
+        while (!_eop() && _peek() != _T('|') && _peek() != _T(')')) {
+            frag_t next;
+
+            if (!_rep(next)) {
+                return false;
+            }
+
+            _nfa[frag.end].eps.push_back(next.begin);
+            frag.end = next.end;
+        }
+
+        return true;
+    }
+
+    bool _alt(frag_t & frag) {
+        if (!_seq(frag)) {
+            return false;
+        }
+
+        while (!_eop() && _peek() == _T('|')) {
+            ++_pos;
+
+            frag_t other;
+
+            if (!_seq(other)) {
+                return false;
+            }
+
+            const auto begin = _new_state();
+            const auto end = _new_state();
+
+            _nfa[begin].eps.push_back(frag.begin);
+            _nfa[begin].eps.push_back(other.begin);
+            _nfa[frag.end].eps.push_back(end);
+            _nfa[other.end].eps.push_back(end);
+
+            frag.begin = begin;
+            frag.end = end;
+        }
+
+        return true;
+    }
+
+    const string_t & _pattern;
+    size_t _pos = 0;
+    std::vector<nfa_state_t> & _nfa;
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+void dfa_t::_closure(std::vector<size_t> & states) const
+{
+    std::vector<bool> in_set(_nfa.size(), false);
+    std::vector<size_t> stack(states);
+
+    for (const auto s : states) {
+        in_set[s] = true;
+    }
+
+    while (!stack.empty()) {
+        const auto s = stack.back();
+        stack.pop_back();
+
+        for (const auto next : _nfa[s].eps) {
+            if (!in_set[next]) {
+                in_set[next] = true;
+                states.push_back(next);
+                stack.push_back(next);
+            }
+        }
+    }
+
+    std::sort(states.begin(), states.end());
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool dfa_t::add(const string_t & pattern, size_t id)
+{
+    const auto nfa_size = _nfa.size();
+
+    frag_t frag;
+    parser_t parser(pattern, _nfa);
+
+    bool ok = parser.parse(frag);
+
+    if (ok) {
+        std::vector<size_t> states{ frag.begin };
+        _closure(states);
+
+        // reject patterns matching an empty string
+        ok = std::find(states.begin(), states.end(), frag.end) == states.end();
+    }
+
+    if (!ok) {
+        _nfa.resize(nfa_size);
+        return false;
+    }
+
+    _nfa[frag.end].accept = id;
+    _nfa_begin.push_back(frag.begin);
+
+    return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool dfa_t::valid(const string_t & pattern)
+{
+    dfa_t dfa;
+    return dfa.add(pattern, 0);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+void dfa_t::clear()
+{
+    _nfa.clear();
+    _nfa_begin.clear();
+    _class_cnt = 0;
+    _bounds.clear();
+    _low_class.fill(-1);
+    _trans.clear();
+    _accept.clear();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+void dfa_t::save(blob_writer_t & out) const
+{
+    out.put_size(_class_cnt);
+    out.put_vec(_bounds);
+    out.put(_low_class);
+    out.put_vec(_trans);
+    out.put_size(_accept.size());
+
+    for (const auto & id : _accept) {
+        out.put(id == npos ? uint64_t(-1) : static_cast<uint64_t>(id));
+    }
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool dfa_t::load(blob_reader_t & in)
+{
+    clear();
+
+    size_t state_cnt = 0;
+
+    if (!in.get_size(_class_cnt) ||
+        !in.get_vec(_bounds) ||
+        !in.get(_low_class) ||
+        !in.get_vec(_trans) ||
+        !in.get_size(state_cnt) ||
+        _trans.size() != state_cnt * _class_cnt ||
+        _bounds.size() != _class_cnt)
+    {
+        clear();
+        return false;
+    }
+
+    _accept.resize(state_cnt);
+
+    for (auto & id : _accept) {
+        uint64_t value = 0;
+
+        if (!in.get(value)) {
+            clear();
+            return false;
+        }
+
+        id = value == uint64_t(-1) ? npos : static_cast<size_t>(value);
+    }
+
+    // reject tables which would make match() run out of bounds
+    for (const auto & next : _trans) {
+        if (next >= static_cast<int64_t>(state_cnt)) {
+            clear();
+            return false;
+        }
+    }
+
+    for (const auto & cl : _low_class) {
+        if (cl >= static_cast<int64_t>(_class_cnt)) {
+            clear();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+int32_t dfa_t::_high_class(uint32_t ch) const noexcept
+{
+    auto it = std::upper_bound(_bounds.begin(), _bounds.end(), ch);
+
+    if (it == _bounds.begin()) {
+        return -1;
+    }
+
+    return static_cast<int32_t>(it - _bounds.begin() - 1);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool dfa_t::build()
+{
+    const size_t max_states = 1 << 16;
+
+    _trans.clear();
+    _accept.clear();
+    _bounds.clear();
+    _low_class.fill(-1);
+    _class_cnt = 0;
+
+    if (_nfa_begin.empty()) {
+        return true;
+    }
+
+    // split the alphabet into classes of equivalent characters: 
+    // class k holds the characters in [_bounds[k], _bounds[k + 1])
+    for (const auto & s : _nfa) {
+        for (const auto & r : s.ranges) {
+            _bounds.push_back(r.first);
+
+            if (r.second < std::numeric_limits<uint32_t>::max()) {
+                _bounds.push_back(r.second + 1);
+            }
+        }
+    }
+
+    std::sort(_bounds.begin(), _bounds.end());
+    _bounds.erase(std::unique(_bounds.begin(), _bounds.end()), _bounds.end());
+
+    _class_cnt = _bounds.size();
+
+    for (uint32_t ch = 0; ch < _low_class.size(); ++ch) {
+        _low_class[ch] = _high_class(ch);
+    }
+
+    // classes matched by the character edge of each NFA state
+    std::vector<std::vector<size_t>> edge_classes(_nfa.size());
+
+    for (size_t s = 0; s < _nfa.size(); ++s) {
+        for (const auto & r : _nfa[s].ranges) {
+            const auto first = _high_class(r.first);
+
+            for (size_t cl = first; cl < _class_cnt; ++cl) {
+                if (_bounds[cl] > r.second) {
+                    break;
+                }
+
+                edge_classes[s].push_back(cl);
+            }
+        }
+    }
+
+    // subset construction
+    std::map<std::vector<size_t>, size_t> dstates;
+    std::vector<std::vector<size_t>> todo;
+
+    auto add_state = [&](std::vector<size_t> & set) -> size_t {
+        auto it = dstates.find(set);
+
+        if (it != dstates.end()) {
+            return it->second;
+        }
+
+        const auto id = _accept.size();
+
+        size_t accept = npos;
+
+        for (const auto s : set) {
+            if (_nfa[s].accept < accept) {
+                accept = _nfa[s].accept;
+            }
+        }
+
+        _accept.push_back(accept);
+        _trans.resize(_trans.size() + _class_cnt, -1);
+
+        dstates[set] = id;
+        todo.push_back(set);
+
+        return id;
+    };
+
+    std::vector<size_t> start(_nfa_begin);
+    _closure(start);
+    add_state(start);
+
+    std::vector<std::vector<size_t>> moves(_class_cnt);
+
+    while (!todo.empty()) {
+        auto set = todo.back();
+        todo.pop_back();
+
+        const auto from = dstates[set];
+
+        for (auto & m : moves) {
+            m.clear();
+        }
+
+        for (const auto s : set) {
+            for (const auto cl : edge_classes[s]) {
+                moves[cl].push_back(_nfa[s].next);
+            }
+        }
+
+        for (size_t cl = 0; cl < _class_cnt; ++cl) {
+            if (moves[cl].empty()) {
+                continue;
+            }
+
+            std::sort(moves[cl].begin(), moves[cl].end());
+            moves[cl].erase(
+                std::unique(moves[cl].begin(), moves[cl].end()), 
+                moves[cl].end());
+
+            _closure(moves[cl]);
+
+            const auto to = add_state(moves[cl]);
+
+            if (_accept.size() > max_states) {
+                clear();
+                return false;
+            }
+
+            _trans[from * _class_cnt + cl] = static_cast<int32_t>(to);
+        }
+    }
+
+    return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+} // namespace mip
+
+
+/* -------------------------------------------------------------------------- */
+
@@ -0,0 +1,117 @@
+//  
+// This file is part of MipTknzr Library Project
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.  
+// Licensed under the MIT License. 
+// See COPYING file in the project root for full license information.
+//
+
+
+/* -------------------------------------------------------------------------- */
+
+#include "mip_file_map.h"
+
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MIP_HAS_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+/* -------------------------------------------------------------------------- */
+
+namespace mip {
+
+
+/* -------------------------------------------------------------------------- */
+
+bool file_map_t::open(const std::string & path)
+{
+    close();
+
+#ifdef MIP_HAS_MMAP
+    const int fd = ::open(path.c_str(), O_RDONLY);
+
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    _size = static_cast<size_t>(st.st_size);
+
+    if (_size > 0) {
+        void * addr = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (addr == MAP_FAILED) {
+            ::close(fd);
+            _size = 0;
+            return false;
+        }
+
+        _data = static_cast<const char *>(addr);
+        _mapped = true;
+    }
+
+    ::close(fd);
+
+    return true;
+#else
+    std::ifstream is(path, std::ios::binary);
+
+    if (!is) {
+        return false;
+    }
+
+    is.seekg(0, std::ios::end);
+    const auto size = is.tellg();
+    is.seekg(0, std::ios::beg);
+
+    if (size < 0) {
+        return false;
+    }
+
+    _buf.resize(static_cast<size_t>(size));
+
+    if (!_buf.empty() && !is.read(_buf.data(), _buf.size())) {
+        _buf.clear();
+        return false;
+    }
+
+    _data = _buf.data();
+    _size = _buf.size();
+
+    return true;
+#endif
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+void file_map_t::close() noexcept
+{
+#ifdef MIP_HAS_MMAP
+    if (_mapped) {
+        ::munmap(const_cast<char *>(_data), _size);
+    }
+#endif
+
+    _buf.clear();
+    _data = nullptr;
+    _size = 0;
+    _mapped = false;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+} // namespace mip
@@ -0,0 +1,727 @@
+//  
+// This file is part of MipTknzr Library Project
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.  
+// Licensed under the MIT License. 
+// See COPYING file in the project root for full license information.
+//
+
+
+/* -------------------------------------------------------------------------- */
+
+#include "mip_lexgen.h"
+#include "mip_esc_cnvrtr.h"
+
+#include <algorithm>
+#include <cctype>
+#include <set>
+#include <sstream>
+#include <typeinfo>
+#include <type_traits>
+
+
+/* -------------------------------------------------------------------------- */
+
+namespace mip {
+
+
+/* -------------------------------------------------------------------------- */
+
+namespace {
+
+using uchar_t = std::make_unsigned<char_t>::type;
+
+
+/* -------------------------------------------------------------------------- */
+
+//! C++ expression of a character constant of type char_t
+std::string _char(uchar_t ch)
+{
+    std::ostringstream os;
+
+    if (ch >= 0x20 && ch < 0x7f && ch != '\'' && ch != '\\') {
+        os << "_T('" << static_cast<char>(ch) << "')";
+    }
+    else {
+        os << "static_cast<char_t>(0x" << std::hex <<
+            static_cast<unsigned long>(ch) << ")";
+    }
+
+    return os.str();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Switch case label of a character, commented if printable
+std::string _case(uchar_t ch)
+{
+    std::ostringstream os;
+    os << "case 0x" << std::hex << static_cast<unsigned long>(ch) << ":";
+
+    if (ch > 0x20 && ch < 0x7f) {
+        os << " // " << static_cast<char>(ch);
+    }
+
+    return os.str();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+//! C++ literal of a size_t value
+std::string _size(size_t value)
+{
+    std::ostringstream os;
+    os << value;
+
+    if (value > 0x7fffffff) {
+        os << "ull";
+    }
+
+    return os.str();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+const string_t & _head(const string_t & key)
+{
+    return key;
+}
+
+const string_t & _head(const tknzr_t::ml_commdef_t & key)
+{
+    return key.first;
+}
+
+
+//! First characters of a set of definitions
+template <class M>
+std::set<uchar_t> _heads(const M & defs)
+{
+    std::set<uchar_t> heads;
+
+    for (const auto & def : defs) {
+        const auto & value = _head(def.first);
+
+        if (!value.empty()) {
+            heads.insert(static_cast<uchar_t>(value[0]));
+        }
+    }
+
+    return heads;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * Write a function matching the longest definition of a dispatch table
+ * at the beginning of a text (whose size 'avail' is at least 1),
+ * returning its length and setting its id (and the terminator of
+ * multi-line comments), or 0 if none matches
+ */
+void _gen_matcher(
+    std::ostream & os,
+    const char * name,
+    const char * doc,
+    const tkn_idx_t & idx,
+    const std::set<uchar_t> & heads,
+    bool ml)
+{
+    os << "    //! " << doc << "\n"
+       << "    static size_t " << name << "(\n"
+       << "        const char_t * p,\n"
+       << "        size_t avail,\n";
+
+    if (ml) {
+        os << "        size_t & id,\n"
+           << "        const char_t * & tail,\n"
+           << "        size_t & tail_size) noexcept\n";
+    }
+    else {
+        os << "        size_t & id) noexcept\n";
+    }
+
+    os << "    {\n";
+
+    if (heads.empty()) {
+        os << "        (void)p;\n"
+           << "        (void)avail;\n"
+           << "        (void)id;\n";
+
+        if (ml) {
+            os << "        (void)tail;\n"
+               << "        (void)tail_size;\n";
+        }
+
+        os << "        return 0;\n"
+           << "    }\n\n";
+
+        return;
+    }
+
+    size_t longest = 0;
+
+    for (const auto head : heads) {
+        const auto & entries = *idx.find(static_cast<char_t>(head));
+        longest = std::max(longest, entries.front().value->size());
+    }
+
+    if (longest < 2) {
+        os << "        (void)avail;\n\n";
+    }
+
+    // terminators of multi-line comments
+    size_t tail_cnt = 0;
+
+    if (ml) {
+        for (const auto head : heads) {
+            for (const auto & entry : *idx.find(static_cast<char_t>(head))) {
+                os << "        static const char_t tail_" << tail_cnt++
+                   << "[] = { ";
+
+                for (const auto ch : *entry.tail) {
+                    os << _char(static_cast<uchar_t>(ch)) << ", ";
+                }
+
+                os << "0 };\n";
+            }
+        }
+
+        os << "\n";
+        tail_cnt = 0;
+    }
+
+    os << "        switch (static_cast<uchar_t>(p[0])) {\n";
+
+    for (const auto head : heads) {
+        os << "        " << _case(head) << "\n";
+
+        bool returned = false;
+
+        // candidates are sorted by decreasing length
+        for (const auto & entry : *idx.find(static_cast<char_t>(head))) {
+            const auto & value = *entry.value;
+            const char * indent = "            ";
+
+            if (value.size() > 1) {
+                os << "            if (avail >= " << value.size();
+
+                for (size_t i = 1; i < value.size(); ++i) {
+                    os << " &&\n                p[" << i << "] == " <<
+                        _char(static_cast<uchar_t>(value[i]));
+                }
+
+                os << ")\n            {\n";
+                indent = "                ";
+            }
+
+            os << indent << "id = " << _size(entry.id) << ";\n";
+
+            if (ml) {
+                os << indent << "tail = tail_" << tail_cnt++ << ";\n"
+                   << indent << "tail_size = " << entry.tail->size() << ";\n";
+            }
+
+            os << indent << "return " << value.size() << ";\n";
+
+            if (value.size() > 1) {
+                os << "            }\n";
+            }
+            else {
+                // any shorter candidate is unreachable
+                returned = true;
+                break;
+            }
+        }
+
+        if (ml) {
+            // skip the terminators of unreachable candidates
+            const auto & entries = *idx.find(static_cast<char_t>(head));
+            size_t emitted = 0;
+
+            for (const auto & entry : entries) {
+                ++emitted;
+
+                if (entry.value->size() == 1) {
+                    break;
+                }
+            }
+
+            tail_cnt += entries.size() - emitted;
+        }
+
+        if (!returned) {
+            os << "            break;\n";
+        }
+    }
+
+    os << "        default:\n"
+       << "            break;\n"
+       << "        }\n\n"
+       << "        return 0;\n"
+       << "    }\n\n";
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Write the keyword lookup: whole words are compared by size first,
+//! then by first character
+void _gen_keywords(std::ostream & os, const tknzr_t::tkndef_t & defs)
+{
+    os << "    //! Return the id of the keyword spelled by a text or npos\n"
+       << "    static size_t match_keyword(\n"
+       << "        const char_t * p,\n"
+       << "        size_t size) noexcept\n"
+       << "    {\n";
+
+    std::map<size_t, std::map<uchar_t, tknzr_t::tkndef_t>> by_size;
+
+    for (const auto & def : defs) {
+        if (!def.first.empty()) {
+            const auto head = static_cast<uchar_t>(def.first[0]);
+            by_size[def.first.size()][head].insert(def);
+        }
+    }
+
+    if (by_size.empty()) {
+        os << "        (void)p;\n"
+           << "        (void)size;\n"
+           << "        return mip::token_t::npos;\n"
+           << "    }\n\n";
+
+        return;
+    }
+
+    os << "        switch (size) {\n";
+
+    for (const auto & size_group : by_size) {
+        os << "        case " << size_group.first << ":\n"
+           << "            switch (static_cast<uchar_t>(p[0])) {\n";
+
+        for (const auto & head_group : size_group.second) {
+            os << "            " << _case(head_group.first) << "\n";
+
+            for (const auto & def : head_group.second) {
+                const auto & value = def.first;
+                const char * indent = "                ";
+
+                if (value.size() > 1) {
+                    os << "                if (";
+
+                    for (size_t i = 1; i < value.size(); ++i) {
+                        if (i > 1) {
+                            os << " &&\n                    ";
+                        }
+
+                        os << "p[" << i << "] == " <<
+                            _char(static_cast<uchar_t>(value[i]));
+                    }
+
+                    os << ")\n                {\n";
+                    indent = "                    ";
+                }
+
+                os << indent << "return " << _size(def.second) << ";\n";
+
+                if (value.size() > 1) {
+                    os << "                }\n";
+                }
+            }
+
+            os << "                break;\n";
+        }
+
+        os << "            default:\n"
+           << "                break;\n"
+           << "            }\n"
+           << "            break;\n";
+    }
+
+    os << "        default:\n"
+       << "            break;\n"
+       << "        }\n\n"
+       << "        return mip::token_t::npos;\n"
+       << "    }\n\n";
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+template <class T>
+void _gen_table(
+    std::ostream & os,
+    const char * type,
+    const char * name,
+    const std::vector<T> & values,
+    const std::string & npos_value = std::string())
+{
+    os << "        static const " << type << " " << name << "[] = {";
+
+    for (size_t i = 0; i < values.size(); ++i) {
+        os << (i % 12 ? " " : "\n            ");
+
+        if (!npos_value.empty() && values[i] == static_cast<T>(-1)) {
+            os << npos_value;
+        }
+        else {
+            os << values[i];
+        }
+
+        if (i + 1 < values.size()) {
+            os << ",";
+        }
+    }
+
+    os << "\n        };\n\n";
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+} // namespace
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Write the pattern matcher: the DFA runs on constant tables
+void lexgen_t::_gen_patterns(std::ostream & os, const dfa_t & dfa)
+{
+    os << "    //! Return the length of the longest pattern match at the\n"
+       << "    //! beginning of a text or 0, setting the pattern id\n"
+       << "    static size_t match_pattern(\n"
+       << "        const char_t * p,\n"
+       << "        size_t avail,\n"
+       << "        size_t & id) noexcept\n"
+       << "    {\n";
+
+    if (dfa.empty()) {
+        os << "        (void)p;\n"
+           << "        (void)avail;\n"
+           << "        (void)id;\n"
+           << "        return 0;\n"
+           << "    }\n\n";
+
+        return;
+    }
+
+    const bool small = dfa._accept.size() < 0x8000;
+
+    std::vector<long> low_class(dfa._low_class.begin(), dfa._low_class.end());
+    std::vector<long> trans(dfa._trans.begin(), dfa._trans.end());
+    std::vector<unsigned long> bounds(dfa._bounds.begin(), dfa._bounds.end());
+
+    _gen_table(os, "int32_t", "low_class", low_class);
+
+    if (sizeof(char_t) > 1) {
+        _gen_table(os, "uint32_t", "bounds", bounds);
+    }
+
+    _gen_table(os, small ? "int16_t" : "int32_t", "trans", trans);
+
+    os << "        const size_t npos = mip::token_t::npos;\n\n";
+
+    _gen_table(os, "size_t", "accept", dfa._accept, "npos");
+
+    os << "        size_t state = 0;\n"
+       << "        size_t len = 0;\n\n"
+       << "        for (size_t i = 0; i < avail; ++i) {\n"
+       << "            const auto uch = static_cast<uchar_t>(p[i]);\n";
+
+    if (sizeof(char_t) > 1) {
+        os << "            int32_t cl = -1;\n\n"
+           << "            if (uch < 256) {\n"
+           << "                cl = low_class[uch];\n"
+           << "            }\n"
+           << "            else {\n"
+           << "                const auto end = bounds + "
+           << bounds.size() << ";\n"
+           << "                const auto it = std::upper_bound(bounds, end,\n"
+           << "                    static_cast<uint32_t>(uch));\n\n"
+           << "                cl = it == bounds ? -1 : "
+           << "static_cast<int32_t>(it - bounds - 1);\n"
+           << "            }\n\n";
+    }
+    else {
+        os << "            const int32_t cl = low_class[uch];\n\n";
+    }
+
+    os << "            if (cl < 0) {\n"
+       << "                break;\n"
+       << "            }\n\n"
+       << "            const int32_t next = trans[state * "
+       << dfa._class_cnt << " + cl];\n\n"
+       << "            if (next < 0) {\n"
+       << "                break;\n"
+       << "            }\n\n"
+       << "            state = static_cast<size_t>(next);\n\n"
+       << "            if (accept[state] != npos) {\n"
+       << "                len = i + 1;\n"
+       << "                id = accept[state];\n"
+       << "            }\n"
+       << "        }\n\n"
+       << "        return len;\n"
+       << "    }\n\n";
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Write the quote lookup, returning the escape character of a quote
+void lexgen_t::_gen_quotes(std::ostream & os, const tknzr_t & tknzr)
+{
+    os << "    //! Return true if a character opens a string, setting its\n"
+       << "    //! escape character (0 if escapes are not converted)\n"
+       << "    static bool match_quote(char_t ch, char_t & esc) noexcept {\n";
+
+    if (tknzr._strdef.empty()) {
+        os << "        (void)ch;\n"
+           << "        (void)esc;\n"
+           << "        return false;\n"
+           << "    }\n\n";
+
+        return;
+    }
+
+    os << "        switch (static_cast<uchar_t>(ch)) {\n";
+
+    for (const auto & str : tknzr._strdef) {
+        const char_t esc = str.second ? str.second->escape_char() : 0;
+
+        os << "        " << _case(static_cast<uchar_t>(str.first)) << "\n"
+           << "            esc = " <<
+           (esc ? _char(static_cast<uchar_t>(esc)) : std::string("0")) << ";\n"
+           << "            return true;\n";
+    }
+
+    os << "        default:\n"
+       << "            break;\n"
+       << "        }\n\n"
+       << "        return false;\n"
+       << "    }\n\n";
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Write the table of characters which can begin a token other than
+//! an other token
+void lexgen_t::_gen_start(std::ostream & os, const tknzr_t & tknzr)
+{
+    // bounded by the table size (not by a constant, which narrow 
+    // characters never reach)
+    std::vector<int> start(256, 0);
+
+    auto mark = [&start](const std::set<uchar_t> & heads) {
+        for (const auto head : heads) {
+            if (head < start.size()) {
+                start[head] = 1;
+            }
+        }
+    };
+
+    mark(_heads(tknzr._ml_comdef));
+    mark(_heads(tknzr._blkdef));
+    mark(_heads(tknzr._sl_comdef));
+    mark(_heads(tknzr._atomdef));
+
+    for (const auto & str : tknzr._strdef) {
+        const auto uch = static_cast<uchar_t>(str.first);
+
+        if (uch < start.size()) {
+            start[uch] = 1;
+        }
+    }
+
+    if (!tknzr._numdef.empty()) {
+        for (int ch = '0'; ch <= '9'; ++ch) {
+            start[ch] = 1;
+        }
+
+        if (tknzr._num_float) {
+            start['.'] = 1;
+        }
+    }
+
+    const auto & dfa = tknzr._patdfa;
+
+    if (!dfa.empty()) {
+        for (size_t ch = 0; ch < 256; ++ch) {
+            const auto cl = dfa._low_class[ch];
+
+            if (cl >= 0 && dfa._trans[cl] >= 0) {
+                start[ch] = 1;
+            }
+        }
+    }
+
+    os << "    //! Return false if a character cannot begin any token but\n"
+       << "    //! an other one\n"
+       << "    static bool is_start(char_t ch) noexcept {\n";
+
+    _gen_table(os, "unsigned char", "start", start);
+
+    if (sizeof(char_t) > 1) {
+        os << "        const auto uch = static_cast<uchar_t>(ch);\n\n"
+           << "        return uch >= 256 || start[uch] != 0;\n";
+    }
+    else {
+        os << "        return start[static_cast<uchar_t>(ch)] != 0;\n";
+    }
+
+    os << "    }\n\n";
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+std::string lexgen_t::unsupported(const tknzr_t & tknzr)
+{
+    if (tknzr._window) {
+        return "windowed scanning";
+    }
+
+    if (tknzr._tab_size) {
+        return "indentation";
+    }
+
+    if (!tknzr._brkdef.empty()) {
+        return "brackets";
+    }
+
+    if (tknzr._line_idx_on) {
+        return "line index";
+    }
+
+    if (tknzr._utf8) {
+        return "UTF-8 mode";
+    }
+
+    if (tknzr._ml_com_mode != base_tknzr_t::comment_t::VALUE) {
+        return "multi-line comment mode";
+    }
+
+    for (const auto & str : tknzr._strdef) {
+        if (str.second && typeid(*str.second) != typeid(esc_cnvrtr_t)) {
+            return "custom escape converter";
+        }
+    }
+
+    return std::string();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool lexgen_t::generate(
+    const tknzr_t & tknzr,
+    const std::string & class_name,
+    std::ostream & os)
+{
+    if (class_name.empty() ||
+        std::isdigit(static_cast<unsigned char>(class_name[0])))
+    {
+        return false;
+    }
+
+    for (const auto ch : class_name) {
+        if (!std::isalnum(static_cast<unsigned char>(ch)) && ch != '_') {
+            return false;
+        }
+    }
+
+    if (!unsupported(tknzr).empty()) {
+        return false;
+    }
+
+    std::string guard = class_name;
+    std::transform(guard.begin(), guard.end(), guard.begin(), ::toupper);
+    guard = "__" + guard + "_H__";
+
+    auto flag = [](bool value) {
+        return value ? "true" : "false";
+    };
+
+    const bool cr =
+        tknzr._eoldef.find(base_tknzr_t::eol_t::CR) != tknzr._eoldef.end();
+    const bool lf =
+        tknzr._eoldef.find(base_tknzr_t::eol_t::LF) != tknzr._eoldef.end();
+
+    // grammar policy name: <name>_grammar_t for <name>_t
+    std::string grammar = class_name;
+
+    if (grammar.size() > 2 && 
+        grammar.compare(grammar.size() - 2, 2, "_t") == 0) 
+    {
+        grammar.resize(grammar.size() - 2);
+    }
+
+    grammar += "_grammar_t";
+
+    const std::string line = "/* " + std::string(74, '-') + " */\n\n";
+
+    os << "//\n"
+       << "// Scanner generated by miptknzr_gen: do not edit.\n"
+       << "//\n\n\n"
+       << line
+       << "#ifndef " << guard << "\n"
+       << "#define " << guard << "\n\n\n"
+       << line
+       << "#include \"mip_static_tknzr.h\"\n\n"
+       << "#include <algorithm>\n"
+       << "#include <cstdint>\n"
+       << "#include <type_traits>\n\n\n"
+       << line
+       << "static_assert(sizeof(mip::char_t) == " << sizeof(char_t) << ",\n"
+       << "    \"scanner generated for a different character type\");\n\n\n"
+       << line
+       << "struct " << grammar << "\n"
+       << "{\n"
+       << "    using char_t = mip::char_t;\n"
+       << "    using uchar_t = std::make_unsigned<char_t>::type;\n\n"
+       << "    static const bool eol_cr = " << flag(cr) << ";\n"
+       << "    static const bool eol_lf = " << flag(lf) << ";\n"
+       << "    static const bool blank_run = " << flag(tknzr._blank_run)
+       << ";\n"
+       << "    static const bool num_dec = " << flag(tknzr._num_dec) << ";\n"
+       << "    static const bool num_hex = " << flag(tknzr._num_hex) << ";\n"
+       << "    static const bool num_oct = " << flag(tknzr._num_oct) << ";\n"
+       << "    static const bool num_bin = " << flag(tknzr._num_bin) << ";\n"
+       << "    static const bool num_float = " << flag(tknzr._num_float)
+       << ";\n\n";
+
+    _gen_start(os, tknzr);
+
+    _gen_matcher(os, "match_ml_comment", "Multi-line comment openers",
+        tknzr._ml_comidx, _heads(tknzr._ml_comdef), true);
+
+    _gen_matcher(os, "match_blank", "Blanks",
+        tknzr._blkidx, _heads(tknzr._blkdef), false);
+
+    _gen_matcher(os, "match_sl_comment", "Single-line comment prefixes",
+        tknzr._sl_comidx, _heads(tknzr._sl_comdef), false);
+
+    _gen_matcher(os, "match_atom", "Atoms",
+        tknzr._atomidx, _heads(tknzr._atomdef), false);
+
+    _gen_keywords(os, tknzr._kwdef);
+    _gen_patterns(os, tknzr._patdfa);
+    _gen_quotes(os, tknzr);
+
+    os << "};\n\n\n"
+       << line
+       << "using " << class_name << " = mip::static_tknzr_t<" << grammar
+       << ">;\n\n\n"
+       << line
+       << "#endif // " << guard << "\n";
+
+    return bool(os);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+} // namespace mip
@@ -0,0 +1,192 @@
+//  
+// This file is part of MipTknzr Library Project
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.  
+// Licensed under the MIT License. 
+// See COPYING file in the project root for full license information.
+//
+
+
+/* -------------------------------------------------------------------------- */
+
+#include "mip_phash.h"
+
+#include <algorithm>
+
+
+/* -------------------------------------------------------------------------- */
+
+namespace mip {
+
+
+/* -------------------------------------------------------------------------- */
+
+bool phash_t::build(const std::map<string_t, size_t> & keys)
+{
+    _seeds.clear();
+    _slots.clear();
+
+    if (keys.empty()) {
+        return true;
+    }
+
+    // a different salt is only needed if two keys have the same hash
+    for (uint64_t salt = 0; salt < 16; ++salt) {
+        if (_build(keys, salt)) {
+            return true;
+        }
+    }
+
+    _seeds.clear();
+    _slots.clear();
+
+    return false;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool phash_t::_build(const std::map<string_t, size_t> & keys, uint64_t salt)
+{
+    const size_t n = keys.size();
+    const size_t bucket_cnt = n / 4 + 1;
+    const size_t slot_cnt = n + n / 4 + 1;
+
+    const uint32_t max_seed = 1 << 20;
+
+    struct key_t {
+        const string_t * key;
+        size_t id;
+        uint64_t h;
+    };
+
+    std::vector<std::vector<key_t>> buckets(bucket_cnt);
+
+    for (const auto & item : keys) {
+        const auto h = _hash(item.first.data(), item.first.size(), salt);
+        buckets[h % bucket_cnt].push_back(key_t{ &item.first, item.second, h });
+    }
+
+    // place larger buckets first
+    std::vector<size_t> order(bucket_cnt);
+
+    for (size_t i = 0; i < bucket_cnt; ++i) {
+        order[i] = i;
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return buckets[a].size() > buckets[b].size();
+    });
+
+    _salt = salt;
+    _seeds.assign(bucket_cnt, 0);
+    _slots.assign(slot_cnt, slot_t());
+
+    std::vector<bool> used(slot_cnt, false);
+    std::vector<size_t> taken;
+
+    for (const auto b : order) {
+        const auto & bucket = buckets[b];
+
+        if (bucket.empty()) {
+            break;
+        }
+
+        uint32_t seed = 0;
+
+        for (; seed < max_seed; ++seed) {
+            taken.clear();
+
+            for (const auto & k : bucket) {
+                const auto slot = _slot(k.h, seed, slot_cnt);
+
+                if (used[slot] || 
+                    std::find(taken.begin(), taken.end(), slot) != taken.end()) 
+                {
+                    break;
+                }
+
+                taken.push_back(slot);
+            }
+
+            if (taken.size() == bucket.size()) {
+                break;
+            }
+        }
+
+        if (seed == max_seed) {
+            return false;
+        }
+
+        _seeds[b] = seed;
+
+        for (size_t i = 0; i < bucket.size(); ++i) {
+            used[taken[i]] = true;
+            _slots[taken[i]].key = *bucket[i].key;
+            _slots[taken[i]].id = bucket[i].id;
+        }
+    }
+
+    return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+void phash_t::save(blob_writer_t & out) const
+{
+    out.put(_salt);
+    out.put_vec(_seeds);
+    out.put_size(_slots.size());
+
+    for (const auto & slot : _slots) {
+        const uint64_t id = 
+            slot.id == npos ? uint64_t(-1) : static_cast<uint64_t>(slot.id);
+
+        out.put_str(slot.key);
+        out.put(id);
+    }
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool phash_t::load(blob_reader_t & in)
+{
+    size_t slot_cnt = 0;
+
+    _seeds.clear();
+    _slots.clear();
+
+    if (!in.get(_salt) || !in.get_vec(_seeds) || !in.get_size(slot_cnt) ||
+        (slot_cnt > 0 && _seeds.empty()))
+    {
+        _seeds.clear();
+        return false;
+    }
+
+    _slots.resize(slot_cnt);
+
+    for (auto & slot : _slots) {
+        uint64_t id = 0;
+
+        if (!in.get_str(slot.key) || !in.get(id)) {
+            _seeds.clear();
+            _slots.clear();
+            return false;
+        }
+
+        slot.id = id == uint64_t(-1) ? npos : static_cast<size_t>(id);
+    }
+
+    return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+} // namespace mip
+
+
+/* -------------------------------------------------------------------------- */
+
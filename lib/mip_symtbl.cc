@@ -0,0 +1,136 @@
+//  
+// This file is part of MipTknzr Library Project
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.  
+// Licensed under the MIT License. 
+// See COPYING file in the project root for full license information.
+//
+
+
+/* -------------------------------------------------------------------------- */
+
+#include "mip_symtbl.h"
+
+
+/* -------------------------------------------------------------------------- */
+
+namespace mip {
+
+
+/* -------------------------------------------------------------------------- */
+
+symtbl_t::symtbl_t(size_t shards) : 
+    _shards(shards ? shards : 1)
+{}
+
+
+/* -------------------------------------------------------------------------- */
+
+size_t symtbl_t::_hash(const char_t * data, size_t size) noexcept
+{
+    // FNV-1a
+    size_t h = static_cast<size_t>(14695981039346656037ULL);
+
+    for (size_t i = 0; i < size; ++i) {
+        h ^= static_cast<size_t>(data[i]);
+        h *= static_cast<size_t>(1099511628211ULL);
+    }
+
+    return h;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+const symtbl_t::entry_t * symtbl_t::_lookup(
+    const shard_t & shard,
+    size_t hash,
+    const char_t * data,
+    size_t size)
+{
+    auto range = shard.index.equal_range(hash);
+
+    for (auto it = range.first; it != range.second; ++it) {
+        const auto & value = it->second->value;
+
+        if (value.compare(0, value.size(), data, size) == 0) {
+            return it->second;
+        }
+    }
+
+    return nullptr;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+size_t symtbl_t::intern(const char_t * data, size_t size)
+{
+    const auto hash = _hash(data, size);
+    auto & shard = _shards[hash % _shards.size()];
+
+    std::lock_guard<std::mutex> lock(shard.mtx);
+
+    auto entry = _lookup(shard, hash, data, size);
+
+    if (entry) {
+        return entry->id;
+    }
+
+    shard.entries.push_back(entry_t{ string_t(data, size), npos });
+    auto & new_entry = shard.entries.back();
+
+    {
+        std::lock_guard<std::mutex> ids_lock(_ids_mtx);
+        new_entry.id = _ids.size();
+        _ids.push_back(&new_entry);
+    }
+
+    shard.index.insert(std::make_pair(hash, &new_entry));
+
+    return new_entry.id;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+size_t symtbl_t::find(const char_t * data, size_t size) const
+{
+    const auto hash = _hash(data, size);
+    const auto & shard = _shards[hash % _shards.size()];
+
+    std::lock_guard<std::mutex> lock(shard.mtx);
+
+    auto entry = _lookup(shard, hash, data, size);
+
+    return entry ? entry->id : npos;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+const string_t * symtbl_t::value(size_t id) const
+{
+    std::lock_guard<std::mutex> lock(_ids_mtx);
+
+    return id < _ids.size() ? &_ids[id]->value : nullptr;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+size_t symtbl_t::size() const
+{
+    std::lock_guard<std::mutex> lock(_ids_mtx);
+
+    return _ids.size();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+} // namespace mip
+
+
+/* -------------------------------------------------------------------------- */
+
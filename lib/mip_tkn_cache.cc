@@ -0,0 +1,161 @@
+//  
+// This file is part of MipTknzr Library Project
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.  
+// Licensed under the MIT License. 
+// See COPYING file in the project root for full license information.
+//
+
+
+/* -------------------------------------------------------------------------- */
+
+#include "mip_tkn_cache.h"
+#include "mip_hash.h"
+
+#include <algorithm>
+#include <cstdio>
+
+
+/* -------------------------------------------------------------------------- */
+
+namespace mip {
+
+
+/* -------------------------------------------------------------------------- */
+
+namespace {
+
+// Input stream buffer reading the bytes of a mapped file, one character 
+// per byte as a binary file stream does
+class mapped_buf_t : public _streambuf {
+public:
+    mapped_buf_t(const char * data, size_t size) noexcept :
+        _data(data),
+        _end(data + size)
+    {
+#ifndef _UNICODE
+        // characters are bytes: read the mapping in place
+        char * begin = const_cast<char *>(_data);
+        setg(begin, begin, begin + size);
+        _data = _end;
+#endif
+    }
+
+protected:
+    int_type underflow() override {
+#ifdef _UNICODE
+        if (_data < _end) {
+            const size_t n = std::min(
+                sizeof(_chunk) / sizeof(_chunk[0]), size_t(_end - _data));
+
+            for (size_t i = 0; i < n; ++i) {
+                _chunk[i] = static_cast<char_t>(
+                    static_cast<unsigned char>(_data[i]));
+            }
+
+            _data += n;
+            setg(_chunk, _chunk, _chunk + n);
+
+            return traits_type::to_int_type(_chunk[0]);
+        }
+#endif
+        return traits_type::eof();
+    }
+
+private:
+    const char * _data;
+    const char * _end;
+#ifdef _UNICODE
+    char_t _chunk[4096];
+#endif
+};
+
+} // namespace
+
+
+/* -------------------------------------------------------------------------- */
+
+bool tkn_cache_t::_entry(
+    const tknzr_t & tknzr, 
+    const std::string & path, 
+    file_map_t & content,
+    uint64_t & key, 
+    std::string & cache_path) const
+{
+    if (!content.open(path)) {
+        return false;
+    }
+
+    key = hash64_t::hash(content.data(), content.size(), tknzr.fingerprint());
+
+    char name[32] = { 0 };
+    std::snprintf(name, sizeof(name), "%016llx.mtks", 
+        static_cast<unsigned long long>(key));
+
+    cache_path = _dir + "/" + name;
+
+    return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool tkn_cache_t::load(
+    tknzr_t & tknzr, 
+    const std::string & path, 
+    tkn_stream_t & stream)
+{
+    file_map_t content;
+    uint64_t key = 0;
+    std::string cache_path;
+
+    if (!_entry(tknzr, path, content, key, cache_path)) {
+        return false;
+    }
+
+    if (stream.open(cache_path, key)) {
+        ++_hits;
+        return true;
+    }
+
+    ++_misses;
+
+    stream.clear();
+    tknzr.reset();
+
+    // tokenize the very bytes the key was computed from
+    mapped_buf_t buf(content.data(), content.size());
+    _istream is(&buf);
+
+    const bool ok = tknzr.tokenize(is, [&](const tkn_view_t & tkn) {
+        stream.add(tkn);
+    });
+
+    if (!ok) {
+        stream.clear();
+        return false;
+    }
+
+    // a stream which cannot be stored is still usable
+    stream.save(cache_path, key);
+
+    return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool tkn_cache_t::evict(const tknzr_t & tknzr, const std::string & path)
+{
+    file_map_t content;
+    uint64_t key = 0;
+    std::string cache_path;
+
+    return _entry(tknzr, path, content, key, cache_path) && 
+        std::remove(cache_path.c_str()) == 0;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+} // namespace mip
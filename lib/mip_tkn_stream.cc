@@ -0,0 +1,386 @@
+//  
+// This file is part of MipTknzr Library Project
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.  
+// Licensed under the MIT License. 
+// See COPYING file in the project root for full license information.
+//
+
+
+/* -------------------------------------------------------------------------- */
+
+#include "mip_tkn_stream.h"
+
+#include <atomic>
+#include <cstdio>
+#include <random>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+
+/* -------------------------------------------------------------------------- */
+
+namespace mip {
+
+
+/* -------------------------------------------------------------------------- */
+
+static const char _magic[4] = { 'M', 'T', 'K', 'S' };
+
+
+/* -------------------------------------------------------------------------- */
+
+// replaces the target in one step, readers see either the old or the new file
+static bool _replace_file(const std::string & from, const std::string & to)
+{
+#ifdef _WIN32
+    return ::MoveFileExA(from.c_str(), to.c_str(), 
+        MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return std::rename(from.c_str(), to.c_str()) == 0;
+#endif
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+// creates a temporary file next to path, with a name no other writer uses
+static std::FILE * _create_temp(const std::string & path, std::string & tmp)
+{
+    static std::atomic<unsigned> seq(0);
+    static const unsigned seed = std::random_device()();
+
+    for (int attempt = 0; attempt < 16; ++attempt) {
+        char suffix[32];
+        std::snprintf(suffix, sizeof(suffix), ".%08x.%08x.tmp", 
+            seed, seq.fetch_add(1));
+
+        tmp = path + suffix;
+
+        // "x" fails if the file already exists
+        if (std::FILE * f = std::fopen(tmp.c_str(), "wbx")) {
+            return f;
+        }
+    }
+
+    return nullptr;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+void tkn_stream_t::clear()
+{
+    _code_buf.clear();
+    _pool.clear();
+    _last_line = 0;
+    _last_start = 0;
+    _last_end = 0;
+
+    _buf.clear();
+    _map.close();
+
+    _code = nullptr;
+    _values = nullptr;
+    _count = 0;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+void tkn_stream_t::_put(uint64_t value)
+{
+    while (value >= 0x80) {
+        _code_buf.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+
+    _code_buf.push_back(static_cast<char>(value));
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+void tkn_stream_t::add(const tkn_view_t & tkn)
+{
+    const size_t line_start = tkn.pos - tkn.offset;
+    const bool new_line = 
+        tkn.line != _last_line || line_start != _last_start;
+
+    uint8_t head = static_cast<uint8_t>(tkn.type) & 0x0F;
+
+    if (new_line) {
+        head |= REC_LINE;
+    }
+
+    if (tkn.id != token_t::npos) {
+        head |= REC_ID;
+    }
+
+    if (tkn.quote || tkn.esc) {
+        head |= REC_STR;
+    }
+
+    if (tkn.type == token_t::tcl_t::NUMBER) {
+        head |= REC_NUM;
+    }
+
+    _code_buf.push_back(static_cast<char>(head));
+
+    if (new_line) {
+        _put(tkn.line - _last_line);
+        _put(line_start - _last_start);
+
+        _last_line = tkn.line;
+        _last_start = line_start;
+    }
+
+    const int64_t delta = 
+        static_cast<int64_t>(tkn.pos) - static_cast<int64_t>(_last_end);
+
+    // position delta is zigzag-encoded (it may be negative)
+    _put((static_cast<uint64_t>(delta) << 1) ^ 
+        static_cast<uint64_t>(delta >> 63));
+    _put(tkn.end - tkn.pos);
+    _put(tkn.size);
+
+    if (head & REC_ID) {
+        _put(tkn.id);
+    }
+
+    if (_has_width(tkn.type)) {
+        _put(tkn.width);
+    }
+
+    if (head & REC_STR) {
+        _put(static_cast<uint64_t>(tkn.quote));
+        _put(static_cast<uint64_t>(tkn.esc));
+    }
+
+    if (head & REC_NUM) {
+        uint8_t flags = 0;
+        uint64_t bits = tkn.num.integer;
+
+        if (tkn.num.floating) {
+            flags |= NUM_FLOATING;
+            std::memcpy(&bits, &tkn.num.real, sizeof(bits));
+        }
+
+        if (tkn.num.overflow) {
+            flags |= NUM_OVERFLOW;
+        }
+
+        _code_buf.push_back(static_cast<char>(flags));
+        _code_buf.append(reinterpret_cast<const char *>(&bits), sizeof(bits));
+    }
+
+    _pool.append(tkn.data, tkn.size);
+    _last_end = tkn.end;
+    ++_count;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool tkn_stream_t::save(const std::string & path, uint64_t key)
+{
+    // values are aligned to 8 bytes
+    const size_t code_size = (_code_buf.size() + 7) & ~size_t(7);
+    const size_t pool_size = _pool.size() * sizeof(char_t);
+
+    header_t hdr;
+    std::memset(&hdr, 0, sizeof(hdr));
+    std::memcpy(hdr.magic, _magic, sizeof(hdr.magic));
+
+    hdr.endian = _endian_mark;
+    hdr.version = version;
+    hdr.char_size = sizeof(char_t);
+    hdr.key = key;
+    hdr.count = _count;
+    hdr.code = code_size;
+    hdr.pool = _pool.size();
+
+    _buf.assign(sizeof(hdr) + code_size + pool_size, 0);
+
+    char * p = _buf.data();
+
+    std::memcpy(p, &hdr, sizeof(hdr));
+    p += sizeof(hdr);
+
+    if (!_code_buf.empty()) {
+        std::memcpy(p, _code_buf.data(), _code_buf.size());
+    }
+
+    p += code_size;
+
+    if (pool_size) {
+        std::memcpy(p, _pool.data(), pool_size);
+    }
+
+    _code_buf.clear();
+    _pool.clear();
+
+    _set_data(_buf.data());
+
+    // write a temporary file which then replaces the target one, 
+    // so that concurrent readers never see a partial stream
+    std::string tmp;
+    std::FILE * f = _create_temp(path, tmp);
+
+    if (!f) {
+        return false;
+    }
+
+    const bool written = 
+        std::fwrite(_buf.data(), 1, _buf.size(), f) == _buf.size();
+
+    if (std::fclose(f) != 0 || !written || !_replace_file(tmp, path)) {
+        std::remove(tmp.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool tkn_stream_t::open(const std::string & path, uint64_t key)
+{
+    clear();
+
+    if (!_map.open(path) || _map.size() < sizeof(header_t)) {
+        _map.close();
+        return false;
+    }
+
+    header_t hdr;
+    std::memcpy(&hdr, _map.data(), sizeof(hdr));
+
+    const bool valid =
+        std::memcmp(hdr.magic, _magic, sizeof(hdr.magic)) == 0 &&
+        hdr.endian == _endian_mark &&
+        hdr.version == version &&
+        hdr.char_size == sizeof(char_t) &&
+        hdr.key == key &&
+        hdr.code <= _map.size() &&
+        hdr.pool <= _map.size() / sizeof(char_t) &&
+        _map.size() == sizeof(hdr) + hdr.code + hdr.pool * sizeof(char_t);
+
+    if (!valid || !_check(_map.data())) {
+        _map.close();
+        return false;
+    }
+
+    _set_data(_map.data());
+
+    return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool tkn_stream_t::_get(const unsigned char * & p, 
+    const unsigned char * end, uint64_t & value) noexcept
+{
+    value = 0;
+
+    for (unsigned shift = 0; shift < 64 && p != end; shift += 7) {
+        const unsigned char byte = *p++;
+        value |= uint64_t(byte & 0x7F) << shift;
+
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool tkn_stream_t::_check(const char * data) noexcept
+{
+    header_t hdr;
+    std::memcpy(&hdr, data, sizeof(hdr));
+
+    auto p = reinterpret_cast<const unsigned char *>(data + sizeof(hdr));
+    const auto end = p + hdr.code;
+
+    // every value must fall within the pool
+    uint64_t values = 0;
+    uint64_t v = 0;
+
+    for (uint64_t i = 0; i < hdr.count; ++i) {
+        if (p == end) {
+            return false;
+        }
+
+        const uint8_t head = *p++;
+
+        if ((head & 0x0F) >= token_t::tcl_cnt) {
+            return false;
+        }
+
+        const auto type = static_cast<token_t::tcl_t>(head & 0x0F);
+
+        if ((head & REC_LINE) && (!_get(p, end, v) || !_get(p, end, v))) {
+            return false;
+        }
+
+        uint64_t size = 0;
+
+        if (!_get(p, end, v) || !_get(p, end, v) || !_get(p, end, size) ||
+            size > hdr.pool - values)
+        {
+            return false;
+        }
+
+        values += size;
+
+        if ((head & REC_ID) && !_get(p, end, v)) {
+            return false;
+        }
+
+        if (_has_width(type) && !_get(p, end, v)) {
+            return false;
+        }
+
+        if ((head & REC_STR) && (!_get(p, end, v) || !_get(p, end, v))) {
+            return false;
+        }
+
+        if (head & REC_NUM) {
+            if (static_cast<size_t>(end - p) < 1 + sizeof(uint64_t)) {
+                return false;
+            }
+
+            p += 1 + sizeof(uint64_t);
+        }
+    }
+
+    return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+void tkn_stream_t::_set_data(const char * data) noexcept
+{
+    header_t hdr;
+    std::memcpy(&hdr, data, sizeof(hdr));
+
+    _code = reinterpret_cast<const unsigned char *>(data + sizeof(hdr));
+    _values = reinterpret_cast<const char_t *>(
+        data + sizeof(hdr) + hdr.code);
+    _count = static_cast<size_t>(hdr.count);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+} // namespace mip
@@ -10,11 +10,23 @@
 /* -------------------------------------------------------------------------- */
 
 #include "mip_tknzr.h"
+#include "mip_blob.h"
+#include "mip_esc_cnvrtr.h"
+#include "mip_hash.h"
+#include "mip_utf8.h"
 
+#include <algorithm>
+#include <chrono>
 #include <sstream>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
 
+#include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
+#include <typeinfo>
 
 
 /* -------------------------------------------------------------------------- */
@@ -24,247 +36,1901 @@ namespace mip {
 
 /* -------------------------------------------------------------------------- */
 
-bool tknzr_t::_is_prefix_ch(const char_t ch, const std::set<string_t> & tknset)
+// Runtime metrics are collected if MIP_TKNZR_METRICS is defined, otherwise 
+// any code updating them is removed as dead code
+#ifdef MIP_TKNZR_METRICS
+static const bool _metrics_on = true;
+#else
+static const bool _metrics_on = false;
+#endif
+
+
+// Per-definition profile is collected if MIP_TKNZR_PROFILE is defined
+#ifdef MIP_TKNZR_PROFILE
+static const bool _profile_on = true;
+#else
+static const bool _profile_on = false;
+#endif
+
+
+//! Return a monotonic time in nanoseconds
+static inline uint64_t _mt_now() noexcept
+{
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+
+//! Return the cost of reading the time, which is subtracted from any 
+//! interval measured (it may be comparable to the time of a matcher)
+static uint64_t _mt_overhead() noexcept
+{
+    const int reads = 256;
+    uint64_t best = UINT64_MAX;
+
+    for (int i = 0; i < 8; ++i) {
+        const uint64_t begin = _mt_now();
+
+        for (int r = 1; r < reads; ++r) {
+            _mt_now();
+        }
+
+        best = std::min(best, (_mt_now() - begin) / reads);
+    }
+
+    return best;
+}
+
+
+//! Return an interval less the cost of reading the time a given number 
+//! of times
+static inline uint64_t _mt_elapsed(
+    uint64_t begin, 
+    uint64_t end, 
+    uint64_t reads) noexcept
+{
+    static const uint64_t overhead = _mt_overhead();
+
+    const uint64_t elapsed = end - begin;
+    const uint64_t cost = reads * overhead;
+
+    return elapsed > cost ? elapsed - cost : 0;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool tknzr_t::metrics_enabled() noexcept
+{
+    return _metrics_on;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+void tknzr_t::_mt_mark(tknzr_metrics_t::matcher_t matcher) noexcept
+{
+    // time elapsed so far is charged to the previous matcher
+    if (_metrics_on && _mt_timing) {
+        const uint64_t now = _mt_now();
+        _metrics.matcher_ns[_mt_matcher] += _mt_elapsed(_mt_last, now, 1);
+        _mt_matcher = static_cast<size_t>(matcher);
+        _mt_last = now;
+        ++_mt_reads;
+    }
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+void tknzr_t::_mt_grown(size_t old_capacity, size_t capacity) noexcept
+{
+    if (_metrics_on && capacity != old_capacity) {
+        ++_metrics.allocations;
+    }
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Return the bytes of heap memory held by a string (none if its text 
+//! fits the string object)
+static inline size_t _heap_size(const string_t & s) noexcept
+{
+    static const size_t sso_size = string_t().capacity();
+
+    return s.capacity() > sso_size ? s.capacity() * sizeof(char_t) : 0;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+mem_usage_t tknzr_t::mem_usage() const noexcept
+{
+    mem_usage_t usage;
+
+    usage.bytes[static_cast<size_t>(mem_usage_t::mem_t::BUFFERS)] = 
+        _heap_size(_textline) + _heap_size(_eol_seq);
+
+    usage.bytes[static_cast<size_t>(mem_usage_t::mem_t::VALUES)] = 
+        _heap_size(_value);
+
+    usage.bytes[static_cast<size_t>(mem_usage_t::mem_t::INDEXES)] = 
+        _lineidx.mem_size() + _brkidx.mem_size() + 
+        _indents.capacity() * sizeof(size_t);
+
+    return usage;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool tknzr_t::set_mem_pool(std::shared_ptr<mem_pool_t> pool)
+{
+    _mem_release();
+    _mem_pool = pool;
+    _mem_guard = _mem_limit || _mem_pool;
+
+    if (_mem_pool && !_mem_sync()) {
+        _mem_release();
+        _mem_pool.reset();
+        _mem_guard = _mem_limit != 0;
+        _mem_failed = false;
+
+        return false;
+    }
+
+    return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool tknzr_t::_mem_sync() noexcept
+{
+    const auto usage = mem_usage();
+
+    if (_mem_limit && usage.total() > _mem_limit) {
+        _mem_failed = true;
+        return false;
+    }
+
+    if (!_mem_pool) {
+        return true;
+    }
+
+    // charge the growth of each kind of memory, release any shrinking
+    for (size_t k = 0; k < mem_usage_t::mem_cnt; ++k) {
+        const auto kind = static_cast<mem_usage_t::mem_t>(k);
+        auto & charged = _mem_charged.bytes[k];
+
+        if (usage.bytes[k] > charged) {
+            if (!_mem_pool->charge(kind, usage.bytes[k] - charged)) {
+                _mem_failed = true;
+                return false;
+            }
+        }
+        else {
+            _mem_pool->release(kind, charged - usage.bytes[k]);
+        }
+
+        charged = usage.bytes[k];
+    }
+
+    return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+void tknzr_t::_mem_release() noexcept
+{
+    if (_mem_pool) {
+        for (size_t k = 0; k < mem_usage_t::mem_cnt; ++k) {
+            _mem_pool->release(
+                static_cast<mem_usage_t::mem_t>(k), _mem_charged.bytes[k]);
+        }
+    }
+
+    _mem_charged = mem_usage_t();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool tknzr_t::_mem_reserve(
+    string_t & buf, 
+    mem_usage_t::mem_t kind, 
+    size_t size)
+{
+    if (size <= buf.capacity()) {
+        return true;
+    }
+
+    const size_t held = _heap_size(buf);
+
+    // the buffer grows geometrically as it would do by itself, or just 
+    // as required if the limit is close
+    for (const size_t capacity : { std::max(size, 2 * buf.capacity()), size }) {
+        const size_t extra = capacity * sizeof(char_t) - held;
+
+        if (_mem_limit && mem_usage().total() + extra > _mem_limit) {
+            continue;
+        }
+
+        if (_mem_pool) {
+            if (!_mem_pool->charge(kind, extra)) {
+                continue;
+            }
+
+            _mem_charged.bytes[static_cast<size_t>(kind)] += extra;
+        }
+
+        buf.reserve(capacity);
+
+        return true;
+    }
+
+    _mem_failed = true;
+
+    return false;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool tknzr_t::profiling_enabled() noexcept
+{
+    return _profile_on;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+void tknzr_t::reset_profile() noexcept
+{
+    for (auto & def : _profile.defs) {
+        def.probes = 0;
+        def.hits = 0;
+        def.collisions = 0;
+        def.hit_ns = 0;
+        def.miss_ns = 0;
+    }
+
+    _profile.lookups = 0;
+    _profile.failed_lookups = 0;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+void tknzr_t::_pf_index()
+{
+    _profile = tknzr_profile_t();
+
+    auto add = [this](
+        token_t::tcl_t type, 
+        const string_t & value, 
+        const string_t & tail, 
+        size_t id) 
+    {
+        def_profile_t def;
+        def.type = type;
+        def.value = value;
+        def.tail = tail;
+        def.id = id;
+
+        _profile.defs.push_back(def);
+    };
+
+    // same order as the slots of dispatch tables (see _index_defs())
+    for (const auto & def : _blkdef) {
+        add(token_t::tcl_t::BLANK, def.first, string_t(), def.second);
+    }
+
+    for (const auto & def : _atomdef) {
+        add(token_t::tcl_t::ATOM, def.first, string_t(), def.second);
+    }
+
+    for (const auto & def : _sl_comdef) {
+        add(token_t::tcl_t::COMMENT, def.first, string_t(), def.second);
+    }
+
+    for (const auto & def : _ml_comdef) {
+        add(token_t::tcl_t::COMMENT, def.first.first, def.first.second, 
+            def.second);
+    }
+
+    for (const auto & def : _strdef) {
+        add(token_t::tcl_t::STRING, string_t(1, def.first), string_t(), 
+            token_t::npos);
+    }
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+const tkn_idx_t::entry_t * tknzr_t::_match(
+    const tkn_idx_t & tknidx, 
+    size_t pos)
+{
+    if (!_profile_on) {
+        return tknidx.match(_textline, pos);
+    }
+
+    _pf_failed.clear();
+
+    const auto def = tknidx.match(_textline, pos, 
+        [this](const tkn_idx_t::entry_t & entry, bool hit) {
+            auto & prof = _profile.defs[entry.slot];
+            ++prof.probes;
+
+            if (hit) {
+                ++prof.hits;
+            }
+            else {
+                _pf_failed.push_back(entry.slot);
+            }
+        });
+
+    if (def) {
+        ++_profile.lookups;
+
+        // longer definitions sharing the prefix were probed in vain
+        for (const auto slot : _pf_failed) {
+            ++_profile.defs[slot].collisions;
+        }
+    }
+    else if (!_pf_failed.empty()) {
+        ++_profile.lookups;
+        ++_profile.failed_lookups;
+    }
+
+    return def;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+uint64_t tknzr_t::_pf_start(const tkn_idx_t & tknidx) const noexcept
+{
+    // time is read only if some definition is going to be probed
+    return _profile_on && tknidx.find(_textline[_pos]) ? _mt_now() : 0;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+void tknzr_t::_pf_hit(size_t slot, uint64_t begin) noexcept
+{
+    if (_profile_on && begin) {
+        _profile.defs[slot].hit_ns += _mt_elapsed(begin, _mt_now(), 1);
+    }
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+void tknzr_t::_pf_miss(uint64_t begin) noexcept
+{
+    if (_profile_on && begin && !_pf_failed.empty()) {
+        const uint64_t ns = 
+            _mt_elapsed(begin, _mt_now(), 1) / _pf_failed.size();
+
+        for (const auto slot : _pf_failed) {
+            _profile.defs[slot].miss_ns += ns;
+        }
+    }
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool tknzr_t::_build_idx()
+{
+    if (!_index_defs()) {
+        return false;
+    }
+
+    _patdfa.clear();
+
+    for (const auto & def : _patdef) {
+        if (!_patdfa.add(def.first, def.second)) {
+            return false;
+        }
+    }
+
+    return _kwidx.build(_kwdef) && _patdfa.build();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool tknzr_t::_index_defs()
+{
+    // definitions are numbered in the order of tknzr_profile_t::defs
+    _blkidx.build(_blkdef);
+    _atomidx.build(_atomdef, _blkdef.size());
+    _sl_comidx.build(_sl_comdef, _blkdef.size() + _atomdef.size());
+    _ml_comidx.build(
+        _ml_comdef, _blkdef.size() + _atomdef.size() + _sl_comdef.size());
+
+    if (_profile_on) {
+        _pf_index();
+    }
+
+    auto has_num = [this](base_tknzr_t::num_t fmt) {
+        return _numdef.find(fmt) != _numdef.end();
+    };
+
+    _num_dec = has_num(base_tknzr_t::num_t::DEC);
+    _num_hex = has_num(base_tknzr_t::num_t::HEX);
+    _num_oct = has_num(base_tknzr_t::num_t::OCT);
+    _num_bin = has_num(base_tknzr_t::num_t::BIN);
+    _num_float = has_num(base_tknzr_t::num_t::FLOAT);
+
+    _brkatom.clear();
+
+    for (const auto & def : _brkdef) {
+        const auto open = _atomdef.find(def.first.first);
+        const auto close = _atomdef.find(def.first.second);
+
+        if (open == _atomdef.end() || close == _atomdef.end()) {
+            return false;
+        }
+
+        _brkatom[open->second] = std::make_pair(def.second, true);
+        _brkatom[close->second] = std::make_pair(def.second, false);
+    }
+
+    return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool tknzr_t::_getline(
+    _istream & is, 
+    string_t & line, 
+    string_t& eol_s, 
+    bool & eof, 
+    size_t max_size)
+{
+    using traits_t = _istream::traits_type;
+
+    if (_metrics_on) {
+        ++_metrics.getline_calls;
+    }
+
+    const bool cr = _eoldef.find(base_tknzr_t::eol_t::CR) != _eoldef.end();
+    const bool lf = _eoldef.find(base_tknzr_t::eol_t::LF) != _eoldef.end();
+
+    eof = is.eof();
+
+    auto sb = is.rdbuf();
+
+    if (!sb) {
+        is.setstate(std::ios_base::badbit);
+        return false;
+    }
+
+    while (!eof) {
+
+        if (is.bad()) {
+            return false;
+        }
+
+        const auto ich = sb->sbumpc();
+
+        if (traits_t::eq_int_type(ich, traits_t::eof())) {
+            is.setstate(std::ios_base::eofbit | std::ios_base::failbit);
+        }
+
+        const char_t ch = is.eof() ? 0 : traits_t::to_char_type(ich);
+
+        eof = is.eof() || ch == 0;
+
+        if (eof) {
+            eol_s.clear();
+            return true;
+        }
+
+        if (cr && ch == _T('\r')) {
+            eol_s = _T("\r");
+            return true;
+        }
+
+        if (lf && ch == _T('\n')) {
+            eol_s = _T("\n");
+            return true;
+        }
+
+        // the buffer never grows beyond the memory limit
+        if (_mem_guard && line.size() == line.capacity() && 
+            !_mem_reserve(line, mem_usage_t::mem_t::BUFFERS, line.size() + 1))
+        {
+            return false;
+        }
+
+        line.push_back(ch);
+
+        // partial line (windowed scanning)
+        if (line.size() >= max_size) {
+#ifndef _UNICODE
+            // never split a UTF-8 sequence
+            const auto next = sb->sgetc();
+
+            if (_utf8 && 
+                !traits_t::eq_int_type(next, traits_t::eof()) &&
+                (traits_t::to_char_type(next) & 0xC0) == 0x80) 
+            {
+                continue;
+            }
+#endif
+            eol_s.clear();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool tknzr_t::_read_line(_istream & is)
+{
+    _textline.clear();
+    _line_shift = 0;
+    _line_shift_cp = 0;
+
+    const size_t max_size = _window ? 2 * _window : string_t::npos;
+    const size_t capacity = _textline.capacity();
+
+    if (!_getline(is, _textline, _eol_seq, _eof, max_size)) {
+        return false;
+    }
+
+    _mt_grown(capacity, _textline.capacity());
+
+    _line_complete = _eof || !_eol_seq.empty();
+
+#ifndef _UNICODE
+    if (_utf8 && !utf8_t::valid(_textline.data(), _textline.size())) {
+        is.setstate(std::ios_base::failbit);
+        return false;
+    }
+#endif
+
+    _line_start = _next_line_start;
+    _next_line_start += _textline.size() + _eol_seq.size();
+
+    if (_metrics_on) {
+        ++_metrics.lines;
+        _metrics.bytes_scanned += 
+            (_textline.size() + _eol_seq.size()) * sizeof(char_t);
+    }
+
+    if (_line_idx_on || _offsets_only) {
+        _lineidx.add(_line_start);
+    }
+
+    if (_mem_guard && !_mem_sync()) {
+        return false;
+    }
+
+    _pos = 0;
+
+    return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool tknzr_t::_fill_window(_istream & is, size_t keep_back)
+{
+    if (_line_complete || _textline.size() - _pos >= _window) {
+        return true;
+    }
+
+    // discard the text already scanned, but any pending token
+    size_t keep = _other_pos != string_t::npos ? _other_pos : _pos;
+    keep -= std::min(keep, keep_back);
+
+    if (keep > 0) {
+#ifndef _UNICODE
+        if (_utf8) {
+            _line_shift_cp += utf8_t::length(_textline.data(), keep);
+        }
+#endif
+        _textline.erase(0, keep);
+        _line_shift += keep;
+        _pos -= keep;
+
+        if (_other_pos != string_t::npos) {
+            _other_pos -= keep;
+        }
+    }
+
+    return _extend_window(is, _window);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool tknzr_t::_grow_window(_istream & is)
+{
+    // the token being scanned reached the end of the window, which is 
+    // extended without discarding it
+    const size_t begin = _other_pos != string_t::npos ? _other_pos : _pos;
+    const size_t size = _textline.size() - begin;
+
+    if (size > _window_max) {
+        _tkn_too_long = true;
+        return false;
+    }
+
+    return _extend_window(is, std::min(_window, _window_max + 1 - size));
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool tknzr_t::_extend_window(_istream & is, size_t count)
+{
+    const size_t size = _textline.size();
+    const size_t capacity = _textline.capacity();
+
+    if (!_getline(is, _textline, _eol_seq, _eof, size + count)) {
+        return false;
+    }
+
+    _mt_grown(capacity, _textline.capacity());
+
+    _line_complete = _eof || !_eol_seq.empty();
+
+#ifndef _UNICODE
+    if (_utf8 && 
+        !utf8_t::valid(_textline.data() + size, _textline.size() - size)) 
+    {
+        is.setstate(std::ios_base::failbit);
+        return false;
+    }
+#endif
+
+    _next_line_start += _textline.size() - size + _eol_seq.size();
+
+    if (_metrics_on) {
+        _metrics.bytes_scanned += 
+            (_textline.size() - size + _eol_seq.size()) * sizeof(char_t);
+    }
+
+    if (_mem_guard && !_mem_sync()) {
+        return false;
+    }
+
+    return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+void tknzr_t::_reset()
+{
+    _textline.clear();
+    _eol_seq.clear();
+    _pos = 0;
+    _other_pos = string_t::npos;
+    _line_number = 0;
+    _eof = false;
+    _tkn_index = 0;
+    _brkidx.clear();
+    _line_start = 0;
+    _next_line_start = 0;
+    _line_complete = true;
+    _str_open = false;
+    _ml_com_open = nullptr;
+    _line_shift = 0;
+    _line_shift_cp = 0;
+    _lineidx.clear();
+    _indents.clear();
+    _dedent_pending = 0;
+    _indent_pending = false;
+    _indent_width = 0;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+void tknzr_t::_set_tkn(
+    tkn_view_t & tkn,
+    token_t::tcl_t tkncl,
+    const char_t * data,
+    size_t size,
+    size_t offset) const noexcept
+{
+    tkn.type = tkncl;
+    tkn.data = data;
+    tkn.size = size;
+
+    if (_offsets_only) {
+        tkn.pos = _line_start + _line_shift + offset;
+    }
+    else {
+        tkn.line = _line_number;
+        tkn.offset = _line_shift + offset;
+        tkn.pos = _line_start + tkn.offset;
+    }
+
+    tkn.end = tkn.pos + size;
+    tkn.quote = 0;
+    tkn.esc = 0;
+    tkn.sym = token_t::npos;
+    tkn.id = token_t::npos;
+    tkn.num = numval_t();
+    tkn.width = 0;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool tknzr_t::_search_eof(tkn_view_t & tkn)
+{
+    if (_eof) {
+        _set_tkn(
+            tkn,
+            token_t::tcl_t::END_OF_FILE,
+            _eol_seq.data(),
+            _eol_seq.size(),
+            _pos);
+
+        return true;
+    }
+
+    return false;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool tknzr_t::_search_eol(tkn_view_t & tkn)
+{
+    if (!_eol_seq.empty()) {
+        _value = _eol_seq;
+
+        _set_tkn(
+            tkn,
+            token_t::tcl_t::END_OF_LINE,
+            _value.data(),
+            _value.size(),
+            _pos);
+
+        ++_line_number;
+        _eol_seq.clear();
+
+        return true;
+    }
+
+    return false;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool tknzr_t::_search_other_tkn(tkn_view_t & tkn)
+{
+    if (_other_pos != string_t::npos)
+    {
+        _set_tkn(
+            tkn,
+            token_t::tcl_t::OTHER,
+            _textline.data() + _other_pos,
+            _pos - _other_pos,
+            _other_pos);
+
+        _other_pos = string_t::npos;
+
+        _classify(tkn);
+
+        return true;
+    }
+
+    return false;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+void tknzr_t::_classify(tkn_view_t & tkn)
+{
+    const auto kw_id = _kwidx.find(tkn.data, tkn.size);
+
+    if (kw_id != phash_t::npos) {
+        tkn.type = token_t::tcl_t::KEYWORD;
+        tkn.id = kw_id;
+    }
+    else if (_symtbl && !_counts_only) {
+        tkn.sym = _symtbl->intern(tkn.data, tkn.size);
+    }
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool tknzr_t::_parse_integer(
+    const string_t & text,
+    size_t begin,
+    size_t end,
+    unsigned base,
+    numval_t & num) noexcept
+{
+    const uint64_t max_value = static_cast<uint64_t>(-1);
+
+    num.floating = false;
+    num.overflow = false;
+    num.integer = 0;
+
+    for (size_t i = begin; i < end; ++i) {
+        const char_t ch = text[i];
+        unsigned digit = 0;
+
+        if (ch >= _T('0') && ch <= _T('9')) {
+            digit = ch - _T('0');
+        }
+        else if (ch >= _T('a') && ch <= _T('f')) {
+            digit = ch - _T('a') + 10;
+        }
+        else if (ch >= _T('A') && ch <= _T('F')) {
+            digit = ch - _T('A') + 10;
+        }
+        else {
+            return false;
+        }
+
+        if (digit >= base) {
+            return false;
+        }
+
+        if (!num.overflow && num.integer > (max_value - digit) / base) {
+            num.overflow = true;
+            num.integer = max_value;
+        }
+        
+        if (!num.overflow) {
+            num.integer = num.integer * base + digit;
+        }
+    }
+
+    return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+void tknzr_t::_parse_real(
+    const string_t & text,
+    size_t begin,
+    size_t end,
+    numval_t & num)
+{
+    // the lexeme has already been validated, so strtod consumes exactly it
+    char buf[64];
+    std::string big;
+
+    const size_t size = end - begin;
+    char * str = buf;
+
+    if (size >= sizeof(buf)) {
+        big.resize(size);
+        str = &big[0];
+    }
+
+    for (size_t i = 0; i < size; ++i) {
+        str[i] = static_cast<char>(text[begin + i]);
+    }
+
+    str[size] = 0;
+
+    errno = 0;
+
+    num.floating = true;
+    num.real = std::strtod(str, nullptr);
+    num.overflow = errno == ERANGE && std::fabs(num.real) == HUGE_VAL;
+    num.integer = 0;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+size_t tknzr_t::_scan_number(numval_t & num) const
+{
+    const auto & text = _textline;
+    const size_t begin = _pos;
+    const size_t n = text.size();
+
+    auto is_digit = [](char_t ch) {
+        return ch >= _T('0') && ch <= _T('9');
+    };
+
+    auto is_xdigit = [&](char_t ch) {
+        return is_digit(ch) || 
+            (ch >= _T('a') && ch <= _T('f')) || 
+            (ch >= _T('A') && ch <= _T('F'));
+    };
+
+    // values are not converted if only counted
+    auto integer = [&](size_t from, size_t to, unsigned base) {
+        if (!_counts_only) {
+            _parse_integer(text, from, to, base, num);
+        }
+    };
+
+    auto real = [&](size_t to) {
+        if (!_counts_only) {
+            _parse_real(text, begin, to, num);
+        }
+    };
+
+    // prefixed integers
+    if (text[begin] == _T('0') && begin + 2 < n) {
+        const char_t prefix = text[begin + 1];
+
+        if (_num_hex && (prefix == _T('x') || prefix == _T('X')) && 
+            is_xdigit(text[begin + 2])) 
+        {
+            size_t end = begin + 2;
+
+            while (end < n && is_xdigit(text[end])) {
+                ++end;
+            }
+
+            integer(begin + 2, end, 16);
+            return end - begin;
+        }
+
+        if (_num_bin && (prefix == _T('b') || prefix == _T('B')) && 
+            (text[begin + 2] == _T('0') || text[begin + 2] == _T('1'))) 
+        {
+            size_t end = begin + 2;
+
+            while (end < n && (text[end] == _T('0') || text[end] == _T('1'))) {
+                ++end;
+            }
+
+            integer(begin + 2, end, 2);
+            return end - begin;
+        }
+    }
+
+    // decimal integer part
+    size_t end = begin;
+
+    while (end < n && is_digit(text[end])) {
+        ++end;
+    }
+
+    const size_t int_end = end;
+    bool floating = false;
+
+    if (_num_float) {
+        // fraction
+        if (end < n && text[end] == _T('.') && 
+            (end > begin || (end + 1 < n && is_digit(text[end + 1])))) 
+        {
+            ++end;
+
+            while (end < n && is_digit(text[end])) {
+                ++end;
+            }
+
+            floating = true;
+        }
+
+        // exponent
+        if (end > begin && end < n && 
+            (text[end] == _T('e') || text[end] == _T('E'))) 
+        {
+            size_t exp = end + 1;
+
+            if (exp < n && (text[exp] == _T('+') || text[exp] == _T('-'))) {
+                ++exp;
+            }
+
+            if (exp < n && is_digit(text[exp])) {
+                while (exp < n && is_digit(text[exp])) {
+                    ++exp;
+                }
+
+                end = exp;
+                floating = true;
+            }
+        }
+    }
+
+    if (end == begin) {
+        return 0;
+    }
+
+    if (floating) {
+        real(end);
+        return end - begin;
+    }
+
+    // octal integer
+    if (_num_oct && text[begin] == _T('0') && int_end - begin > 1) {
+        size_t oct_end = begin + 1;
+
+        while (oct_end < int_end && 
+               text[oct_end] >= _T('0') && text[oct_end] <= _T('7')) 
+        {
+            ++oct_end;
+        }
+
+        if (oct_end == int_end || !_num_dec) {
+            integer(begin + 1, oct_end, 8);
+            return oct_end - begin;
+        }
+    }
+
+    if (_num_dec || (_num_oct && int_end - begin == 1 && text[begin] == _T('0'))) {
+        integer(begin, int_end, 10);
+        return int_end - begin;
+    }
+
+    if (_num_float) {
+        real(int_end);
+        return int_end - begin;
+    }
+
+    return 0;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool tknzr_t::_get_number(tkn_view_t & tkn)
+{
+    // numbers never split other tokens (e.g. identifiers like x1)
+    if (_numdef.empty() || _other_pos != string_t::npos) {
+        return false;
+    }
+
+    numval_t num;
+    const size_t size = _scan_number(num);
+
+    if (size == 0) {
+        return false;
+    }
+
+    size_t id = 0;
+
+    if (_patdfa.match(_textline, _pos, id) > size) {
+        return false;
+    }
+
+    // not profiled: the atoms are probed (and counted) by _get_atom()
+    const auto atom = _atomidx.match(_textline, _pos);
+
+    if (atom && atom->value->size() >= size) {
+        return false;
+    }
+
+    _set_tkn(
+        tkn, 
+        token_t::tcl_t::NUMBER, 
+        _textline.data() + _pos, 
+        size, 
+        _pos);
+
+    tkn.num = num;
+    _pos += size;
+
+    return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool tknzr_t::_get_pattern(tkn_view_t & tkn)
+{
+    size_t id = token_t::npos;
+    const size_t size = _patdfa.match(_textline, _pos, id);
+
+    if (size == 0) {
+        return false;
+    }
+
+    // on equal length, atoms win over patterns (not profiled, as in 
+    // _get_number())
+    const auto atom = _atomidx.match(_textline, _pos);
+
+    if (atom && atom->value->size() >= size) {
+        return false;
+    }
+
+    if (_search_other_tkn(tkn)) {
+        return true;
+    }
+
+    _set_tkn(
+        tkn, 
+        token_t::tcl_t::PATTERN, 
+        _textline.data() + _pos, 
+        size, 
+        _pos);
+
+    tkn.id = id;
+    _pos += size;
+
+    _classify(tkn);
+
+    return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool tknzr_t::_get_tkn(
+    const tkn_idx_t & tknidx,
+    token_t::tcl_t tkncl,
+    get_t cut_type,
+    tkn_view_t & tkn)
+{
+    const uint64_t pf_begin = _pf_start(tknidx);
+    auto def = _match(tknidx, _pos);
+
+    if (def) {
+        if (_search_other_tkn(tkn)) {
+            _pf_hit(def->slot, pf_begin);
+            return true;
+        }
+
+        size_t size = cut_type == get_t::WHOLE_LN ?
+            _textline.size() - _pos : def->value->size();
+
+        // extend the token over any run of definitions of the same class
+        if (cut_type == get_t::TKN_RUN) {
+            const tkn_idx_t::entry_t * next = nullptr;
+
+            while ((next = _match(tknidx, _pos + size)) != nullptr) {
+                size += next->value->size();
+            }
+        }
+
+        _pf_hit(def->slot, pf_begin);
+
+        _set_tkn(tkn, tkncl, _textline.data() + _pos, size, _pos);
+
+        tkn.id = def->id;
+        _pos += size;
+
+        return true;
+    }
+
+    _pf_miss(pf_begin);
+
+    return false;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool tknzr_t::_get_string(tkn_view_t & tkn)
 {
-    for (const auto & item : tknset) {
-        if (!item.empty() && item[0] == ch) {
+    if (_pos >= _textline.size()) {
+        return false;
+    }
+
+    const auto quote_ch = _textline[_pos];
+    auto quote_esc_it = _strdef.find(quote_ch);
+
+    if (quote_esc_it == _strdef.end()) {
+        return false;
+    }
+
+    // a quote ending a partial line opens a string beyond the window
+    if (_textline.size() - _pos < 2) {
+        _str_open = _window && !_line_complete;
+        return false;
+    }
+
+    // quotes follow any other definition in the profile
+    size_t pf_slot = 0;
+    uint64_t pf_begin = 0;
+
+    if (_profile_on) {
+        pf_slot = _profile.defs.size() - _strdef.size() + 
+            std::distance(_strdef.begin(), quote_esc_it);
+
+        ++_profile.defs[pf_slot].probes;
+        _pf_failed.assign(1, pf_slot);
+        pf_begin = _mt_now();
+    }
+
+    const auto & esc_cnvt = quote_esc_it->second;
+    const char_t esc_ch =
+        esc_cnvt ? esc_cnvt->escape_char() : 0;
+
+    if (_textline.size() - _pos == 2 && _textline[_pos + 1] != quote_ch) {
+        _str_open = _window && !_line_complete;
+        _pf_miss(pf_begin);
+        return false;
+    }
+
+    // the value is only measured if not required (see stats())
+    _value.clear();
+    const size_t capacity = _value.capacity();
+    size_t size = 0;
+
+    for (size_t i = _pos + 1; i < _textline.size(); ++i) {
+        char_t ch = _textline[i];
+
+        if (esc_cnvt && ch == esc_ch) {
+            size_t remove_cnt = 0;
+            if (!esc_cnvt->convert(_textline.c_str() + i, remove_cnt, ch)) {
+                // the escape sequence might be cut by the window edge
+                _str_open = _window && !_line_complete;
+
+                _pf_miss(pf_begin);
+                return false;
+            }
+            i += (remove_cnt - 1);
+        }
+        else if (ch == quote_ch) {
+            if (_profile_on) {
+                ++_profile.defs[pf_slot].hits;
+                _pf_hit(pf_slot, pf_begin);
+            }
+
+            if (_search_other_tkn(tkn)) {
+                return true;
+            }
+
+            _set_tkn(
+                tkn,
+                token_t::tcl_t::STRING,
+                _counts_only ? _textline.data() + _pos + 1 : _value.data(),
+                size,
+                _pos);
+
+            tkn.end = _line_start + _line_shift + i + 1;
+            tkn.quote = quote_ch;
+            tkn.esc = esc_ch;
+
+            if (_metrics_on) {
+                _mt_grown(capacity, _value.capacity());
+                _metrics.bytes_copied += _value.size() * sizeof(char_t);
+            }
+
+            if (_symtbl && _intern_strings && !_counts_only) {
+                tkn.sym = _symtbl->intern(tkn.data, tkn.size);
+            }
+
+            _pos = i + 1;
+
             return true;
         }
+
+        ++size;
+
+        if (_counts_only) {
+            continue;
+        }
+
+        if (_mem_guard && _value.size() == _value.capacity() && 
+            !_mem_reserve(_value, mem_usage_t::mem_t::VALUES, _value.size() + 1))
+        {
+            return false;
+        }
+
+        _value.push_back(ch);
     }
 
+    // the closing quote might follow the window
+    _str_open = _window && !_line_complete;
+
+    _pf_miss(pf_begin);
+
     return false;
 }
 
 
 /* -------------------------------------------------------------------------- */
 
-std::set<string_t>::const_reverse_iterator tknzr_t::_search_token(
-    const std::set<string_t>& tknset,
-    string_t & line)
+bool tknzr_t::_get_comment(_istream & is, tkn_view_t & tkn, bool & found)
+{
+    found = false;
+
+    // next chunk of a comment left open
+    if (_ml_com_open) {
+        const auto open = _ml_com_open;
+        const uint64_t pf_begin = _profile_on ? _mt_now() : 0;
+
+        _get_comment_chunk(open, _pos, tkn);
+        _pf_hit(open->slot, pf_begin);
+        found = true;
+        return true;
+    }
+
+    const uint64_t pf_begin = _pf_start(_ml_comidx);
+    const auto def = _match(_ml_comidx, _pos);
+
+    if (!def) {
+        _pf_miss(pf_begin);
+        return true;
+    }
+
+
+    if (_search_other_tkn(tkn)) {
+        _pf_hit(def->slot, pf_begin);
+        found = true;
+        return true;
+    }
+
+    if (_ml_com_mode == base_tknzr_t::comment_t::CHUNKS) {
+        _get_comment_chunk(def, _pos + def->value->size(), tkn);
+        _pf_hit(def->slot, pf_begin);
+        found = true;
+        return true;
+    }
+
+    // comment text is not collected if only its extent is required
+    const bool keep = _ml_com_mode == base_tknzr_t::comment_t::VALUE;
+
+    const auto & end_comment = *def->tail;
+    const size_t comment_line = _line_number;
+    const size_t comment_offset = _line_shift + _pos;
+    const size_t comment_pos = _line_start + comment_offset;
+
+    // terminator is searched after the opener
+    size_t from = _pos + def->value->size();
+    size_t end_comment_offset = _textline.find(end_comment, from);
+
+    if (end_comment_offset != string_t::npos) {
+        const size_t size = end_comment_offset + end_comment.size() - _pos;
+
+        _set_tkn(
+            tkn,
+            token_t::tcl_t::COMMENT,
+            _textline.data() + _pos,
+            keep ? size : 0,
+            _pos);
+
+        tkn.end = tkn.pos + size;
+        tkn.id = def->id;
+        _pos += size;
+        found = true;
+
+        _pf_hit(def->slot, pf_begin);
+
+        return true;
+    }
+
+    _value.clear();
+    const size_t capacity = _value.capacity();
+    size_t size = 0;
+
+    // comment text is accumulated up to the memory limit, or only 
+    // measured if not required (see stats())
+    auto collect = [&](const char_t * text, size_t count) {
+        if (!keep) {
+            return true;
+        }
+
+        size += count;
+
+        if (_counts_only) {
+            return true;
+        }
+
+        if (_mem_guard && 
+            !_mem_reserve(_value, mem_usage_t::mem_t::VALUES, _value.size() + count))
+        {
+            return false;
+        }
+
+        _value.append(text, count);
+        return true;
+    };
+
+    if (!collect(_textline.data() + _pos, _textline.size() - _pos)) {
+        return false;
+    }
+
+    _pos = _textline.size();
+
+    while (end_comment_offset == string_t::npos) {
+        if (_line_complete) {
+            if (!collect(_eol_seq.data(), _eol_seq.size())) {
+                return false;
+            }
+
+            // unterminated comment
+            if (_eof) {
+                return false;
+            }
+
+            ++_line_number;
+
+            if (!_read_line(is)) {
+                return false;
+            }
+
+            from = 0;
+        }
+        else {
+            // next chunk of a partial line, keeping the text which 
+            // might begin the terminator
+            const size_t back = end_comment.size() - 1;
+            const size_t shift = _line_shift;
+
+            if (!_fill_window(is, back)) {
+                return false;
+            }
+
+            from -= std::min(from, _line_shift - shift);
+            from = std::max(from, _pos - std::min(_pos, back));
+        }
+
+        end_comment_offset = _textline.find(end_comment, from);
+
+        if (end_comment_offset == string_t::npos) {
+            if (!collect(_textline.data() + _pos, _textline.size() - _pos)) {
+                return false;
+            }
+
+            _pos = _textline.size();
+        }
+    }
+
+    const size_t end_pos = end_comment_offset + end_comment.size();
+
+    if (!collect(_textline.data() + _pos, end_pos - _pos)) {
+        return false;
+    }
+
+    if (_metrics_on) {
+        _mt_grown(capacity, _value.capacity());
+        _metrics.bytes_copied += _value.size() * sizeof(char_t);
+    }
+
+    _pos = end_pos;
+
+    _set_tkn(
+        tkn,
+        token_t::tcl_t::COMMENT,
+        _value.data(),
+        size,
+        0);
+
+    if (!_offsets_only) {
+        tkn.line = comment_line;
+        tkn.offset = comment_offset;
+    }
+
+    tkn.pos = comment_pos;
+    tkn.end = _line_start + _line_shift + end_pos;
+    tkn.id = def->id;
+    found = true;
+
+    _pf_hit(def->slot, pf_begin);
+
+    return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+void tknzr_t::_get_comment_chunk(
+    const tkn_idx_t::entry_t * def, 
+    size_t from, 
+    tkn_view_t & tkn)
+{
+    const auto & end_comment = *def->tail;
+    const size_t end_comment_offset = _textline.find(end_comment, from);
+
+    size_t end_pos = _textline.size();
+
+    if (end_comment_offset != string_t::npos) {
+        end_pos = end_comment_offset + end_comment.size();
+        _ml_com_open = nullptr;
+    }
+    else {
+        // a partial line might end with the beginning of the terminator
+        if (!_line_complete) {
+            end_pos -= std::min(end_comment.size() - 1, end_pos - from);
+        }
+
+        _ml_com_open = def;
+    }
+
+    _set_tkn(
+        tkn,
+        token_t::tcl_t::COMMENT,
+        _textline.data() + _pos,
+        end_pos - _pos,
+        _pos);
+
+    tkn.id = def->id;
+    _pos = end_pos;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool tknzr_t::_scan(_istream & is, tkn_view_t & tkn)
 {
-    auto it = tknset.rbegin();
+    uint64_t start = 0;
+
+    // one call every sampling period is timed
+    if (_metrics_on && _mt_period) {
+        if (_mt_countdown == 0) {
+            _mt_countdown = _mt_period;
+            _mt_timing = true;
+            _mt_matcher = 
+                static_cast<size_t>(tknzr_metrics_t::matcher_t::OTHER);
+            _mt_last = start = _mt_now();
+            _mt_reads = 1;
+        }
+
+        --_mt_countdown;
+    }
 
-    for (; it != tknset.rend(); ++it) {
-        auto & tkn = *it;
+    const bool ok = _scan_tkn(is, tkn);
 
-        if (tkn.size() <= line.size()) {
-            if (line.substr(0, tkn.size()) == tkn) {
-                return it;
-            }
+    if (_metrics_on && _mt_timing) {
+        const uint64_t now = _mt_now();
+        _metrics.matcher_ns[_mt_matcher] += _mt_elapsed(_mt_last, now, 1);
+        _metrics.latency.record(_mt_elapsed(start, now, _mt_reads));
+        ++_metrics.sampled;
+        _mt_timing = false;
+    }
+
+    if (!ok) {
+        _error = 
+            _mem_failed ? error_t::MEM_LIMIT : 
+            _tkn_too_long ? error_t::TOKEN_SIZE : 
+            _bad_indent ? error_t::INDENT : 
+            error_t::SCAN;
+
+        _tkn_too_long = false;
+        _bad_indent = false;
+
+        // buffers are given back rather than kept at the limit
+        if (_mem_failed) {
+            string_t().swap(_textline);
+            string_t().swap(_value);
+            _mem_failed = false;
+            _mem_sync();
         }
+
+        return false;
+    }
+
+    if (_metrics_on) {
+        ++_metrics.tokens[static_cast<size_t>(tkn.type)];
+    }
+
+    tkn.index = _tkn_index;
+
+    if (!_brkatom.empty()) {
+        _track_brackets(tkn);
     }
 
-    return it;
+    // end-of-file token is repeated on any further call
+    if (tkn.type != token_t::tcl_t::END_OF_FILE) {
+        ++_tkn_index;
+    }
+
+    return true;
 }
 
 
 /* -------------------------------------------------------------------------- */
 
-string_t tknzr_t::_extract_token(
-    const string_t& set_tkn,
-    string_t & line,
-    get_t cut_type)
+void tknzr_t::_track_brackets(const tkn_view_t & tkn)
 {
-    string_t token;
+    if (tkn.type == token_t::tcl_t::ATOM) {
+        auto it = _brkatom.find(tkn.id);
 
-    if (cut_type == get_t::WHOLE_LN) {
-        token = line;
-        line.clear();
+        if (it != _brkatom.end()) {
+            if (it->second.second) {
+                _brkidx.open(it->second.first, tkn, _tkn_index);
+            }
+            else {
+                _brkidx.close(it->second.first, tkn, _tkn_index);
+            }
+        }
     }
-    else {
-        token = set_tkn;
-        line = line.substr(set_tkn.size(), line.size() - set_tkn.size());
+    else if (tkn.type == token_t::tcl_t::END_OF_FILE) {
+        _brkidx.end();
     }
-
-    return token;
 }
 
 
 /* -------------------------------------------------------------------------- */
 
-bool tknzr_t::_getline(
-    _istream & is, string_t & line, string_t& eol_s, bool & eof)
+bool tknzr_t::_indent_line()
 {
-    const bool cr = _eoldef.find(base_tknzr_t::eol_t::CR) != _eoldef.end();
-    const bool lf = _eoldef.find(base_tknzr_t::eol_t::LF) != _eoldef.end();
-
-    _stringstream ss;
+    size_t width = 0;
+    size_t i = 0;
 
-    eof = is.eof();
-
-    while (!eof) {
+    for (; i < _textline.size(); ++i) {
+        const char_t ch = _textline[i];
 
-        if (is.bad()) {
-            return false;
+        if (ch == _T(' ')) {
+            ++width;
+        }
+        else if (ch == _T('\t')) {
+            width = (width / _tab_size + 1) * _tab_size;
+        }
+        else {
+            break;
         }
+    }
 
-        char_t ch = 0;
-        is >> ch;
+    // blank and comment-only lines do not change indentation
+    if (i == _textline.size() || 
+        _match(_sl_comidx, i) || 
+        _match(_ml_comidx, i)) 
+    {
+        return true;
+    }
 
-        eof = is.eof() || ch == 0;
+    if (_indents.empty()) {
+        _indents.push_back(0);
+    }
 
-        if (eof) {
-            line = ss.str();
-            eol_s = _T("");
-            return true;
-        }
+    // closed levels are popped as their dedent tokens are delivered
+    size_t level = _indents.size() - 1;
 
-        if (cr && ch == _T('\r')) {
-            line = ss.str();
-            eol_s = _T("\r");
-            return true;
-        }
+    while (width < _indents[level]) {
+        --level;
+        ++_dedent_pending;
+    }
 
-        if (lf && ch == _T('\n')) {
-            line = ss.str();
-            eol_s = _T("\n");
-            return true;
+    if (width > _indents[level]) {
+        // a dedent must reach the width of an outer level
+        if (_dedent_pending) {
+            _dedent_pending = 0;
+            return false;
         }
 
-        ss << ch;
+        _indent_width = width;
+        _indent_pending = true;
     }
 
-    return false;
+    return true;
 }
 
 
 /* -------------------------------------------------------------------------- */
 
-void tknzr_t::_reset()
+bool tknzr_t::_search_indent(tkn_view_t & tkn)
 {
-    _textline.clear();
-    _eol_seq.clear();
-    _offset = 0;
-    _line_number = 0;
-    _eof = false;
-}
+    if (_dedent_pending == 0 && !_indent_pending) {
+        return false;
+    }
 
+    // dedent tokens close the innermost levels first, then any indent 
+    // opens the new one
+    if (_dedent_pending) {
+        --_dedent_pending;
 
-/* -------------------------------------------------------------------------- */
+        _set_tkn(tkn, token_t::tcl_t::DEDENT, _textline.data(), 0, 0);
+        tkn.width = _indents.back();
 
-std::unique_ptr<token_t> tknzr_t::_search_eof()
-{
-    if (_eof) {
-        auto token_obj = new token_t(
-            token_t::tcl_t::END_OF_FILE,
-            _eol_seq,
-            _line_number,
-            _offset);
+        _indents.pop_back();
+    }
+    else {
+        _indent_pending = false;
+        _indents.push_back(_indent_width);
 
-        return std::unique_ptr<token_t>(token_obj);
+        _set_tkn(tkn, token_t::tcl_t::INDENT, _textline.data(), 0, 0);
+        tkn.width = _indent_width;
     }
 
-    return nullptr;
+    return true;
 }
 
 
 /* -------------------------------------------------------------------------- */
 
-std::unique_ptr<token_t> tknzr_t::_search_eol()
+bool tknzr_t::_search_eof_dedent(tkn_view_t & tkn)
 {
-    if (!_eol_seq.empty()) {
-        auto token_obj = new token_t(
-            token_t::tcl_t::END_OF_LINE,
-            _eol_seq,
-            _line_number,
-            _offset);
+    if (_tab_size == 0 || !_eof || _indents.size() <= 1) {
+        return false;
+    }
 
-        ++_line_number;
-        _offset = 0;
-        _eol_seq.clear();
+    _set_tkn(tkn, token_t::tcl_t::DEDENT, _textline.data(), 0, _pos);
+    tkn.width = _indents.back();
 
-        return std::unique_ptr<token_t>(token_obj);
-    }
+    _indents.pop_back();
 
-    return nullptr;
+    return true;
 }
 
 
 /* -------------------------------------------------------------------------- */
 
-std::unique_ptr<token_t> tknzr_t::_search_other_tkn()
+bool tknzr_t::_scan_tkn(_istream & is, tkn_view_t & tkn)
 {
-    if (!_other_token.empty())
-    {
-        auto token_obj = new token_t(
-            token_t::tcl_t::OTHER,
-            _other_token,
-            _line_number,
-            _offset);
+    is.unsetf(std::ios_base::skipws);
 
-        _offset += _other_token.size();
-        _other_token.clear();
+    while (true) {
 
-        return std::unique_ptr<token_t>(token_obj);
-    }
+        // indent and dedent tokens of a new line
+        if (_search_indent(tkn)) {
+            return true;
+        }
 
-    return nullptr;
-}
+        if (_window) {
+            _mt_mark(tknzr_metrics_t::matcher_t::READ);
 
+            if (!_fill_window(is)) {
+                _reset();
+                return false;
+            }
 
-/* -------------------------------------------------------------------------- */
+            // other tokens are kept whole up to the token size limit
+            if (_other_pos != string_t::npos && 
+                _pos - _other_pos > _window_max) 
+            {
+                _tkn_too_long = true;
+                _reset();
+                return false;
+            }
+        }
 
-std::unique_ptr<token_t> tknzr_t::_get_tkn(
-    const std::set<string_t> & tknset,
-    token_t::tcl_t tkncl,
-    get_t cut_type)
-{
-    if (_is_prefix_ch(_textline[0], tknset)) {
+        if (_pos >= _textline.size()) {
+            _mt_mark(tknzr_metrics_t::matcher_t::OTHER);
 
-        auto it = _search_token(tknset, _textline);
+            // other token
+            if (_search_other_tkn(tkn)) {
+                return true;
+            }
 
-        if (it != tknset.rend()) {
+            // end-of-line token
+            if (_search_eol(tkn)) {
+                return true;
+            }
 
-            auto tkn = _search_other_tkn();
-            if (tkn) {
-                return tkn;
+            // unterminated multi-line comment
+            if (_ml_com_open && _eof) {
+                _reset();
+                return false;
             }
 
-            auto token = *it;
+            // dedent tokens closing any level at end of file
+            if (_search_eof_dedent(tkn)) {
+                return true;
+            }
 
-            if (cut_type == get_t::WHOLE_LN) {
-                token = _textline;
-                _textline.clear();
+            // end-of-file (virtual) token
+            if (_search_eof(tkn)) {
+                return true;
             }
-            else {
-                _textline = 
-                    _textline.substr(
-                        token.size(), 
-                        _textline.size() - token.size());
+
+            // read a text line
+            _mt_mark(tknzr_metrics_t::matcher_t::READ);
+
+            if (!_read_line(is)) {
+                _reset();
+                return false;
             }
 
-            auto token_obj = new token_t(
-                tkncl,
-                token,
-                _line_number,
-                _offset);
+            if (_tab_size && !_ml_com_open && !_indent_line()) {
+                _bad_indent = true;
+                _reset();
+                return false;
+            }
+
+            continue;
+        }
 
-            _offset += token.size();
+        // multi-line commment
+        _mt_mark(tknzr_metrics_t::matcher_t::COMMENT);
+        bool found = false;
 
-            return std::unique_ptr<token_t>(token_obj);
+        if (!_get_comment(is, tkn, found)) {
+            _reset();
+            return false;
         }
-    }
 
-    return nullptr;
-}
+        if (found) {
+            return true;
+        }
 
+        if (_pos >= _textline.size()) {
+            continue;
+        }
 
-/* -------------------------------------------------------------------------- */
+        const size_t start = _pos;
+        const bool matched = _match_tkn(tkn);
 
-bool tknzr_t::_ml_comment_begin( 
-    const std::set<ml_commdef_t> & tknset,
-    string_t& end_comment)
-{
-    for (const auto & item : tknset) {
-        
-        const auto& prefix = item.first;
+        if (_mem_failed) {
+            _reset();
+            return false;
+        }
 
-        if (prefix.size() <= _textline.size() &&
-            _textline.substr(0, prefix.size()) == prefix) 
+        // a token reaching the end of a partial line might go on beyond 
+        // the window, which then grows to fit it before scanning again
+        if (_window && !_line_complete && 
+            (_str_open || (matched && _pos >= _textline.size()))) 
         {
-            end_comment = item.second;
+            _pos = start;
+            _str_open = false;
+
+            if (!_grow_window(is)) {
+                _reset();
+                return false;
+            }
+
+            continue;
+        }
+
+        if (matched) {
             return true;
         }
+
+        // append to other token 
+        _mt_mark(tknzr_metrics_t::matcher_t::OTHER);
+
+        if (_other_pos == string_t::npos) {
+            _other_pos = _pos;
+        }
+
+        ++_pos;
+    }
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool tknzr_t::_match_tkn(tkn_view_t & tkn)
+{
+    // blank
+    _mt_mark(tknzr_metrics_t::matcher_t::BLANK);
+    const auto blk_cut = _blank_run ? get_t::TKN_RUN : get_t::JUST_TKN;
+
+    if (_get_tkn(_blkidx, token_t::tcl_t::BLANK, blk_cut, tkn)) {
+        return true;
+    }
+
+    // single-line comment
+    _mt_mark(tknzr_metrics_t::matcher_t::COMMENT);
+
+    if (_get_tkn(_sl_comidx, token_t::tcl_t::COMMENT, get_t::WHOLE_LN, tkn)) {
+        return true;
+    }
+
+    // number (if longer than any atom or pattern)
+    _mt_mark(tknzr_metrics_t::matcher_t::NUMBER);
+
+    if (_get_number(tkn)) {
+        return true;
+    }
+
+    // pattern (if longer than any atom)
+    _mt_mark(tknzr_metrics_t::matcher_t::PATTERN);
+
+    if (_get_pattern(tkn)) {
+        return true;
+    }
+
+    // atomic token
+    _mt_mark(tknzr_metrics_t::matcher_t::ATOM);
+
+    if (_get_tkn(_atomidx, token_t::tcl_t::ATOM, get_t::JUST_TKN, tkn)) {
+        return true;
+    }
+
+    // string
+    _mt_mark(tknzr_metrics_t::matcher_t::STRING);
+
+    if (_get_string(tkn)) {
+        return true;
     }
 
     return false;
@@ -273,281 +1939,431 @@ bool tknzr_t::_ml_comment_begin(
 
 /* -------------------------------------------------------------------------- */
 
-std::unique_ptr<token_t> tknzr_t::_get_string()
+std::unique_ptr<token_t> tknzr_t::next(_istream & is)
 {
-    if (_textline.size() < 2) {
+    tkn_view_t tkn;
+
+    if (!_scan(is, tkn)) {
         return nullptr;
     }
 
-    const auto quote_ch = _textline[0];
-    auto quote_esc_it = _strdef.find(quote_ch);
+    if (_metrics_on) {
+        // token object, and its value unless it fits the string object
+        static const size_t sso_size = string_t().capacity();
 
-    if (quote_esc_it == _strdef.end()) {
-        return nullptr;
+        _metrics.allocations += tkn.size > sso_size ? 2 : 1;
+        _metrics.bytes_copied += tkn.size * sizeof(char_t);
     }
 
-    const auto esc_cnvt = quote_esc_it->second;
-    const char_t esc_ch =
-        esc_cnvt ? esc_cnvt->escape_char() : 0;
+    auto token_obj = new token_t(
+        tkn.type,
+        tkn.value(),
+        tkn.line,
+        tkn.offset,
+        tkn.quote,
+        tkn.esc,
+        tkn.sym,
+        tkn.id,
+        tkn.num,
+        tkn.index,
+        tkn.pos,
+        tkn.end,
+        tkn.width);
+
+    return std::unique_ptr<token_t>(token_obj);
+}
 
-    if (_textline.size() == 2 && _textline[1] != quote_ch) {
-        return nullptr;
-    }
 
-    _stringstream ss;
+/* -------------------------------------------------------------------------- */
+
+bool tknzr_t::eos(_istream & is)
+{
+    if (_pos >= _textline.size() && 
+        _other_pos == string_t::npos && 
+        _eol_seq.empty()) 
+    {
+        return is.eof();
+    }
 
-    size_t extra_ch_cnt = 2; /* quotes + any esc */
+    return false;
+}
 
-    for (size_t i = 1; i < _textline.size(); ++i) {
-        char_t ch = _textline[i];
 
-        if (esc_cnvt && ch == esc_ch) {
-            size_t remove_cnt = 0;
-            if (!esc_cnvt->convert(_textline.c_str() + i, remove_cnt, ch)) {
-                return nullptr;
-            }
-            i += (remove_cnt - 1);
-            extra_ch_cnt += (remove_cnt - 1);
-        }
-        else if (ch == quote_ch) {
-            const auto str = ss.str();
+/* -------------------------------------------------------------------------- */
 
-            auto token_obj = new token_t(
-                token_t::tcl_t::STRING,
-                str,
-                _line_number,
-                _offset,
-                quote_ch,
-                esc_ch);
+bool tknzr_t::stats(_istream & is, tknzr_stats_t & st)
+{
+    const size_t first_line = _offsets_only ? 
+        _lineidx.size() : _line_number;
 
-            const auto off = str.size() + extra_ch_cnt;
+    tkn_view_t tkn;
+    bool ok = true;
 
-            _offset += off;
+    _counts_only = true;
 
-            if (_textline.size() <= off) {
-                _textline.clear();
-            }
-            else {
-                _textline = _textline.substr(off, _textline.size() - off);
-            }
+    do {
+        ok = _scan(is, tkn);
 
-            return std::unique_ptr<token_t>(token_obj);
+        if (ok) {
+            st.count(tkn.type, tkn.size);
         }
+    } 
+    while (ok && tkn.type != token_t::tcl_t::END_OF_FILE);
 
-        ss << ch;
-    }
+    _counts_only = false;
+
+    if (ok) {
+        const size_t line = _offsets_only ? 
+            _lineidx.line(tkn.pos) : tkn.line;
 
+        st.lines += line + 1 - first_line;
+    }
 
-    return nullptr;
+    return ok;
 }
 
 
 /* -------------------------------------------------------------------------- */
 
-std::unique_ptr<token_t>
-tknzr_t::_extract_comment(
-    string_t & comment,
-    size_t end_comment_offset,
-    string_t& end_comment,
-    size_t line_number,
-    size_t offset)
+uint64_t tknzr_t::fingerprint() const
 {
-    if (end_comment_offset != string_t::npos) {
-        auto left_comment = _textline.substr(
-            0, 
-            end_comment_offset + end_comment.size());
+    uint64_t h = hash64_t::hash("miptknzr", 8);
 
-        if (left_comment.size() >= _textline.size()) {
-            _textline.clear();
-        }
-        else {
-            _textline = _textline.c_str() + left_comment.size();
+    auto add_str = [&h](const string_t & s) {
+        const auto sh = hash64_t::hash(s.data(), s.size() * sizeof(char_t));
+        h = hash64_t::combine(h, sh);
+    };
+
+    auto add_defs = [&](const tkndef_t & defs) {
+        h = hash64_t::combine(h, defs.size());
+
+        for (const auto & def : defs) {
+            add_str(def.first);
+            h = hash64_t::combine(h, def.second);
         }
+    };
 
-        comment += left_comment;
+    add_defs(_blkdef);
+    add_defs(_atomdef);
+    add_defs(_kwdef);
+    add_defs(_patdef);
+    add_defs(_sl_comdef);
 
-        auto token_obj = new token_t(
-            token_t::tcl_t::COMMENT,
-            comment,
-            line_number,
-            offset);
+    h = hash64_t::combine(h, _ml_comdef.size());
+
+    for (const auto & def : _ml_comdef) {
+        add_str(def.first.first);
+        add_str(def.first.second);
+        h = hash64_t::combine(h, def.second);
+    }
+
+    h = hash64_t::combine(h, _brkdef.size());
+
+    for (const auto & def : _brkdef) {
+        add_str(def.first.first);
+        add_str(def.first.second);
+    }
 
-        _offset += left_comment.size();
-        comment.clear();
+    for (const auto & eol : _eoldef) {
+        h = hash64_t::combine(h, 0x100 + static_cast<uint64_t>(eol));
+    }
+
+    for (const auto & num : _numdef) {
+        h = hash64_t::combine(h, 0x200 + static_cast<uint64_t>(num));
+    }
 
-        return std::unique_ptr<token_t>(token_obj);
+    for (const auto & str : _strdef) {
+        h = hash64_t::combine(h, static_cast<uint64_t>(str.first));
+        h = hash64_t::combine(h, 
+            str.second ? static_cast<uint64_t>(str.second->escape_char()) : 0);
     }
 
-    return nullptr;
+    h = hash64_t::combine(h, _tab_size);
+    h = hash64_t::combine(h, _blank_run);
+    h = hash64_t::combine(h, _utf8);
+    h = hash64_t::combine(h, _window);
+    h = hash64_t::combine(h, _window_max);
+    h = hash64_t::combine(h, static_cast<uint64_t>(_ml_com_mode));
+    h = hash64_t::combine(h, _offsets_only);
+
+    return h;
 }
 
 
 /* -------------------------------------------------------------------------- */
 
-std::unique_ptr<token_t> tknzr_t::_get_comment(_istream & is)
+static const char _grammar_magic[4] = { 'M', 'T', 'K', 'G' };
+static const uint32_t _grammar_endian = 0x01020304;
+
+
+/* -------------------------------------------------------------------------- */
+
+bool tknzr_t::save_grammar(std::vector<char> & blob) const
 {
-    string_t comment;
-    string_t end_comment;
+    blob.clear();
 
-    const size_t comment_line = _line_number;
-    const size_t comment_offset = _offset;
+    blob_writer_t out(blob);
+
+    out.put(_grammar_magic);
+    out.put(_grammar_endian);
+    out.put(static_cast<uint32_t>(grammar_version));
+    out.put(static_cast<uint32_t>(sizeof(char_t)));
 
-    if (_ml_comment_begin(_ml_comdef, end_comment)) {
-        auto tkn = _search_other_tkn();
+    auto put_defs = [&out](const tkndef_t & defs) {
+        out.put_size(defs.size());
 
-        if (tkn) {
-            return tkn;
+        for (const auto & def : defs) {
+            out.put_str(def.first);
+            out.put_size(def.second);
         }
+    };
 
-        size_t end_comment_offset = _textline.find(end_comment);
+    put_defs(_blkdef);
+    put_defs(_atomdef);
+    put_defs(_kwdef);
+    put_defs(_patdef);
+    put_defs(_sl_comdef);
 
-        tkn = _extract_comment(
-            comment, 
-            end_comment_offset, 
-            end_comment,
-            comment_line,
-            comment_offset);
+    out.put_size(_ml_comdef.size());
 
-        if (tkn) {
-            return tkn;
-        }
+    for (const auto & def : _ml_comdef) {
+        out.put_str(def.first.first);
+        out.put_str(def.first.second);
+        out.put_size(def.second);
+    }
 
-        bool eof = false;
-        while (!eof && end_comment_offset == string_t::npos) {
-            comment += _textline;
-            comment += _eol_seq;
-            
-            ++_line_number;
-            _offset = 0;
-            _textline.clear();
-            _eol_seq.clear();
+    out.put_size(_brkdef.size());
 
-            if (!_getline(is, _textline, _eol_seq, eof)) {
-                return nullptr;
-            }
+    for (const auto & def : _brkdef) {
+        out.put_str(def.first.first);
+        out.put_str(def.first.second);
+        out.put_size(def.second);
+    }
+
+    out.put_size(_eoldef.size());
 
-            end_comment_offset = _textline.find(end_comment);
+    for (const auto & eol : _eoldef) {
+        out.put(static_cast<uint32_t>(eol));
+    }
 
-            tkn = _extract_comment(
-                comment, 
-                end_comment_offset, 
-                end_comment,
-                comment_line,
-                comment_offset);
+    out.put_size(_numdef.size());
 
-            if (tkn) {
-                return tkn;
-            }
+    for (const auto & num : _numdef) {
+        out.put(static_cast<uint32_t>(num));
+    }
+
+    out.put_size(_strdef.size());
+
+    for (const auto & str : _strdef) {
+        // only the library escape converter can be restored
+        if (str.second && typeid(*str.second) != typeid(esc_cnvrtr_t)) {
+            blob.clear();
+            return false;
         }
+
+        out.put(static_cast<uint32_t>(str.first));
+        out.put(static_cast<uint8_t>(str.second ? 1 : 0));
+        out.put(static_cast<uint32_t>(
+            str.second ? str.second->escape_char() : 0));
     }
 
-    return nullptr;
+    out.put_size(_tab_size);
+    out.put_size(_window);
+    out.put_size(_window_max);
+    out.put(static_cast<uint32_t>(_ml_com_mode));
+    out.put(static_cast<uint8_t>(_blank_run));
+    out.put(static_cast<uint8_t>(_utf8));
+    out.put(static_cast<uint8_t>(
+        (_line_idx_on ? 1 : 0) | (_offsets_only ? 2 : 0)));
+
+    _kwidx.save(out);
+    _patdfa.save(out);
+
+    return true;
 }
 
 
 /* -------------------------------------------------------------------------- */
 
-std::unique_ptr<token_t> tknzr_t::next(_istream & is)
+bool tknzr_t::save_grammar(const std::string & path) const
 {
-    is.unsetf(std::ios_base::skipws);
+    std::vector<char> blob;
 
-    std::unique_ptr<token_t> tkn;
+    if (!save_grammar(blob)) {
+        return false;
+    }
 
-    while (!tkn) {
+    std::ofstream os(path, std::ios::binary | std::ios::trunc);
 
-        if (_textline.empty()) {
+    return os && os.write(blob.data(), blob.size());
+}
 
-            // other token
-            auto tkn = _search_other_tkn();
 
-            if (tkn) {
-                return tkn;
-            }
+/* -------------------------------------------------------------------------- */
 
-            // end-of-line token
-            tkn = _search_eol();
-            if (tkn) {
-                return tkn;
-            }
+bool tknzr_t::_load_grammar(const char * data, size_t size)
+{
+    blob_reader_t in(data, size);
+
+    char magic[4] = { 0 };
+    uint32_t endian = 0;
+    uint32_t version = 0;
+    uint32_t char_size = 0;
+
+    if (!in.get(magic) || 
+        std::memcmp(magic, _grammar_magic, sizeof(magic)) != 0 ||
+        !in.get(endian) || endian != _grammar_endian ||
+        !in.get(version) || version != grammar_version ||
+        !in.get(char_size) || char_size != sizeof(char_t))
+    {
+        return false;
+    }
 
-            // end-of-file (virtual) token
-            tkn = _search_eof();
-            if (tkn) {
-                return tkn;
-            }
+    auto get_defs = [&in](tkndef_t & defs) {
+        size_t cnt = 0;
+        in.get_size(cnt);
 
-            // read a text line
-            if (!_getline(is, _textline, _eol_seq, _eof)) {
-                _reset();
-                return nullptr;
+        for (size_t i = 0; i < cnt && in.ok(); ++i) {
+            string_t value;
+            size_t id = 0;
+
+            if (in.get_str(value) && in.get_size(id)) {
+                defs.insert(std::make_pair(value, id));
             }
         }
+    };
 
-        // multi-line commment
-        auto tkn = _get_comment(is);
-        if (tkn) {
-            return tkn;
-        }
+    auto get_pairs = [&in](std::map<ml_commdef_t, size_t> & defs) {
+        size_t cnt = 0;
+        in.get_size(cnt);
 
-        // blank
-        tkn = _get_tkn(_blkdef, token_t::tcl_t::BLANK, get_t::JUST_TKN);
+        for (size_t i = 0; i < cnt && in.ok(); ++i) {
+            ml_commdef_t value;
+            size_t id = 0;
 
-        if (tkn) {
-            return tkn;
+            if (in.get_str(value.first) && 
+                in.get_str(value.second) && 
+                in.get_size(id)) 
+            {
+                defs.insert(std::make_pair(value, id));
+            }
         }
+    };
 
-        // single-line comment
-        tkn = _get_tkn(_sl_comdef, token_t::tcl_t::COMMENT, get_t::WHOLE_LN);
+    get_defs(_blkdef);
+    get_defs(_atomdef);
+    get_defs(_kwdef);
+    get_defs(_patdef);
+    get_defs(_sl_comdef);
+    get_pairs(_ml_comdef);
+    get_pairs(_brkdef);
 
-        if (tkn) {
-            return tkn;
-        }
+    size_t cnt = 0;
+    in.get_size(cnt);
 
-        // atomic token
-        tkn = _get_tkn(_atomdef, token_t::tcl_t::ATOM, get_t::JUST_TKN);
+    for (size_t i = 0; i < cnt && in.ok(); ++i) {
+        uint32_t eol = 0;
 
-        if (tkn) {
-            return tkn;
+        if (in.get(eol)) {
+            _eoldef.insert(static_cast<base_tknzr_t::eol_t>(eol));
         }
+    }
+
+    cnt = 0;
+    in.get_size(cnt);
 
-        // string
-        tkn = _get_string();
+    for (size_t i = 0; i < cnt && in.ok(); ++i) {
+        uint32_t num = 0;
 
-        if (tkn) {
-            return tkn;
+        if (in.get(num)) {
+            _numdef.insert(static_cast<base_tknzr_t::num_t>(num));
         }
+    }
+
+    cnt = 0;
+    in.get_size(cnt);
+
+    for (size_t i = 0; i < cnt && in.ok(); ++i) {
+        uint32_t quote = 0;
+        uint8_t has_esc = 0;
+        uint32_t esc = 0;
+
+        if (in.get(quote) && in.get(has_esc) && in.get(esc)) {
+            std::shared_ptr<base_esc_cnvrtr_t> cnvrtr;
 
-        // append to other token buffer 
-        if (!_textline.empty()) {
-            _other_token += _textline[0];
+            if (has_esc) {
+                cnvrtr = std::make_shared<esc_cnvrtr_t>(
+                    static_cast<char_t>(esc));
+            }
 
-            _textline =
-                _textline.size() == 1 ? _T("") :
-                _textline.substr(1, _textline.size() - 1);
+            _strdef[static_cast<char_t>(quote)] = cnvrtr;
         }
     }
 
-    _reset();
-    return nullptr;
+    uint32_t ml_com_mode = 0;
+    uint8_t blank_run = 0;
+    uint8_t utf8 = 0;
+    uint8_t line_idx_on = 0;
+
+    in.get_size(_tab_size);
+    in.get_size(_window);
+    in.get_size(_window_max);
+    in.get(ml_com_mode);
+    in.get(blank_run);
+    in.get(utf8);
+    in.get(line_idx_on);
+
+    if (ml_com_mode > static_cast<uint32_t>(base_tknzr_t::comment_t::CHUNKS)) {
+        return false;
+    }
+
+    _ml_com_mode = static_cast<base_tknzr_t::comment_t>(ml_com_mode);
+    _blank_run = blank_run != 0;
+    _utf8 = utf8 != 0;
+    _line_idx_on = (line_idx_on & 1) != 0;
+    _offsets_only = (line_idx_on & 2) != 0;
+
+    return in.ok() && 
+        _kwidx.load(in) && 
+        _patdfa.load(in) && 
+        in.end() && 
+        _index_defs();
 }
 
 
 /* -------------------------------------------------------------------------- */
 
-bool tknzr_t::eos(_istream & is)
+size_t tknzr_t::column(const tkn_view_t & tkn) const noexcept
 {
-    if (_textline.empty() && _other_token.empty() && _eol_seq.empty()) {
-        return is.eof();
+    // offsets-only tokens do not carry their offset
+    const size_t offset = _offsets_only ? 
+        _lineidx.column(tkn.pos) : tkn.offset;
+
+#ifndef _UNICODE
+    if (_utf8) {
+        // code points are counted on the buffered text only
+        if (tkn.pos < _line_start + _line_shift || 
+            offset < _line_shift ||
+            offset - _line_shift > _textline.size()) 
+        {
+            return token_t::npos;
+        }
+
+        return _line_shift_cp + 
+            utf8_t::length(_textline.data(), offset - _line_shift);
     }
+#endif
 
-    return false;
+    return offset;
 }
 
 
 /* -------------------------------------------------------------------------- */
 
 tknzr_t::~tknzr_t() 
-{}
+{
+    _mem_release();
+}
 
 
 /* -------------------------------------------------------------------------- */
@@ -557,4 +2373,3 @@ tknzr_t::~tknzr_t()
 
 /* -------------------------------------------------------------------------- */
 
-
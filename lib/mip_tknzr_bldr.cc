@@ -10,6 +10,8 @@
 /* -------------------------------------------------------------------------- */
 
 #include "mip_tknzr_bldr.h"
+#include "mip_file_map.h"
+#include "mip_utf8.h"
 
 #include <cassert>
 #include <memory>
@@ -26,6 +28,7 @@ bool tknzr_bldr_t::_build_tknzr()
 {
     if (!_tknzr) {
         _tknzr.reset(new tknzr_t());
+        _ids.clear();
 
         assert(_tknzr);
 
@@ -42,10 +45,54 @@ bool tknzr_bldr_t::_build_tknzr()
 
 std::unique_ptr< base_tknzr_t > tknzr_bldr_t::build()
 {
+    return build_engine();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+std::unique_ptr< tknzr_t > tknzr_bldr_t::build_engine()
+{
+    if (_tknzr && !_tknzr->_build_idx()) {
+        _tknzr.reset();
+    }
+
+    _ids.clear();
+
     return std::move(_tknzr);
 }
 
 
+/* -------------------------------------------------------------------------- */
+
+std::unique_ptr< tknzr_t > tknzr_bldr_t::load_engine(
+    const char * data, 
+    size_t size)
+{
+    std::unique_ptr< tknzr_t > tknzr(new tknzr_t());
+
+    if (!tknzr || !tknzr->_load_grammar(data, size)) {
+        return nullptr;
+    }
+
+    return tknzr;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+std::unique_ptr< tknzr_t > tknzr_bldr_t::load_engine(const std::string & path)
+{
+    file_map_t blob;
+
+    if (!blob.open(path)) {
+        return nullptr;
+    }
+
+    return load_engine(blob.data(), blob.size());
+}
+
+
 /* -------------------------------------------------------------------------- */
 
 bool tknzr_bldr_t::def_atom(const string_t& value)
@@ -54,6 +101,14 @@ bool tknzr_bldr_t::def_atom(const string_t& value)
 }
 
 
+/* -------------------------------------------------------------------------- */
+
+bool tknzr_bldr_t::def_atom(const string_t& value, size_t id)
+{
+    return _def_item(value, id, _tknzr->_atomdef);
+}
+
+
 /* -------------------------------------------------------------------------- */
 
 bool tknzr_bldr_t::def_atom(const std::set<string_t>& value_set)
@@ -62,6 +117,71 @@ bool tknzr_bldr_t::def_atom(const std::set<string_t>& value_set)
 }
 
 
+/* -------------------------------------------------------------------------- */
+
+bool tknzr_bldr_t::def_keyword(const string_t& value)
+{
+    return _def_item(value, _tknzr->_kwdef);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool tknzr_bldr_t::def_keyword(const string_t& value, size_t id)
+{
+    return _def_item(value, id, _tknzr->_kwdef);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool tknzr_bldr_t::def_keyword(const std::set<string_t>& value_set)
+{
+    return _def_item(value_set, _tknzr->_kwdef);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool tknzr_bldr_t::def_pattern(const string_t& pattern)
+{
+    return def_pattern(pattern, _next_id(_tknzr->_patdef));
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool tknzr_bldr_t::def_pattern(const string_t& pattern, size_t id)
+{
+    if (!dfa_t::valid(pattern)) {
+        return false;
+    }
+
+    return _def_item(pattern, id, _tknzr->_patdef);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool tknzr_bldr_t::def_bracket(const string_t& open, const string_t& close)
+{
+    if (open.empty() || close.empty() || open == close) {
+        return false;
+    }
+
+    std::pair<string_t, string_t> value{ open, close };
+
+    if (!_def_item(value, _tknzr->_brkdef)) {
+        return false;
+    }
+
+    def_atom(open);
+    def_atom(close);
+
+    return true;
+}
+
+
 /* -------------------------------------------------------------------------- */
 
 bool tknzr_bldr_t::def_blank(const string_t& value)
@@ -70,6 +190,14 @@ bool tknzr_bldr_t::def_blank(const string_t& value)
 }
 
 
+/* -------------------------------------------------------------------------- */
+
+bool tknzr_bldr_t::def_blank(const string_t& value, size_t id)
+{
+    return _def_item(value, id, _tknzr->_blkdef);
+}
+
+
 /* -------------------------------------------------------------------------- */
 
 bool tknzr_bldr_t::def_blank(const std::set<string_t>& value_set)
@@ -78,6 +206,90 @@ bool tknzr_bldr_t::def_blank(const std::set<string_t>& value_set)
 }
 
 
+/* -------------------------------------------------------------------------- */
+
+bool tknzr_bldr_t::def_blank_run(bool enable)
+{
+    if (!_build_tknzr()) {
+        return false;
+    }
+
+    _tknzr->_blank_run = enable;
+
+    return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool tknzr_bldr_t::def_utf8(bool unicode_blanks)
+{
+#ifdef _UNICODE
+    (void)unicode_blanks;
+    return false;
+#else
+    if (!_build_tknzr() || _tknzr->_utf8) {
+        return false;
+    }
+
+    _tknzr->_utf8 = true;
+
+    if (unicode_blanks) {
+        for (const auto & blank : utf8_t::blanks()) {
+            if (_tknzr->_blkdef.find(blank) == _tknzr->_blkdef.end()) {
+                _def_item(blank, _tknzr->_blkdef);
+            }
+        }
+    }
+
+    return true;
+#endif
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool tknzr_bldr_t::def_window(size_t size, size_t max_token)
+{
+    if (!_build_tknzr() || size == 0) {
+        return false;
+    }
+
+    _tknzr->_window = size;
+    _tknzr->_window_max = max_token ? max_token : 64 * size;
+
+    return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool tknzr_bldr_t::def_line_index(bool enable)
+{
+    if (!_build_tknzr()) {
+        return false;
+    }
+
+    _tknzr->_line_idx_on = enable;
+
+    return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool tknzr_bldr_t::def_offsets_only(bool enable)
+{
+    if (!_build_tknzr()) {
+        return false;
+    }
+
+    _tknzr->_offsets_only = enable;
+
+    return true;
+}
+
+
 /* -------------------------------------------------------------------------- */
 
 bool tknzr_bldr_t::def_eol(const base_tknzr_t::eol_t& value)
@@ -94,6 +306,22 @@ bool tknzr_bldr_t::def_eol(const std::set<base_tknzr_t::eol_t>& value_set)
 }
 
 
+/* -------------------------------------------------------------------------- */
+
+bool tknzr_bldr_t::def_number(const base_tknzr_t::num_t& value)
+{
+    return _def_item(value, _tknzr->_numdef);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool tknzr_bldr_t::def_number(const std::set<base_tknzr_t::num_t>& value_set)
+{
+    return _def_item(value_set, _tknzr->_numdef);
+}
+
+
 /* -------------------------------------------------------------------------- */
 
 bool tknzr_bldr_t::def_sl_comment(const string_t& prefix)
@@ -102,6 +330,14 @@ bool tknzr_bldr_t::def_sl_comment(const string_t& prefix)
 }
 
 
+/* -------------------------------------------------------------------------- */
+
+bool tknzr_bldr_t::def_sl_comment(const string_t& prefix, size_t id)
+{
+    return _def_item(prefix, id, _tknzr->_sl_comdef);
+}
+
+
 /* -------------------------------------------------------------------------- */
 
 bool tknzr_bldr_t::def_sl_comment(const std::set<string_t>& prefix_set)
@@ -121,6 +357,46 @@ bool tknzr_bldr_t::def_ml_comment(
 }
 
 
+/* -------------------------------------------------------------------------- */
+
+bool tknzr_bldr_t::def_ml_comment(
+    const string_t& begin,
+    const string_t& end,
+    size_t id)
+{
+    std::pair<string_t, string_t> value{ begin, end };
+    return _def_item(value, id, _tknzr->_ml_comdef);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool tknzr_bldr_t::def_ml_comment_mode(base_tknzr_t::comment_t mode)
+{
+    if (!_build_tknzr()) {
+        return false;
+    }
+
+    _tknzr->_ml_com_mode = mode;
+
+    return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool tknzr_bldr_t::def_indent(size_t tab_size)
+{
+    if (!_build_tknzr() || tab_size == 0 || _tknzr->_tab_size != 0) {
+        return false;
+    }
+
+    _tknzr->_tab_size = tab_size;
+
+    return true;
+}
+
+
 /* -------------------------------------------------------------------------- */
 
 bool tknzr_bldr_t::def_string(char_t quote, std::shared_ptr<base_esc_cnvrtr_t> et)
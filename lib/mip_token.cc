@@ -35,6 +35,16 @@ const char_t* token_t::type2str(tcl_t type) {
         return _T("other");
     case tcl_t::STRING:
         return _T("string");
+    case tcl_t::KEYWORD:
+        return _T("keyword");
+    case tcl_t::PATTERN:
+        return _T("pattern");
+    case tcl_t::NUMBER:
+        return _T("number");
+    case tcl_t::INDENT:
+        return _T("indent");
+    case tcl_t::DEDENT:
+        return _T("dedent");
     default:
         break;
     }
@@ -0,0 +1,167 @@
+//  
+// This file is part of MipTknzr Library Project
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.  
+// Licensed under the MIT License. 
+// See COPYING file in the project root for full license information.
+//
+
+
+/* -------------------------------------------------------------------------- */
+
+#include "mip_utf8.h"
+
+#include <cstdint>
+#include <cstring>
+
+
+/* -------------------------------------------------------------------------- */
+
+namespace mip {
+
+
+/* -------------------------------------------------------------------------- */
+
+static const uint64_t _hi_bits = 0x8080808080808080ULL;
+
+
+/* -------------------------------------------------------------------------- */
+
+static inline uint64_t _load_word(const char * data) noexcept
+{
+    uint64_t word;
+    std::memcpy(&word, data, sizeof(word));
+    return word;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+bool utf8_t::valid(const char * data, size_t size) noexcept
+{
+    const auto * s = reinterpret_cast<const unsigned char *>(data);
+    size_t i = 0;
+
+    while (i < size) {
+        // skip ASCII runs a word at a time
+        while (i + sizeof(uint64_t) <= size && 
+               (_load_word(data + i) & _hi_bits) == 0) 
+        {
+            i += sizeof(uint64_t);
+        }
+
+        if (i >= size) {
+            break;
+        }
+
+        const unsigned char c = s[i];
+
+        if (c < 0x80) {
+            ++i;
+            continue;
+        }
+
+        size_t n = 0;
+        unsigned char lo = 0x80;
+        unsigned char hi = 0xBF;
+
+        if (c >= 0xC2 && c <= 0xDF) {
+            n = 1;
+        }
+        else if (c >= 0xE0 && c <= 0xEF) {
+            n = 2;
+
+            // reject overlong forms and surrogates
+            if (c == 0xE0) {
+                lo = 0xA0;
+            }
+            else if (c == 0xED) {
+                hi = 0x9F;
+            }
+        }
+        else if (c >= 0xF0 && c <= 0xF4) {
+            n = 3;
+
+            // reject overlong forms and code points beyond U+10FFFF
+            if (c == 0xF0) {
+                lo = 0x90;
+            }
+            else if (c == 0xF4) {
+                hi = 0x8F;
+            }
+        }
+        else {
+            return false;
+        }
+
+        if (size - i <= n) {
+            return false;
+        }
+
+        if (s[i + 1] < lo || s[i + 1] > hi) {
+            return false;
+        }
+
+        for (size_t k = 2; k <= n; ++k) {
+            if ((s[i + k] & 0xC0) != 0x80) {
+                return false;
+            }
+        }
+
+        i += n + 1;
+    }
+
+    return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+size_t utf8_t::length(const char * data, size_t size) noexcept
+{
+    size_t count = 0;
+    size_t i = 0;
+
+    // ASCII words contain a code point per byte
+    while (i + sizeof(uint64_t) <= size) {
+        const uint64_t word = _load_word(data + i);
+
+        if ((word & _hi_bits) == 0) {
+            count += sizeof(uint64_t);
+        }
+        else {
+            for (size_t k = 0; k < sizeof(uint64_t); ++k) {
+                count += (data[i + k] & 0xC0) != 0x80;
+            }
+        }
+
+        i += sizeof(uint64_t);
+    }
+
+    for (; i < size; ++i) {
+        count += (data[i] & 0xC0) != 0x80;
+    }
+
+    return count;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+const std::set<std::string> & utf8_t::blanks()
+{
+    static const std::set<std::string> blanks = {
+        "\xC2\x85",     "\xC2\xA0",     "\xE1\x9A\x80", "\xE2\x80\x80",
+        "\xE2\x80\x81", "\xE2\x80\x82", "\xE2\x80\x83", "\xE2\x80\x84",
+        "\xE2\x80\x85", "\xE2\x80\x86", "\xE2\x80\x87", "\xE2\x80\x88",
+        "\xE2\x80\x89", "\xE2\x80\x8A", "\xE2\x80\xA8", "\xE2\x80\xA9",
+        "\xE2\x80\xAF", "\xE2\x81\x9F", "\xE3\x80\x80"
+    };
+
+    return blanks;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+} // namespace mip
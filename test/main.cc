@@ -20,6 +20,9 @@
 #include <set>
 #include <map>
 #include <fstream>
+#include <iterator>
+#include <cstdio>
+#include <thread>
 
 #ifdef _UNICODE
 #include <locale> 
@@ -30,14 +33,21 @@
 #include "mip_unicode.h"
 #include "mip_tknzr_bldr.h"
 #include "mip_esc_cnvrtr.h"
+#include "mip_utf_streambuf.h"
+#include "mip_tkn_cache.h"
+#include "mip_tknlst_bldr.h"
+#include "mip_static_grammar.h"
+#include "mip_hash.h"
+#include "mip_dfa.h"
+#include "mip_tkn_visitor.h"
+#include "mip_tkn_range.h"
 
 
 /* -------------------------------------------------------------------------- */
 
-int main(int argc, mip::char_t* argv[])
+//! Define the grammar of the sample tokenizer
+static void def_grammar(mip::tknzr_bldr_t & bldr)
 {
-    mip::tknzr_bldr_t bldr;
-
     bldr.def_atom(_T("("));
     bldr.def_atom(_T(")"));
     bldr.def_atom(_T(">"));
@@ -57,6 +67,1651 @@ int main(int argc, mip::char_t* argv[])
     bldr.def_string(_T('\"'), std::make_shared<mip::esc_cnvrtr_t>(_T('\\')));
 
     bldr.def_ml_comment(_T("/*"), _T("*/"));
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+//! The sample grammar declared at compile time, with keywords and numbers
+namespace sample_static {
+
+constexpr mip::char_t lpar[] = _T("("), rpar[] = _T(")"), gt[] = _T(">"), 
+    arrow[] = _T("->"), ge[] = _T(">="), semi[] = _T(";"), shl[] = _T("<<"),
+    kw_if[] = _T("if"), kw_else[] = _T("else"), slash2[] = _T("//"), 
+    hash[] = _T("#"), space[] = _T(" "), cr[] = _T("\r"), tab[] = _T("\t"),
+    com_begin[] = _T("/*"), com_end[] = _T("*/");
+
+using grammar_t = mip::static_grammar_t<
+    mip::atoms_t<lpar, rpar, gt, arrow, ge, semi, shl>,
+    mip::keywords_t<kw_if, kw_else>,
+    mip::sl_comments_t<slash2, hash>,
+    mip::blanks_t<space, cr, tab>,
+    mip::eols_t<mip::base_tknzr_t::eol_t::LF>,
+    mip::strings_t<mip::quote_t<_T('"'), _T('\\')>>,
+    mip::ml_comments_t<mip::ml_comment_t<com_begin, com_end>>,
+    mip::numbers_t<mip::base_tknzr_t::num_t::DEC, 
+        mip::base_tknzr_t::num_t::HEX, mip::base_tknzr_t::num_t::FLOAT>>;
+
+} // namespace sample_static
+
+
+/* -------------------------------------------------------------------------- */
+// Self-checks (run by "test --check")
+
+static int _failures = 0;
+
+static void _check(bool ok, const char* expr, int line)
+{
+    if (!ok) {
+        std::cerr << "main.cc:" << line << ": check failed: " << expr
+                  << std::endl;
+        ++_failures;
+    }
+}
+
+#define CHECK(expr) _check((expr), #expr, __LINE__)
+
+
+/* -------------------------------------------------------------------------- */
+
+static const mip::char_t* tcl_name(mip::token_t::tcl_t type)
+{
+    static const mip::char_t* const names[] = {
+        _T("blank"), _T("eol"), _T("eof"), _T("comment"), _T("string"),
+        _T("atom"), _T("other"), _T("keyword"), _T("pattern"), _T("number"),
+        _T("indent"), _T("dedent")
+    };
+
+    return names[static_cast<size_t>(type)];
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Build a tokenizer of the sample grammar
+static std::unique_ptr<mip::base_tknzr_t> sample()
+{
+    mip::tknzr_bldr_t bldr;
+    def_grammar(bldr);
+
+    return bldr.build();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Tokenize a text up to its end, return false in case of error
+static bool tokens(
+    mip::base_tknzr_t & tknzr, 
+    const mip::string_t & text, 
+    std::vector<mip::token_t> & res)
+{
+    mip::_istringstream is(text);
+
+    while (true) {
+        auto tkn = tknzr.next(is);
+
+        if (!tkn) {
+            return false;
+        }
+
+        res.push_back(*tkn);
+
+        if (tkn->type() == mip::token_t::tcl_t::END_OF_FILE) {
+            return true;
+        }
+    }
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Tokenize a text and describe its tokens as "class:value" items 
+//! separated by '|' (end-of-line and end-of-file have no value, indent 
+//! and dedent tokens show their width)
+static mip::string_t scan(
+    std::unique_ptr<mip::base_tknzr_t> tknzr, const mip::string_t & text)
+{
+    if (!tknzr) {
+        return _T("no tokenizer");
+    }
+
+    std::vector<mip::token_t> tkns;
+    const bool ok = tokens(*tknzr, text, tkns);
+
+    mip::string_t res;
+
+    for (const auto & tkn : tkns) {
+        if (!res.empty()) {
+            res += _T('|');
+        }
+
+        res += tcl_name(tkn.type());
+
+        if (tkn.type() == mip::token_t::tcl_t::INDENT ||
+            tkn.type() == mip::token_t::tcl_t::DEDENT)
+        {
+            res += _T(':');
+            res += _to_string(tkn.width());
+        }
+        else if (tkn.type() != mip::token_t::tcl_t::END_OF_LINE &&
+            tkn.type() != mip::token_t::tcl_t::END_OF_FILE) 
+        {
+            res += _T(':');
+            res += tkn.value();
+        }
+    }
+
+    return ok ? res : res + _T("|error");
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Build a tokenizer of the sample grammar with numbers and identifier 
+//! patterns, scanning through a window of the given size (if not 0)
+static std::unique_ptr<mip::tknzr_t> windowed(
+    size_t window, size_t max_token = 0)
+{
+    mip::tknzr_bldr_t bldr;
+    def_grammar(bldr);
+
+    bldr.def_number(mip::base_tknzr_t::num_t::DEC);
+    bldr.def_number(mip::base_tknzr_t::num_t::FLOAT);
+    bldr.def_pattern(_T("[A-Za-z_]\\w*"));
+    bldr.def_blank_run();
+
+    if (window) {
+        bldr.def_window(window, max_token);
+    }
+
+    return bldr.build_engine();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Tokenizer using the default base_tknzr_t::stats() implementation
+class fwd_tknzr_t : public mip::base_tknzr_t
+{
+public:
+    fwd_tknzr_t(std::unique_ptr<mip::base_tknzr_t> tknzr) :
+        _tknzr(std::move(tknzr))
+    {}
+
+    std::unique_ptr<mip::token_t> next(mip::_istream & is) override {
+        return _tknzr->next(is);
+    }
+
+    bool eos(mip::_istream & is) override {
+        return _tknzr->eos(is);
+    }
+
+private:
+    std::unique_ptr<mip::base_tknzr_t> _tknzr;
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+static void check_scan()
+{
+    // pending other text is flushed before a string
+    CHECK(scan(sample(), _T("ab\"cd\"ef\n")) == 
+        _T("other:ab|string:cd|other:ef|eol|eof"));
+
+    // a comment terminator is searched after its opener
+    CHECK(scan(sample(), _T("a /*/ b */ c")) == 
+        _T("other:a|blank: |comment:/*/ b */|blank: |other:c|eof"));
+
+    // the default statistics implementation agrees with the engine one
+    const mip::string_t text = _T("x = \"s\"; // c\n/* a\nb */ y\n");
+
+    mip::tknzr_stats_t st, fwd_st;
+    mip::_istringstream is(text), fwd_is(text);
+
+    CHECK(sample()->stats(is, st));
+
+    fwd_tknzr_t fwd(sample());
+    CHECK(fwd.stats(fwd_is, fwd_st));
+
+    CHECK(st.tokens == fwd_st.tokens);
+    CHECK(st.length == fwd_st.length);
+    CHECK(st.lines == fwd_st.lines && st.lines == 4);
+
+    // values measured without being built match the built ones
+    const mip::string_t values = 
+        _T("x = \"a\\n\\x41\\\"b\" + 12 * 0x1F / 1.5e3;\n")
+        _T("/* a multi-line\ncomment */ \"\" y\n");
+
+    for (size_t window : { 0, 4, 8 }) {
+        auto tknzr = windowed(window);
+        mip::tknzr_stats_t wst, wfwd_st;
+        mip::_istringstream wis(values), wfwd_is(values);
+
+        CHECK(tknzr->stats(wis, wst));
+
+        fwd_tknzr_t wfwd(windowed(window));
+        CHECK(wfwd.stats(wfwd_is, wfwd_st));
+
+        CHECK(wst.tokens == wfwd_st.tokens);
+        CHECK(wst.length == wfwd_st.length);
+        CHECK(wst.longest == wfwd_st.longest);
+        CHECK(wst.lines == wfwd_st.lines && wst.lines == 4);
+
+        // values are built again after the statistics
+        tknzr->reset();
+        CHECK(scan(std::move(tknzr), _T("\"a\\tb\" 12")) == 
+            _T("string:a\tb|blank: |number:12|eof"));
+    }
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+static void check_ids()
+{
+    mip::tknzr_bldr_t bldr;
+
+    CHECK(bldr.def_atom(_T("+"), 1));
+    CHECK(bldr.def_atom(_T("-")));        // 2: above the explicit id
+    CHECK(!bldr.def_atom(_T("*"), 1));    // id already used by "+"
+    CHECK(!bldr.def_atom(_T("*"), 2));    // id already used by "-"
+    CHECK(bldr.def_atom(_T("*"), 0));
+    CHECK(bldr.def_atom(_T("/")));        // 3
+    CHECK(!bldr.def_atom(_T("+")));       // value already defined
+    CHECK(bldr.def_blank(_T(" ")));       // 0: ids are per class
+    CHECK(bldr.def_sl_comment(_T("#"), 3)); 
+
+    auto tknzr = bldr.build();
+    std::vector<mip::token_t> tkns;
+
+    CHECK(tokens(*tknzr, _T("+-* /#"), tkns));
+    CHECK(tkns.size() == 7);
+
+    if (tkns.size() == 7) {
+        CHECK(tkns[0].id() == 1);
+        CHECK(tkns[1].id() == 2);
+        CHECK(tkns[2].id() == 0);
+        CHECK(tkns[3].id() == 0);
+        CHECK(tkns[4].id() == 3);
+        CHECK(tkns[5].id() == 3);
+    }
+
+    // large grammars are numbered the same way
+    mip::tknzr_bldr_t big_bldr;
+    bool ok = true;
+
+    for (size_t i = 0; i < 20000; ++i) {
+        ok = big_bldr.def_keyword(_T("k") + _to_string(i)) && ok;
+    }
+
+    CHECK(ok);
+    CHECK(!big_bldr.def_keyword(_T("x"), 19999));
+    CHECK(big_bldr.def_keyword(_T("x")));
+
+    auto big_tknzr = big_bldr.build_engine();
+    CHECK(big_tknzr->keyword_id(_T("k19999")) == 19999);
+    CHECK(big_tknzr->keyword_id(_T("x")) == 20000);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+static std::unique_ptr<mip::base_tknzr_t> indent_tknzr(bool blank_run)
+{
+    mip::tknzr_bldr_t bldr;
+
+    bldr.def_blank(_T(" "));
+    bldr.def_blank(_T("\t"));
+    bldr.def_atom(_T(":"));
+    bldr.def_sl_comment(_T("#"));
+    bldr.def_eol(mip::base_tknzr_t::eol_t::LF);
+    bldr.def_indent(4);
+    bldr.def_blank_run(blank_run);
+
+    return bldr.build();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+static void check_indent()
+{
+    // each dedent reports the level it closes
+    CHECK(scan(indent_tknzr(true), 
+        _T("a:\n  b:\n\n    c\n  # x\nd\n")) ==
+        _T("other:a|atom::|eol|indent:2|blank:  |other:b|atom::|eol|eol|")
+        _T("indent:4|blank:    |other:c|eol|blank:  |comment:# x|eol|")
+        _T("dedent:4|dedent:2|other:d|eol|eof"));
+
+    // tabs are expanded to the next tab stop; closing several levels; 
+    // the last levels close at the end
+    CHECK(scan(indent_tknzr(true), 
+        _T("a\n\tb\n\t\tc\nd\n  e\n   f")) ==
+        _T("other:a|eol|indent:4|blank:\t|other:b|eol|")
+        _T("indent:8|blank:\t\t|other:c|eol|")
+        _T("dedent:8|dedent:4|other:d|eol|")
+        _T("indent:2|blank:  |other:e|eol|")
+        _T("indent:3|blank:   |other:f|dedent:3|dedent:2|eof"));
+
+    // a dedent must reach an outer level
+    mip::tknzr_bldr_t bldr;
+    bldr.def_blank(_T(" "));
+    bldr.def_eol(mip::base_tknzr_t::eol_t::LF);
+    bldr.def_indent(4);
+    bldr.def_blank_run();
+
+    auto tknzr = bldr.build_engine();
+    std::vector<mip::token_t> tkns;
+
+    CHECK(!tokens(*tknzr, _T("a\n    b\n  c\n"), tkns));
+    CHECK(tknzr->error() == mip::tknzr_t::error_t::INDENT);
+    CHECK(tkns.size() == 6 && 
+        tkns.back().type() == mip::token_t::tcl_t::END_OF_LINE);
+
+    // blank runs are merged only if requested
+    CHECK(scan(indent_tknzr(false), _T("a \t b")) ==
+        _T("other:a|blank: |blank:\t|blank: |other:b|eof"));
+
+    CHECK(scan(indent_tknzr(true), _T("a \t b")) ==
+        _T("other:a|blank: \t |other:b|eof"));
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+static void check_offsets_only()
+{
+    const mip::string_t text = 
+        _T("a (b) \"s\"\n/* c\n  d */ e; // f\n\n  g\n");
+
+    mip::tknzr_bldr_t bldr, pos_bldr;
+    def_grammar(bldr);
+    def_grammar(pos_bldr);
+    CHECK(pos_bldr.def_offsets_only());
+
+    auto tknzr = bldr.build();
+    auto pos_tknzr = pos_bldr.build_engine();
+
+    std::vector<mip::token_t> tkns, pos_tkns;
+    CHECK(tokens(*tknzr, text, tkns));
+    CHECK(tokens(*pos_tknzr, text, pos_tkns));
+    CHECK(tkns.size() == pos_tkns.size());
+
+    // same positions, lines and columns are resolved from the index
+    const auto & lines = pos_tknzr->lines();
+
+    for (size_t i = 0; i < tkns.size() && i < pos_tkns.size(); ++i) {
+        CHECK(pos_tkns[i].type() == tkns[i].type());
+        CHECK(pos_tkns[i].pos() == tkns[i].pos());
+        CHECK(pos_tkns[i].end() == tkns[i].end());
+        CHECK(pos_tkns[i].line() == 0 && pos_tkns[i].offset() == 0);
+        CHECK(lines.line(pos_tkns[i].pos()) == tkns[i].line());
+        CHECK(lines.column(pos_tkns[i].pos()) == tkns[i].offset());
+    }
+
+    mip::tknzr_bldr_t st_bldr;
+    def_grammar(st_bldr);
+    st_bldr.def_offsets_only();
+
+    mip::tknzr_stats_t st, pos_st;
+    mip::_istringstream is(text), pos_is(text);
+
+    CHECK(sample()->stats(is, st));
+    CHECK(st_bldr.build()->stats(pos_is, pos_st));
+    CHECK(st.lines == pos_st.lines);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+static void check_utf16()
+{
+#ifndef _UNICODE
+    // U+00E9 (1 unit, 2 bytes), U+1D11E (2 units, 4 bytes)
+    const std::u16string text = u"\u00e9t\u00e9 \U0001D11E x";
+
+    std::basic_stringbuf<char16_t> src(text);
+    mip::utf8_streambuf_t<char16_t> sb(&src, true);
+    std::istream is(&sb);
+
+    mip::tknzr_bldr_t bldr;
+    bldr.def_blank(_T(" "));
+    bldr.def_utf8();
+
+    auto tknzr = bldr.build_engine();
+    std::vector<size_t> pos, units;
+
+    CHECK(tknzr->tokenize(is, [&](const mip::tkn_view_t & tkn) {
+        pos.push_back(tkn.pos);
+        units.push_back(sb.source_pos(tkn.pos));
+    }));
+
+    // token positions are UTF-8 byte offsets, mapped back to units
+    CHECK(pos == std::vector<size_t>({ 0, 5, 6, 10, 11, 12 }));
+    CHECK(units == std::vector<size_t>({ 0, 3, 4, 6, 7, 8 }));
+#endif
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+static void check_utf8()
+{
+#ifndef _UNICODE
+    // invalid UTF-8 input makes scanning fail
+    for (const char * text : { 
+        "a \xC3 b",         // truncated sequence
+        "a \xC0\xAF b",     // overlong encoding
+        "a \xED\xA0\x80 b", // surrogate
+        "a \xBF b",         // stray continuation byte
+        "a b\n\xF4\x90\x80\x80" }) // beyond U+10FFFF
+    {
+        mip::tknzr_bldr_t bldr;
+        bldr.def_blank(_T(" "));
+        bldr.def_utf8();
+
+        auto tknzr = bldr.build_engine();
+        std::vector<mip::token_t> tkns;
+
+        CHECK(!tokens(*tknzr, text, tkns));
+        CHECK(tknzr->error() == mip::tknzr_t::error_t::SCAN);
+    }
+
+    // columns are counted in code points: U+00E0 and U+20AC take 2 and 
+    // 3 bytes, U+1D11E takes 4
+    const std::string text = 
+        "\xC3\xA0\xC3\xA0 y \xE2\x82\xAC\xF0\x9D\x84\x9E+z\n"
+        "\xC3\xA0 /* c\n \xE2\x82\xAC */ w";
+
+    const std::vector<size_t> expected = { 
+        0, 2, 3, 4, 5, 7, 8, 9,  // line 1, ending with its eol
+        0, 1,                    // line 2, up to the comment
+        mip::token_t::npos,      // the comment begins on a dropped line
+        5, 6, 7 };               // line 3, ending with eof
+
+    for (size_t window : { 0, 4, 5, 16 }) {
+        mip::tknzr_bldr_t bldr;
+        bldr.def_blank(_T(" "));
+        bldr.def_blank_run();
+        bldr.def_atom(_T("+"), 1);
+        bldr.def_eol(mip::base_tknzr_t::eol_t::LF);
+        bldr.def_ml_comment(_T("/*"), _T("*/"));
+        bldr.def_utf8();
+
+        if (window) {
+            bldr.def_window(window);
+        }
+
+        auto tknzr = bldr.build_engine();
+        std::istringstream is(text);
+        std::vector<size_t> columns;
+        mip::tkn_view_t y;
+
+        CHECK(tknzr->tokenize(is, [&](const mip::tkn_view_t & tkn) {
+            if (columns.size() == 2) {
+                y = tkn;
+            }
+
+            columns.push_back(tknzr->column(tkn));
+        }));
+
+        CHECK(columns == expected);
+
+        // no line is buffered after the scan
+        CHECK(tknzr->column(y) == mip::token_t::npos);
+    }
+#endif
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+static void check_window()
+{
+    const mip::string_t text = 
+        _T("a_very_long_identifier_name (1234567890.125) -> ")
+        _T("\"a string literal longer than the window\"   \t   ")
+        _T("@@@@@@@@@@@@@@@@@@@@ >= x // a long single-line comment\n")
+        _T("/* a multi-line comment\n spanning two lines */ y;\n")
+        _T("\"\" z");
+
+    auto whole = windowed(0);
+    std::vector<mip::token_t> tkns;
+    CHECK(tokens(*whole, text, tkns));
+
+    // tokens longer than the window are kept whole
+    for (size_t window : { 4, 5, 7, 8, 16, 64 }) {
+        auto tknzr = windowed(window);
+        std::vector<mip::token_t> wtkns;
+
+        CHECK(tokens(*tknzr, text, wtkns));
+        CHECK(wtkns.size() == tkns.size());
+
+        for (size_t i = 0; i < tkns.size() && i < wtkns.size(); ++i) {
+            CHECK(wtkns[i].type() == tkns[i].type());
+            CHECK(wtkns[i].value() == tkns[i].value());
+            CHECK(wtkns[i].pos() == tkns[i].pos());
+            CHECK(wtkns[i].line() == tkns[i].line());
+            CHECK(wtkns[i].offset() == tkns[i].offset());
+        }
+    }
+
+    // escape sequences cut by the window edge are read whole
+    mip::string_t esc_text = _T("x = \"");
+
+    while (esc_text.size() < 300) {
+        esc_text += _T("a\\n\\x41\\101\\\"\\t\\\\b");
+    }
+
+    esc_text += _T("\" y");
+
+    tkns.clear();
+    whole->reset();
+    CHECK(tokens(*whole, esc_text, tkns));
+    CHECK(tkns.size() == 8);
+
+    for (size_t window = 1; window < 200; ++window) {
+        auto tknzr = windowed(window, 400);
+        std::vector<mip::token_t> wtkns;
+
+        CHECK(tokens(*tknzr, esc_text, wtkns));
+        CHECK(wtkns.size() == tkns.size());
+
+        for (size_t i = 0; i < tkns.size() && i < wtkns.size(); ++i) {
+            CHECK(wtkns[i].type() == tkns[i].type());
+            CHECK(wtkns[i].value() == tkns[i].value());
+            CHECK(wtkns[i].offset() == tkns[i].offset());
+        }
+    }
+
+    // a token longer than the limit makes scanning fail
+    auto tknzr = windowed(4, 16);
+    tkns.clear();
+
+    CHECK(tokens(*tknzr, _T("x aaaaaaaaaaaaaaaa y"), tkns));
+    tknzr->reset();
+
+    CHECK(!tokens(*tknzr, _T("x aaaaaaaaaaaaaaaaa y"), tkns));
+    CHECK(tknzr->error() == mip::tknzr_t::error_t::TOKEN_SIZE);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef _UNICODE
+//! Describe a token as "class:value"
+static void describe(std::string & res, const mip::tkn_view_t & tkn)
+{
+    res += tcl_name(tkn.type);
+    res += ':';
+    res.append(tkn.data, tkn.size);
+    res += '@' + std::to_string(tkn.line) + ',' + std::to_string(tkn.pos);
+    res += '|';
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+static std::string read_file(const std::string & path)
+{
+    std::ifstream is(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(is), 
+        std::istreambuf_iterator<char>());
+}
+#endif
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Build a tokenizer of the sample grammar delivering multi-line comments 
+//! in a given mode
+static std::unique_ptr<mip::base_tknzr_t> ml_tknzr(
+    mip::base_tknzr_t::comment_t mode)
+{
+    mip::tknzr_bldr_t bldr;
+    def_grammar(bldr);
+    bldr.def_ml_comment_mode(mode);
+
+    return bldr.build();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+static void check_ml_comments()
+{
+    using comment_t = mip::base_tknzr_t::comment_t;
+
+    const mip::string_t text = 
+        _T("a /* one // x\n two\n\n three */ b/**/c;\n");
+
+    CHECK(scan(ml_tknzr(comment_t::VALUE), text) == 
+        _T("other:a|blank: |comment:/* one // x\n two\n\n three */|blank: |")
+        _T("other:b|comment:/**/|other:c|atom:;|eol|eof"));
+
+    CHECK(scan(ml_tknzr(comment_t::EXTENT), text) == 
+        _T("other:a|blank: |comment:|blank: |")
+        _T("other:b|comment:|other:c|atom:;|eol|eof"));
+
+    CHECK(scan(ml_tknzr(comment_t::CHUNKS), text) == 
+        _T("other:a|blank: |comment:/* one // x|eol|comment: two|eol|eol|")
+        _T("comment: three */|blank: |other:b|comment:/**/|other:c|atom:;|")
+        _T("eol|eof"));
+
+    // extents and chunks span the text of whole comments
+    std::vector<mip::token_t> tkns, ext_tkns, chunks;
+    CHECK(tokens(*ml_tknzr(comment_t::VALUE), text, tkns));
+    CHECK(tokens(*ml_tknzr(comment_t::EXTENT), text, ext_tkns));
+    CHECK(tokens(*ml_tknzr(comment_t::CHUNKS), text, chunks));
+    CHECK(tkns.size() == ext_tkns.size() && chunks.size() == tkns.size() + 5);
+
+    for (size_t i = 0; i < tkns.size() && i < ext_tkns.size(); ++i) {
+        CHECK(ext_tkns[i].pos() == tkns[i].pos());
+        CHECK(ext_tkns[i].end() == tkns[i].end());
+        CHECK(ext_tkns[i].line() == tkns[i].line());
+    }
+
+    if (tkns.size() > 2 && chunks.size() > 7) {
+        CHECK(chunks[2].pos() == tkns[2].pos());
+        CHECK(chunks[7].end() == tkns[2].end());
+        CHECK(chunks[7].line() == 3 && chunks[7].offset() == 0);
+    }
+
+    // unterminated comments fail in any mode
+    for (auto mode : 
+        { comment_t::VALUE, comment_t::EXTENT, comment_t::CHUNKS }) 
+    {
+        const auto res = scan(ml_tknzr(mode), _T("a /* b\n c"));
+        CHECK(res.size() > 6 && res.substr(res.size() - 6) == _T("|error"));
+    }
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Escape converter which cannot be serialized
+struct raw_esc_cnvrtr_t : public mip::base_esc_cnvrtr_t {
+    bool convert(const mip::string_t&, size_t&, mip::char_t&) const override {
+        return false;
+    }
+
+    mip::char_t escape_char() const noexcept override {
+        return _T('\\');
+    }
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+static void check_grammar_blob()
+{
+    mip::tknzr_bldr_t bldr;
+    def_grammar(bldr);
+
+    bldr.def_keyword(std::set<mip::string_t>{ _T("if"), _T("else") });
+    bldr.def_pattern(_T("[A-Za-z_]\\w*"));
+    bldr.def_number(mip::base_tknzr_t::num_t::HEX);
+    bldr.def_number(mip::base_tknzr_t::num_t::FLOAT);
+    bldr.def_bracket(_T("{"), _T("}"));
+    bldr.def_blank_run();
+
+    auto tknzr = bldr.build_engine();
+
+    std::vector<char> blob;
+    CHECK(tknzr->save_grammar(blob));
+
+    auto loaded = mip::tknzr_bldr_t::load_engine(blob.data(), blob.size());
+    CHECK(loaded != nullptr);
+
+    if (!loaded) {
+        return;
+    }
+
+    CHECK(loaded->fingerprint() == tknzr->fingerprint());
+
+    // a loaded grammar is saved as it was
+    std::vector<char> reloaded_blob;
+    CHECK(loaded->save_grammar(reloaded_blob) && reloaded_blob == blob);
+
+    const mip::string_t text = 
+        _T("if (x1 >= 0x1F) { y -> \"s\\\"t\" ; } else z = 1.5e3\n")
+        _T("/* c\n */ a<<b # d\n  else_ {}");
+
+    std::vector<mip::token_t> tkns, ld_tkns;
+    CHECK(tokens(*tknzr, text, tkns));
+    CHECK(tokens(*loaded, text, ld_tkns));
+    CHECK(tkns.size() == ld_tkns.size());
+
+    for (size_t i = 0; i < tkns.size() && i < ld_tkns.size(); ++i) {
+        CHECK(ld_tkns[i].type() == tkns[i].type());
+        CHECK(ld_tkns[i].value() == tkns[i].value());
+        CHECK(ld_tkns[i].id() == tkns[i].id());
+        CHECK(ld_tkns[i].pos() == tkns[i].pos());
+        CHECK(ld_tkns[i].num().integer == tkns[i].num().integer);
+        CHECK(ld_tkns[i].num().real == tkns[i].num().real);
+    }
+
+    // truncated or altered blobs are refused
+    for (size_t size = 0; size < blob.size(); ++size) {
+        CHECK(!mip::tknzr_bldr_t::load_engine(blob.data(), size));
+    }
+
+    std::vector<char> bad_blob = blob;
+    bad_blob[0] ^= 1;
+    CHECK(!mip::tknzr_bldr_t::load_engine(bad_blob.data(), bad_blob.size()));
+
+    // custom escape converters cannot be serialized
+    mip::tknzr_bldr_t raw_bldr;
+    raw_bldr.def_string(_T('\''), std::make_shared<raw_esc_cnvrtr_t>());
+    CHECK(!raw_bldr.build_engine()->save_grammar(blob));
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+static void check_static()
+{
+    const mip::string_t texts[] = {
+        _T("if (x >= 0x1F) y->z; else w<<1.5e3 >\"s\\\"t\"\n")
+        _T("/* c\n */ iff(12)# d\r\n\t.5 // e\n;"),
+        _T("a \"unterminated\n string"),
+        _T("")
+    };
+
+    for (const auto & text : texts) {
+        mip::tknzr_bldr_t bldr;
+        CHECK(sample_static::grammar_t::define(bldr));
+
+        auto tknzr = bldr.build();
+        mip::static_tknzr_t<sample_static::grammar_t> st_tknzr;
+
+        std::vector<mip::token_t> tkns, st_tkns;
+        CHECK(tokens(*tknzr, text, tkns));
+        CHECK(tokens(st_tknzr, text, st_tkns));
+        CHECK(tkns.size() == st_tkns.size());
+
+        for (size_t i = 0; i < tkns.size() && i < st_tkns.size(); ++i) {
+            CHECK(st_tkns[i].type() == tkns[i].type());
+            CHECK(st_tkns[i].value() == tkns[i].value());
+            CHECK(st_tkns[i].id() == tkns[i].id());
+            CHECK(st_tkns[i].line() == tkns[i].line());
+            CHECK(st_tkns[i].offset() == tkns[i].offset());
+            CHECK(st_tkns[i].pos() == tkns[i].pos());
+            CHECK(st_tkns[i].num().integer == tkns[i].num().integer);
+            CHECK(st_tkns[i].num().real == tkns[i].num().real);
+        }
+    }
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+static void check_cache()
+{
+#ifndef _UNICODE
+    const std::string text = "x (12) -> 3.5; // note\n\"str\" y\n  z\n";
+    const std::string src = "check_cache.txt";
+    std::ofstream(src, std::ios::binary) << text;
+
+    auto tknzr = windowed(0);
+    std::string expected;
+    mip::_istringstream is(text);
+
+    CHECK(tknzr->tokenize(is, [&](const mip::tkn_view_t & tkn) {
+        describe(expected, tkn);
+    }));
+
+    auto replayed = [](const mip::tkn_stream_t & stream) {
+        std::string res;
+        stream.replay([&](const mip::tkn_view_t & tkn) { describe(res, tkn); });
+        return res;
+    };
+
+    mip::tkn_cache_t cache(".");
+    mip::tkn_stream_t stream;
+    cache.evict(*tknzr, src);
+
+    CHECK(cache.load(*tknzr, src, stream));
+    CHECK(cache.misses() == 1 && cache.hits() == 0);
+    CHECK(replayed(stream) == expected);
+
+    CHECK(cache.load(*tknzr, src, stream));
+    CHECK(cache.misses() == 1 && cache.hits() == 1);
+    CHECK(replayed(stream) == expected);
+
+    char name[32];
+    std::snprintf(name, sizeof(name), "./%016llx.mtks", 
+        static_cast<unsigned long long>(mip::hash64_t::hash(
+            text.data(), text.size(), tknzr->fingerprint())));
+
+    const std::string valid = read_file(name);
+
+    // an empty stream is just the header
+    const std::string empty_path = "check_empty.mtks";
+    CHECK(mip::tkn_stream_t().save(empty_path, 0));
+    const size_t hdr = read_file(empty_path).size();
+    std::remove(empty_path.c_str());
+
+    CHECK(hdr < valid.size());
+
+    // truncated, records running past the code, bad token class
+    std::string bad_class = valid;
+    bad_class[hdr] = '\x0F';
+
+    const std::vector<std::string> corrupted = {
+        valid.substr(0, valid.size() - 1),
+        valid.substr(0, hdr) + std::string(valid.size() - hdr, '\x90'),
+        bad_class
+    };
+
+    size_t misses = cache.misses();
+    size_t hits = cache.hits();
+
+    for (const auto & content : corrupted) {
+        stream.clear();
+        std::ofstream(name, std::ios::binary) << content;
+
+        // a corrupted stream is a miss, tokenized and stored again
+        CHECK(cache.load(*tknzr, src, stream));
+        CHECK(cache.misses() == ++misses && cache.hits() == hits);
+        CHECK(replayed(stream) == expected);
+
+        CHECK(cache.load(*tknzr, src, stream));
+        CHECK(cache.hits() == ++hits);
+        CHECK(read_file(name) == valid);
+    }
+
+    stream.clear();
+    CHECK(cache.evict(*tknzr, src));
+    std::remove(src.c_str());
+#endif
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+static void check_keywords()
+{
+    mip::tknzr_bldr_t bldr;
+    def_grammar(bldr);
+
+    // enough keywords for the perfect hash to need several seeds
+    std::set<mip::string_t> keywords;
+    mip::string_t text;
+
+    for (size_t i = 0; i < 300; ++i) {
+        keywords.insert(_T("kw") + _to_string(i));
+    }
+
+    CHECK(bldr.def_keyword(keywords));
+    CHECK(bldr.def_keyword(_T("while"), 1000));
+    CHECK(!bldr.def_keyword(_T("if"), 1000));
+
+    auto tknzr = bldr.build_engine();
+
+    for (const auto & kw : keywords) {
+        text += kw + _T(" ");
+    }
+
+    std::vector<mip::token_t> tkns;
+    CHECK(tokens(*tknzr, text + _T("while(kw7) kw300 kw kw07 whilex"), tkns));
+
+    std::set<size_t> ids;
+    std::vector<mip::string_t> others;
+
+    for (const auto & tkn : tkns) {
+        if (tkn.type() == mip::token_t::tcl_t::KEYWORD) {
+            CHECK(tknzr->keyword_id(tkn.value()) == tkn.id());
+            ids.insert(tkn.id());
+        }
+        else if (tkn.type() == mip::token_t::tcl_t::OTHER) {
+            others.push_back(tkn.value());
+        }
+    }
+
+    // every keyword has its own id, whole words only are keywords
+    CHECK(ids.size() == keywords.size() + 1);
+    CHECK(ids.count(1000) == 1);
+    CHECK((others == std::vector<mip::string_t>{ 
+        _T("kw300"), _T("kw"), _T("kw07"), _T("whilex") }));
+
+    CHECK(tknzr->keyword_id(_T("kw300")) == mip::token_t::npos);
+    CHECK(tknzr->keyword_id(_T("")) == mip::token_t::npos);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Match a text against a set of patterns, whose ids are their indices,
+//! returning "length:id" (or "0" if none matches, "error" if a pattern 
+//! is rejected)
+static mip::string_t dfa_match(
+    std::initializer_list<const mip::char_t *> patterns, 
+    const mip::string_t & text)
+{
+    mip::dfa_t dfa;
+    size_t id = 0;
+
+    for (const auto pattern : patterns) {
+        if (!dfa.add(pattern, id++)) {
+            return _T("error");
+        }
+    }
+
+    if (!dfa.build()) {
+        return _T("error");
+    }
+
+    id = mip::dfa_t::npos;
+    const size_t len = dfa.match(text, 0, id);
+
+    return len ? _to_string(len) + _T(":") + _to_string(id) : _T("0");
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+static void check_dfa()
+{
+    // character classes and ranges
+    CHECK(dfa_match({ _T("[a-c]+") }, _T("abcd")) == _T("3:0"));
+    CHECK(dfa_match({ _T("[0-9a-fA-F_]+") }, _T("0aF_9g")) == _T("5:0"));
+    CHECK(dfa_match({ _T("[]a]+") }, _T("a]a[")) == _T("3:0"));
+    CHECK(dfa_match({ _T("[+\\-]+") }, _T("+-+*")) == _T("3:0"));
+    CHECK(dfa_match({ _T("[^a-c]+") }, _T("xy-za")) == _T("4:0"));
+    CHECK(dfa_match({ _T("[^a-c]+") }, _T("abc")) == _T("0"));
+    CHECK(dfa_match({ _T("[^\\d]") }, _T("7")) == _T("0"));
+    CHECK(dfa_match({ _T("\\d+") }, _T("123a")) == _T("3:0"));
+    CHECK(dfa_match({ _T("\\D+") }, _T("ab1")) == _T("2:0"));
+    CHECK(dfa_match({ _T("\\w+") }, _T("a_Z9 x")) == _T("4:0"));
+    CHECK(dfa_match({ _T("\\W") }, _T("a")) == _T("0"));
+    CHECK(dfa_match({ _T("\\s+") }, _T(" \t\nx")) == _T("3:0"));
+    CHECK(dfa_match({ _T("\\S+") }, _T("ab c")) == _T("2:0"));
+    CHECK(dfa_match({ _T(".+") }, _T("a.\t")) == _T("3:0"));
+    CHECK(dfa_match({ _T("a\\.b") }, _T("axb")) == _T("0"));
+
+    // alternation, grouping and repetition
+    CHECK(dfa_match({ _T("ab|cd") }, _T("cde")) == _T("2:0"));
+    CHECK(dfa_match({ _T("(ab)+") }, _T("ababa")) == _T("4:0"));
+    CHECK(dfa_match({ _T("a(b|c)*d") }, _T("abcbd")) == _T("5:0"));
+    CHECK(dfa_match({ _T("a(b|c)*d") }, _T("ad")) == _T("2:0"));
+    CHECK(dfa_match({ _T("a(b|c)*d") }, _T("abx")) == _T("0"));
+    CHECK(dfa_match({ _T("ab?c") }, _T("ac")) == _T("2:0"));
+    CHECK(dfa_match({ _T("ab?c") }, _T("abbc")) == _T("0"));
+    CHECK(dfa_match({ _T("a*b") }, _T("aaab")) == _T("4:0"));
+    CHECK(dfa_match({ _T("x(a|b)?y*") }, _T("xbyy")) == _T("4:0"));
+
+    // the longest match wins, then the lowest id
+    CHECK(dfa_match({ _T("a+"), _T("a+b") }, _T("aaab")) == _T("4:1"));
+    CHECK(dfa_match({ _T("a+"), _T("a+b") }, _T("aaac")) == _T("3:0"));
+    CHECK(dfa_match({ _T("ab"), _T("abcd") }, _T("abce")) == _T("2:0"));
+    CHECK(dfa_match({ _T("[a-z]+"), _T("if") }, _T("if(")) == _T("2:0"));
+    CHECK(dfa_match({ _T("if"), _T("[a-z]+") }, _T("if(")) == _T("2:0"));
+    CHECK(dfa_match({ _T("if"), _T("[a-z]+") }, _T("ifx")) == _T("3:1"));
+
+    // patterns matching an empty string are rejected
+    for (const auto pattern : { 
+        _T("a*"), _T("a?"), _T("(b*)+"), _T("a|b*"), _T("a||b"), _T("()") }) 
+    {
+        CHECK(!mip::dfa_t::valid(pattern));
+    }
+
+    // malformed patterns are rejected
+    for (const auto pattern : { 
+        _T(""), _T("(ab"), _T("ab)"), _T("*a"), _T("a|*"), _T("[a-"), 
+        _T("[]"), _T("[z-a]"), _T("[^\\s\\S]"), _T("a\\") }) 
+    {
+        CHECK(!mip::dfa_t::valid(pattern));
+    }
+
+    CHECK(mip::dfa_t::valid(_T("(a*b)+")));
+
+    // a rejected pattern leaves the automaton unchanged
+    mip::dfa_t dfa;
+    size_t id = mip::dfa_t::npos;
+
+    CHECK(dfa.match(_T("ab"), 0, id) == 0);
+    CHECK(!dfa.add(_T("(a|b"), 0));
+    CHECK(dfa.add(_T("ab"), 1));
+    CHECK(dfa.build());
+    CHECK(dfa.match(_T("xab"), 1, id) == 2 && id == 1);
+    CHECK(dfa.match(_T("aab"), 0, id) == 0);
+
+    // on equal length, atoms win over patterns
+    mip::tknzr_bldr_t bldr;
+    bldr.def_blank(_T(" "));
+    CHECK(bldr.def_atom(_T("in")));
+    CHECK(bldr.def_atom(_T("<=")));
+    CHECK(bldr.def_pattern(_T("[a-z]+")));
+    CHECK(bldr.def_pattern(_T("<=+")));
+    CHECK(!bldr.def_pattern(_T("[a-z")));
+
+    CHECK(scan(bldr.build(), _T("in int i <= <==")) == 
+        _T("atom:in|blank: |pattern:int|blank: |pattern:i|blank: |")
+        _T("atom:<=|blank: |pattern:<==|eof"));
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Build a tokenizer indexing (), [] and {} brackets
+static std::unique_ptr<mip::tknzr_t> brkt_tknzr()
+{
+    mip::tknzr_bldr_t bldr;
+    bldr.def_blank(_T(" "));
+    bldr.def_eol(mip::base_tknzr_t::eol_t::LF);
+    bldr.def_bracket(_T("("), _T(")"));
+    bldr.def_bracket(_T("["), _T("]"));
+    bldr.def_bracket(_T("{"), _T("}"));
+
+    return bldr.build_engine();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+static void check_brackets()
+{
+    using err_t = mip::brkt_idx_t::err_t;
+    const auto npos = mip::brkt_idx_t::npos;
+
+    // nested pairs are matched both ways, the depth follows the nesting
+    auto tknzr = brkt_tknzr();
+    std::vector<size_t> depths;
+    mip::_istringstream is(_T("f(a[b{c}d]e)()"));
+
+    CHECK(tknzr->tokenize(is, [&](const mip::tkn_view_t &) {
+        depths.push_back(tknzr->brackets().depth());
+    }));
+
+    CHECK((depths == std::vector<size_t>{ 
+        0, 1, 1, 2, 2, 3, 3, 2, 2, 1, 1, 0, 1, 0, 0 }));
+
+    const auto & brackets = tknzr->brackets();
+
+    for (const auto & pair : { std::make_pair(1, 11), 
+        std::make_pair(3, 9), std::make_pair(5, 7), std::make_pair(12, 13) }) 
+    {
+        CHECK(brackets.match(pair.first) == size_t(pair.second));
+        CHECK(brackets.match(pair.second) == size_t(pair.first));
+    }
+
+    CHECK(brackets.match(0) == npos);
+    CHECK(brackets.match(6) == npos);
+    CHECK(brackets.match(100) == npos);
+    CHECK(brackets.mismatches().empty());
+
+    // "(" is closed by ")" enclosing the unclosed "{", "}" has no opener 
+    // and the last "(" is still open at the end of the input
+    tknzr = brkt_tknzr();
+    std::vector<mip::token_t> tkns;
+    CHECK(tokens(*tknzr, _T("( {\n) } ("), tkns));
+
+    const auto & mm = tknzr->brackets().mismatches();
+    CHECK(mm.size() == 4);
+
+    if (mm.size() == 4) {
+        CHECK(mm[0].error == err_t::MISMATCHED && mm[0].index == 4);
+        CHECK(mm[0].line == 1 && mm[0].offset == 0);
+        CHECK(mm[1].error == err_t::UNCLOSED && mm[1].index == 2);
+        CHECK(mm[1].line == 0 && mm[1].offset == 2);
+        CHECK(mm[2].error == err_t::UNOPENED && mm[2].index == 6);
+        CHECK(mm[2].line == 1 && mm[2].offset == 2);
+        CHECK(mm[3].error == err_t::UNCLOSED && mm[3].index == 8);
+        CHECK(mm[3].line == 1 && mm[3].offset == 4);
+    }
+
+    CHECK(tknzr->brackets().match(0) == 4);
+    CHECK(tknzr->brackets().match(4) == 0);
+    CHECK(tknzr->brackets().match(2) == npos);
+    CHECK(tknzr->brackets().match(6) == npos);
+    CHECK(tknzr->brackets().depth() == 0);
+
+    // the index is cleared by reset()
+    tknzr->reset();
+    CHECK(tknzr->brackets().mismatches().empty());
+    CHECK(tknzr->brackets().match(0) == npos);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+static void check_symtbl()
+{
+    // ids are dense and stable, values round trip
+    mip::symtbl_t symtbl;
+
+    CHECK(symtbl.intern(_T("a")) == 0);
+    CHECK(symtbl.intern(_T("b")) == 1);
+    CHECK(symtbl.intern(_T("a")) == 0);
+    CHECK(symtbl.intern(_T("")) == 2);
+    CHECK(symtbl.size() == 3);
+    CHECK(symtbl.find(_T("b")) == 1);
+    CHECK(symtbl.find(_T("c")) == mip::symtbl_t::npos);
+    CHECK(symtbl.value(3) == nullptr);
+
+    const mip::string_t * first = symtbl.value(0);
+    CHECK(first && *first == _T("a"));
+
+    for (size_t i = 0; i < 10000; ++i) {
+        const mip::string_t value = _T("s") + _to_string(i);
+        const size_t id = symtbl.intern(value);
+
+        CHECK(id == i + 3);
+        CHECK(symtbl.find(value) == id);
+        CHECK(symtbl.value(id) && *symtbl.value(id) == value);
+    }
+
+    // values are not moved by the table growing
+    CHECK(symtbl.value(0) == first);
+    CHECK(symtbl.intern(_T("s9999")) == 10002);
+
+    // tokenizers sharing a table agree on the ids of their values
+    auto shared = std::make_shared<mip::symtbl_t>();
+    auto tknzr = windowed(0), other = windowed(8);
+    tknzr->set_symtbl(shared, true);
+    other->set_symtbl(shared);
+
+    std::vector<mip::token_t> tkns, other_tkns;
+    CHECK(tokens(*tknzr, _T("x = \"s\" + y; z = y # x"), tkns));
+    CHECK(tokens(*other, _T("y x \"s\""), other_tkns));
+
+    for (const auto & tkn : tkns) {
+        if (tkn.sym() != mip::symtbl_t::npos) {
+            CHECK(shared->value(tkn.sym()) && 
+                *shared->value(tkn.sym()) == tkn.value());
+        }
+    }
+
+    CHECK(other_tkns.size() == 6);
+
+    if (other_tkns.size() == 6) {
+        CHECK(other_tkns[0].sym() == shared->find(_T("y")));
+        CHECK(other_tkns[2].sym() == shared->find(_T("x")));
+        CHECK(other_tkns[4].sym() == mip::symtbl_t::npos);
+    }
+
+    CHECK(shared->size() == 6); // x, =, s, +, y, z
+
+    // threads interning the same values in different orders agree on 
+    // their ids, which stay dense (the number of values is prime, so that 
+    // each stride visits all of them)
+    const size_t thread_cnt = 4;
+    const size_t value_cnt = 4999;
+
+    mip::symtbl_t mt_symtbl(4);
+    std::vector<std::vector<size_t>> ids(
+        thread_cnt, std::vector<size_t>(value_cnt));
+    std::vector<std::thread> threads;
+
+    for (size_t t = 0; t < thread_cnt; ++t) {
+        threads.emplace_back([&, t]() {
+            for (size_t i = 0; i < value_cnt; ++i) {
+                const size_t n = (i * (2 * t + 1) + t * 997) % value_cnt;
+                ids[t][n] = mt_symtbl.intern(_T("v") + _to_string(n));
+            }
+        });
+    }
+
+    for (auto & thread : threads) {
+        thread.join();
+    }
+
+    CHECK(mt_symtbl.size() == value_cnt);
+
+    std::vector<bool> seen(value_cnt, false);
+
+    for (size_t n = 0; n < value_cnt; ++n) {
+        const size_t id = ids[0][n];
+
+        for (size_t t = 1; t < thread_cnt; ++t) {
+            CHECK(ids[t][n] == id);
+        }
+
+        CHECK(id < value_cnt && !seen[id]);
+
+        if (id < value_cnt) {
+            seen[id] = true;
+            CHECK(*mt_symtbl.value(id) == _T("v") + _to_string(n));
+        }
+    }
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Describe a token view as "class:value"
+static mip::string_t tkn_desc(const mip::tkn_view_t & tkn)
+{
+    return mip::string_t(tcl_name(tkn.type)) + _T(":") + 
+        mip::string_t(tkn.data, tkn.size);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Tokenize a text delivering its tokens to a sink
+template <class Sink>
+static bool sink_scan(const mip::string_t & text, Sink && sink)
+{
+    auto tknzr = windowed(0);
+    mip::_istringstream is(text);
+
+    return tknzr->tokenize(is, std::forward<Sink>(sink));
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Visitor describing every token, each class by its own handler
+struct desc_visitor_t : mip::tkn_visitor_t<desc_visitor_t>
+{
+    std::vector<mip::string_t> & res;
+
+    explicit desc_visitor_t(std::vector<mip::string_t> & r) : res(r) {}
+
+    bool add(const mip::tkn_view_t & tkn) {
+        res.push_back(tkn_desc(tkn));
+        return true;
+    }
+
+    bool on_blank(const mip::tkn_view_t & tkn) { return add(tkn); }
+    bool on_eol(const mip::tkn_view_t & tkn) { return add(tkn); }
+    bool on_eof(const mip::tkn_view_t & tkn) { return add(tkn); }
+    bool on_comment(const mip::tkn_view_t & tkn) { return add(tkn); }
+    bool on_string(const mip::tkn_view_t & tkn) { return add(tkn); }
+    bool on_atom(const mip::tkn_view_t & tkn) { return add(tkn); }
+    bool on_other(const mip::tkn_view_t & tkn) { return add(tkn); }
+    bool on_keyword(const mip::tkn_view_t & tkn) { return add(tkn); }
+    bool on_pattern(const mip::tkn_view_t & tkn) { return add(tkn); }
+    bool on_number(const mip::tkn_view_t & tkn) { return add(tkn); }
+    bool on_indent(const mip::tkn_view_t & tkn) { return add(tkn); }
+    bool on_dedent(const mip::tkn_view_t & tkn) { return add(tkn); }
+};
+
+
+//! Visitor counting numbers up to the first ";" atom, other tokens being
+//! accepted by the default handlers
+struct num_visitor_t : mip::tkn_visitor_t<num_visitor_t>
+{
+    size_t numbers = 0;
+
+    bool on_number(const mip::tkn_view_t &) { 
+        ++numbers;
+        return true;
+    }
+
+    bool on_atom(const mip::tkn_view_t & tkn) { 
+        return !(tkn.size == 1 && tkn.data[0] == _T(';'));
+    }
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+static void check_sinks()
+{
+    using tcl_t = mip::token_t::tcl_t;
+
+    const mip::string_t text = 
+        _T("x1 = (2 >= y) -> \"s\\t\" ; 3.5 # c\n")
+        _T("/* a\n b */ z << 4;\n");
+
+    // tokens delivered to a plain sink
+    std::vector<mip::string_t> ref;
+
+    CHECK(sink_scan(text, [&](const mip::tkn_view_t & tkn) {
+        ref.push_back(tkn_desc(tkn));
+    }));
+
+    CHECK(ref.size() == 32);
+    CHECK(!ref.empty() && ref.back() == _T("eof:"));
+
+    // the visitor dispatches the same tokens
+    std::vector<mip::string_t> res;
+    desc_visitor_t visitor(res);
+
+    CHECK(sink_scan(text, visitor));
+    CHECK(res == ref);
+
+    // a handler returning false stops the scan
+    num_visitor_t nums;
+    CHECK(sink_scan(text, nums));
+    CHECK(nums.numbers == 1);
+
+    // class filters, an lvalue downstream sink being held by reference
+    auto collect = [&res](const mip::tkn_view_t & tkn) {
+        res.push_back(tkn_desc(tkn));
+    };
+
+    auto select = [&ref](const std::set<mip::string_t> & classes, bool keep) {
+        std::vector<mip::string_t> sel;
+
+        for (const auto & desc : ref) {
+            const auto cl = desc.substr(0, desc.find(_T(':')));
+
+            if ((classes.count(cl) != 0) == keep) {
+                sel.push_back(desc);
+            }
+        }
+
+        return sel;
+    };
+
+    res.clear();
+    CHECK(sink_scan(text, 
+        mip::filter_class({ tcl_t::ATOM, tcl_t::NUMBER }, collect)));
+    CHECK(res == select({ _T("atom"), _T("number") }, true));
+
+    res.clear();
+    CHECK(sink_scan(text, 
+        mip::drop_class({ tcl_t::BLANK, tcl_t::END_OF_LINE }, collect)));
+    CHECK(res == select({ _T("blank"), _T("eol") }, false));
+
+    // tokens up to an atom
+    const auto semicolon = std::find(ref.begin(), ref.end(), _T("atom:;"));
+
+    res.clear();
+    CHECK(sink_scan(text, mip::take_until_atom(_T(";"), collect)));
+    CHECK(res == std::vector<mip::string_t>(ref.begin(), semicolon));
+
+    res.clear();
+    CHECK(sink_scan(text, mip::take_until_atom(_T("<<<"), collect)));
+    CHECK(res == ref);
+
+    // mapped tokens, the downstream sink being held by value
+    res.clear();
+    CHECK(sink_scan(text, mip::map_value(tkn_desc, 
+        [&res](const mip::string_t & desc) { res.push_back(desc); })));
+    CHECK(res == ref);
+
+    // a pipeline of adaptors
+    std::vector<mip::string_t> expected;
+
+    for (auto it = ref.begin(); it != semicolon; ++it) {
+        if (it->compare(0, 6, _T("blank:")) != 0) {
+            expected.push_back(*it);
+        }
+    }
+
+    res.clear();
+    CHECK(sink_scan(text, 
+        mip::drop_class({ tcl_t::BLANK }, 
+            mip::take_until_atom(_T(";"), 
+                mip::map_value(tkn_desc, 
+                    [&res](const mip::string_t & desc) { 
+                        res.push_back(desc); 
+                    })))));
+    CHECK(res == expected);
+
+    // sliding windows of the last tokens, owning their values
+    size_t windows = 0;
+
+    CHECK(sink_scan(text, mip::window(3, 
+        [&](const mip::tkn_window_t & w) {
+            CHECK(w.size() == 3);
+
+            for (size_t i = 0; i < w.size() && windows + i < ref.size(); ++i) {
+                CHECK(tkn_desc(w[i]) == ref[windows + i]);
+            }
+
+            ++windows;
+        })));
+
+    CHECK(windows == ref.size() - 2);
+
+    // a range iterates the same tokens
+    auto tknzr = windowed(0);
+    mip::_istringstream is(text);
+    mip::tkn_range_t range(*tknzr, is);
+
+    res.clear();
+
+    for (const auto & tkn : range) {
+        res.push_back(tkn_desc(tkn));
+    }
+
+    CHECK(!range.error());
+    CHECK(res == ref);
+    CHECK(range.begin() == range.end());
+
+    // a range resumes where it stopped, and ends on errors
+    tknzr = windowed(0);
+    mip::_istringstream err_is(_T("a b /* c"));
+    mip::tkn_range_t err_range(*tknzr, err_is);
+
+    res.clear();
+
+    for (const auto & tkn : err_range) {
+        res.push_back(tkn_desc(tkn));
+        break;
+    }
+
+    for (const auto & tkn : err_range) {
+        res.push_back(tkn_desc(tkn));
+    }
+
+    CHECK(err_range.error());
+    CHECK((res == std::vector<mip::string_t>{ 
+        _T("pattern:a"), _T("blank: "), _T("pattern:b"), _T("blank: ") }));
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+static void check_numbers()
+{
+    mip::tknzr_bldr_t bldr;
+    def_grammar(bldr);
+
+    for (auto fmt : { mip::base_tknzr_t::num_t::DEC, 
+        mip::base_tknzr_t::num_t::HEX, mip::base_tknzr_t::num_t::OCT, 
+        mip::base_tknzr_t::num_t::BIN, mip::base_tknzr_t::num_t::FLOAT })
+    {
+        CHECK(bldr.def_number(fmt));
+    }
+
+    bldr.def_pattern(_T("[A-Za-z_]\\w*"));
+
+    std::vector<mip::token_t> tkns;
+    CHECK(tokens(*bldr.build(), 
+        _T("12 0x1F 017 0b101 1.5 .5 1e3 1.5e-3 x1 (7)\n")
+        _T("18446744073709551615 18446744073709551616 0x1FFFFFFFFFFFFFFFF ")
+        _T("1e999"), tkns));
+
+    std::vector<mip::token_t> nums;
+
+    for (const auto & tkn : tkns) {
+        if (tkn.type() == mip::token_t::tcl_t::NUMBER) {
+            nums.push_back(tkn);
+        }
+    }
+
+    CHECK(nums.size() == 13);
+
+    if (nums.size() != 13) {
+        return;
+    }
+
+    const uint64_t integers[] = { 12, 0x1F, 017, 5 };
+
+    for (size_t i = 0; i < 4; ++i) {
+        CHECK(!nums[i].num().floating && !nums[i].num().overflow);
+        CHECK(nums[i].num().integer == integers[i]);
+    }
+
+    const double reals[] = { 1.5, .5, 1e3, 1.5e-3 };
+
+    for (size_t i = 0; i < 4; ++i) {
+        CHECK(nums[4 + i].num().floating && !nums[4 + i].num().overflow);
+        CHECK(nums[4 + i].num().real == reals[i]);
+    }
+
+    // identifiers are not split, numbers between atoms are
+    CHECK(nums[8].value() == _T("7") && nums[8].num().integer == 7);
+
+    // out of range values saturate
+    const uint64_t max = static_cast<uint64_t>(-1);
+
+    CHECK(!nums[9].num().overflow && nums[9].num().integer == max);
+    CHECK(nums[10].num().overflow && nums[10].num().integer == max);
+    CHECK(nums[11].num().overflow && nums[11].num().integer == max);
+    CHECK(nums[12].num().floating && nums[12].num().overflow);
+    CHECK(nums[12].num().real > 1e308);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+static void check_profile()
+{
+    if (!mip::tknzr_t::profiling_enabled()) {
+        return;
+    }
+
+    // "in" is both an atom and an identifier: it is probed once per token
+    mip::tknzr_bldr_t bldr;
+    bldr.def_atom(_T("in"));
+    bldr.def_atom(_T("("));
+    bldr.def_blank(_T(" "));
+    bldr.def_number(mip::base_tknzr_t::num_t::DEC);
+    bldr.def_pattern(_T("[a-z]+"));
+
+    auto tknzr = bldr.build_engine();
+    mip::_istringstream is(_T("in x (in) 12 ( in"));
+
+    CHECK(tknzr->tokenize(is, [](const mip::tkn_view_t &) {}));
+
+    for (const auto & def : tknzr->profile().defs) {
+        if (def.value == _T("in")) {
+            CHECK(def.hits == 3);
+        }
+        else if (def.value == _T("(")) {
+            CHECK(def.hits == 2);
+        }
+    }
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+static void check_mem_limit()
+{
+    const mip::string_t text = _T("a (b) \"s\" // c\n d -> e;\n");
+    const mip::string_t long_line = mip::string_t(4096, _T('a')) + _T("\n");
+    const auto lists = mip::mem_usage_t::mem_t::LISTS;
+    std::vector<mip::token_t> tkns;
+
+    // a line exceeding the limit fails scanning
+    auto tknzr = windowed(0);
+    tknzr->set_mem_limit(1024);
+
+    CHECK(tokens(*tknzr, text, tkns));
+    tknzr->reset();
+
+    CHECK(!tokens(*tknzr, long_line, tkns));
+    CHECK(tknzr->error() == mip::tknzr_t::error_t::MEM_LIMIT);
+
+    // so does a charge refused by a pool, which gets it all back
+    auto pool = std::make_shared<mip::mem_pool_t>(1024);
+    tknzr = windowed(0);
+
+    CHECK(tknzr->set_mem_pool(pool));
+    CHECK(!tokens(*tknzr, long_line, tkns));
+    CHECK(tknzr->error() == mip::tknzr_t::error_t::MEM_LIMIT);
+    CHECK(pool->refused() > 0);
+
+    tknzr.reset();
+    CHECK(pool->used() == 0);
+
+    // token lists are charged while being built, then handed over
+    pool = std::make_shared<mip::mem_pool_t>();
+    mip::tknlist_t nonblnks, blnks;
+
+    {
+        mip::tknzr_bldr_t bldr;
+        def_grammar(bldr);
+
+        mip::tknlst_bldr_t lst_bldr(std::move(bldr));
+        lst_bldr.set_mem_pool(pool);
+
+        mip::_istringstream is(text);
+        CHECK(lst_bldr.build(is, nonblnks, blnks));
+        CHECK(!nonblnks.empty() && !blnks.empty());
+        CHECK(lst_bldr.mem_usage().of(lists) > 0);
+        CHECK(pool->usage().of(lists) == 0);
+        CHECK(pool->peak() > 0);
+    }
+
+    CHECK(pool->used() == 0);
+
+    // a build exceeding the limit fails, charging nothing
+    {
+        mip::tknzr_bldr_t bldr;
+        def_grammar(bldr);
+
+        mip::tknlst_bldr_t lst_bldr(std::move(bldr));
+        lst_bldr.set_mem_pool(pool);
+        lst_bldr.set_mem_limit(lst_bldr.mem_usage().total() + 256);
+
+        mip::_istringstream is(text + text + text + text);
+        nonblnks.clear();
+
+        CHECK(!lst_bldr.build(is, nonblnks));
+        CHECK(lst_bldr.error() == mip::tknzr_t::error_t::MEM_LIMIT);
+        CHECK(pool->usage().of(lists) == 0);
+    }
+
+    CHECK(pool->used() == 0);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+static int check()
+{
+    check_scan();
+    check_ids();
+    check_indent();
+    check_offsets_only();
+    check_utf16();
+    check_utf8();
+    check_window();
+    check_keywords();
+    check_dfa();
+    check_brackets();
+    check_symtbl();
+    check_sinks();
+    check_numbers();
+    check_ml_comments();
+    check_cache();
+    check_static();
+    check_grammar_blob();
+    check_profile();
+    check_mem_limit();
+
+    if (_failures) {
+        std::cerr << _failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+
+    std::cerr << "All checks passed" << std::endl;
+    return 0;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+int main(int argc, mip::char_t* argv[])
+{
+    if (argc > 1 && mip::string_t(argv[1]) == _T("--check")) {
+        return check();
+    }
+
+    mip::tknzr_bldr_t bldr;
+    def_grammar(bldr);
 
     auto tknzr = bldr.build();
 
@@ -0,0 +1,73 @@
+//  
+// This file is part of MipTknzr Library Project
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.  
+// Licensed under the MIT License. 
+// See COPYING file in the project root for full license information.
+//
+
+
+
+/* -------------------------------------------------------------------------- */
+
+// miptknzr_gen: generate the source of a scanner class specialized for a 
+// grammar saved by tknzr_t::save_grammar() (see lexgen_t)
+
+
+/* -------------------------------------------------------------------------- */
+
+#include "mip_lexgen.h"
+#include "mip_tknzr_bldr.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+
+/* -------------------------------------------------------------------------- */
+
+int main(int argc, char* argv[])
+{
+    if (argc != 4) {
+        std::cerr << "Usage: " << argv[0] 
+                  << " <grammar file> <output file> <class name>" << std::endl;
+        return 1;
+    }
+
+    const std::string grammar = argv[1];
+    const std::string output = argv[2];
+    const std::string class_name = argv[3];
+
+    auto tknzr = mip::tknzr_bldr_t::load_engine(grammar);
+
+    if (!tknzr) {
+        std::cerr << grammar << ": invalid grammar file" << std::endl;
+        return 1;
+    }
+
+    const auto feature = mip::lexgen_t::unsupported(*tknzr);
+
+    if (!feature.empty()) {
+        std::cerr << grammar << ": " << feature 
+                  << " not supported by generated scanners" << std::endl;
+        return 1;
+    }
+
+    std::ostringstream os;
+
+    if (!mip::lexgen_t::generate(*tknzr, class_name, os)) {
+        std::cerr << class_name << ": invalid class name" << std::endl;
+        return 1;
+    }
+
+    std::ofstream out(output, std::ios::binary | std::ios::trunc);
+
+    if (!out || !out.write(os.str().data(), os.str().size())) {
+        std::cerr << output << ": cannot write the scanner" << std::endl;
+        std::remove(output.c_str());
+        return 1;
+    }
+
+    return 0;
+}
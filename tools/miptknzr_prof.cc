@@ -0,0 +1,191 @@
+//  
+// This file is part of MipTknzr Library Project
+// Copyright (c) Antonino Calderone (antonino.calderone@gmail.com)
+// All rights reserved.  
+// Licensed under the MIT License. 
+// See COPYING file in the project root for full license information.
+//
+
+
+
+/* -------------------------------------------------------------------------- */
+
+// miptknzr_prof: scan a text file with a grammar saved by 
+// tknzr_t::save_grammar() and print the cost profile of each definition 
+// (see tknzr_profile_t), hottest first. The library must be built with 
+// MIP_TKNZR_PROFILE defined (CMake option MIPTKNZR_PROFILE)
+
+
+/* -------------------------------------------------------------------------- */
+
+#include "mip_tknzr_bldr.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+
+/* -------------------------------------------------------------------------- */
+
+namespace {
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Return a printable copy of a text (any character which is not 
+//! printable ASCII is escaped)
+std::string printable(const mip::string_t & text)
+{
+    std::string res;
+
+    for (const auto ch : text) {
+        const auto code = static_cast<unsigned long>(
+            static_cast<std::make_unsigned<mip::char_t>::type>(ch));
+
+        if (code >= 0x20 && code < 0x7f && ch != '\\') {
+            res += static_cast<char>(code);
+        }
+        else {
+            char esc[16];
+            std::snprintf(esc, sizeof(esc), 
+                code == '\\' ? "\\\\" : 
+                code < 0x100 ? "\\x%02lx" : "\\u%04lx", code);
+            res += esc;
+        }
+    }
+
+    return res;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+//! Return the name of the class of a definition
+const char * class_name(mip::token_t::tcl_t type)
+{
+    switch (type) {
+    case mip::token_t::tcl_t::BLANK:
+        return "blank";
+    case mip::token_t::tcl_t::ATOM:
+        return "atom";
+    case mip::token_t::tcl_t::COMMENT:
+        return "comment";
+    case mip::token_t::tcl_t::STRING:
+        return "string";
+    default:
+        break;
+    }
+
+    return "other";
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+void print_profile(const mip::tknzr_profile_t & prof, size_t top)
+{
+    const auto & defs = prof.defs;
+    std::vector<size_t> order(defs.size());
+
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&defs](size_t a, size_t b) {
+        return defs[a].ns() != defs[b].ns() ? 
+            defs[a].ns() > defs[b].ns() : defs[a].probes > defs[b].probes;
+    });
+
+    std::printf("lookups: %llu, failed: %llu, time: %.3f ms\n\n", 
+        static_cast<unsigned long long>(prof.lookups),
+        static_cast<unsigned long long>(prof.failed_lookups),
+        prof.ns() / 1e6);
+
+    std::printf("%-8s %-20s %12s %12s %7s %12s %12s %12s %12s %9s\n", 
+        "class", "definition", "probes", "hits", "hit%", "collisions", 
+        "misses", "hit_ns", "miss_ns", "ns/probe");
+
+    for (size_t i = 0; i < order.size() && i < top; ++i) {
+        const auto & def = defs[order[i]];
+
+        if (def.probes == 0) {
+            break;
+        }
+
+        std::string value = printable(def.value);
+
+        if (!def.tail.empty()) {
+            value += " ... " + printable(def.tail);
+        }
+
+        std::printf(
+            "%-8s %-20s %12llu %12llu %6.1f%% %12llu %12llu %12llu %12llu %9.1f\n",
+            class_name(def.type),
+            value.c_str(),
+            static_cast<unsigned long long>(def.probes),
+            static_cast<unsigned long long>(def.hits),
+            def.hit_rate() * 100.0,
+            static_cast<unsigned long long>(def.collisions),
+            static_cast<unsigned long long>(def.misses()),
+            static_cast<unsigned long long>(def.hit_ns),
+            static_cast<unsigned long long>(def.miss_ns),
+            double(def.ns()) / double(def.probes));
+    }
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+} // namespace
+
+
+/* -------------------------------------------------------------------------- */
+
+int main(int argc, char* argv[])
+{
+    if (argc != 3 && argc != 4) {
+        std::cerr << "Usage: " << argv[0] 
+                  << " <grammar file> <input file> [max definitions]" 
+                  << std::endl;
+        return 1;
+    }
+
+    if (!mip::tknzr_t::profiling_enabled()) {
+        std::cerr << "The library has not been built with MIP_TKNZR_PROFILE "
+                  << "defined (CMake option MIPTKNZR_PROFILE)" << std::endl;
+        return 1;
+    }
+
+    const std::string grammar = argv[1];
+    const std::string input = argv[2];
+    const size_t top = argc == 4 ? 
+        std::strtoul(argv[3], nullptr, 10) : size_t(-1);
+
+    auto tknzr = mip::tknzr_bldr_t::load_engine(grammar);
+
+    if (!tknzr) {
+        std::cerr << grammar << ": invalid grammar file" << std::endl;
+        return 1;
+    }
+
+    mip::_ifstream is(input, std::ios::in | std::ios::binary);
+
+    if (!is.is_open()) {
+        std::cerr << input << ": cannot open the file" << std::endl;
+        return 1;
+    }
+
+    if (!tknzr->tokenize(is, [](const mip::tkn_view_t &) {})) {
+        std::cerr << input << ": scanning failed" << std::endl;
+        return 1;
+    }
+
+    print_profile(tknzr->profile(), top);
+
+    return 0;
+}